@@ -19,6 +19,7 @@
 #include "Console.hxx"
 #include "Cheat.hxx"
 #include "Settings.hxx"
+#include "StateManager.hxx"
 #include "CheetahCheat.hxx"
 #include "BankRomCheat.hxx"
 #include "RamCheat.hxx"
@@ -122,7 +123,11 @@ void CheatManager::addOneShot(const string& name, const string& code)
   // Evaluate this cheat once, and then immediately discard it
   shared_ptr<Cheat> cheat = createCheat(name, code);
   if(cheat)
+  {
+    // A movie can't reproduce the cheat, so it ends here
+    myOSystem.state().stopMovie("cheat used");
     cheat->evaluate();
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
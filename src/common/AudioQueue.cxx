@@ -17,8 +17,9 @@
 
 #include "AudioQueue.hxx"
 
-using std::mutex;
-using std::lock_guard;
+using std::memory_order_relaxed;
+using std::memory_order_acquire;
+using std::memory_order_release;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 AudioQueue::AudioQueue(uInt32 fragmentSize, uInt32 capacity, bool isStereo)
@@ -50,9 +51,11 @@ uInt32 AudioQueue::capacity() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 AudioQueue::size() const
 {
-  lock_guard<mutex> guard(myMutex);
+  // Load the consumer counter first: it never overtakes the producer counter,
+  // so the result is in [0, capacity] even if both sides are running.
+  const uInt32 dequeueCount = myDequeueCount.load(memory_order_acquire);
 
-  return mySize;
+  return myEnqueueCount.load(memory_order_acquire) - dequeueCount;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -70,8 +73,6 @@ uInt32 AudioQueue::fragmentSize() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Int16* AudioQueue::enqueue(Int16* fragment)
 {
-  lock_guard<mutex> guard(myMutex);
-
   Int16* newFragment;
 
   if (!fragment) {
@@ -83,27 +84,34 @@ Int16* AudioQueue::enqueue(Int16* fragment)
     return newFragment;
   }
 
-  const uInt8 capacity = uInt8(myFragmentQueue.size());
-  const uInt8 fragmentIndex = (myNextFragment + mySize) % capacity;
+  const uInt32 capacity = uInt32(myFragmentQueue.size());
+  const uInt32 enqueueCount = myEnqueueCount.load(memory_order_relaxed);
 
-  newFragment = myFragmentQueue.at(fragmentIndex);
-  myFragmentQueue.at(fragmentIndex) = fragment;
+  // The slot we would write to still holds the oldest queued fragment, which
+  // belongs to the consumer. Drop the new fragment and refill it.
+  if (enqueueCount - myDequeueCount.load(memory_order_acquire) >= capacity) {
+    myOverflowCount.store(myOverflowCount.load(memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+    if (!myIgnoreOverflows.load(memory_order_relaxed)) myOverflowLogger.log();
 
-  if (mySize < capacity) ++mySize;
-  else {
-    myNextFragment = (myNextFragment + 1) % capacity;
-    if (!myIgnoreOverflows) myOverflowLogger.log();
+    return fragment;
   }
 
+  newFragment = myFragmentQueue[myEnqueueIndex];
+  myFragmentQueue[myEnqueueIndex] = fragment;
+
+  if (++myEnqueueIndex == capacity) myEnqueueIndex = 0;
+  myEnqueueCount.store(enqueueCount + 1, memory_order_release);
+
   return newFragment;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Int16* AudioQueue::dequeue(Int16* fragment)
 {
-  lock_guard<mutex> guard(myMutex);
+  const uInt32 dequeueCount = myDequeueCount.load(memory_order_relaxed);
 
-  if (mySize == 0) return nullptr;
+  if (myEnqueueCount.load(memory_order_acquire) == dequeueCount) return nullptr;
 
   if (!fragment) {
     if (!myFirstFragmentForDequeue) throw runtime_error("dequeue called empty");
@@ -112,11 +120,11 @@ Int16* AudioQueue::dequeue(Int16* fragment)
     myFirstFragmentForDequeue = nullptr;
   }
 
-  Int16* nextFragment = myFragmentQueue.at(myNextFragment);
-  myFragmentQueue.at(myNextFragment) = fragment;
+  Int16* nextFragment = myFragmentQueue[myDequeueIndex];
+  myFragmentQueue[myDequeueIndex] = fragment;
 
-  --mySize;
-  myNextFragment = (myNextFragment + 1) % myFragmentQueue.size();
+  if (++myDequeueIndex == myFragmentQueue.size()) myDequeueIndex = 0;
+  myDequeueCount.store(dequeueCount + 1, memory_order_release);
 
   return nextFragment;
 }
@@ -124,8 +132,6 @@ Int16* AudioQueue::dequeue(Int16* fragment)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AudioQueue::closeSink(Int16* fragment)
 {
-  lock_guard<mutex> guard(myMutex);
-
   if (myFirstFragmentForDequeue && fragment)
     throw runtime_error("attempt to return unknown buffer on closeSink");
 
@@ -136,5 +142,11 @@ void AudioQueue::closeSink(Int16* fragment)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AudioQueue::ignoreOverflows(bool shouldIgnoreOverflows)
 {
-  myIgnoreOverflows = shouldIgnoreOverflows;
+  myIgnoreOverflows.store(shouldIgnoreOverflows, memory_order_relaxed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 AudioQueue::overflowCount() const
+{
+  return myOverflowCount.load(memory_order_relaxed);
 }
@@ -18,7 +18,7 @@
 #ifndef AUDIO_QUEUE_HXX
 #define AUDIO_QUEUE_HXX
 
-#include <mutex>
+#include <atomic>
 
 #include "bspf.hxx"
 #include "StaggeredLogger.hxx"
@@ -31,8 +31,17 @@
   queue and returns the used fragment in this process.
 
   The queue needs to be threadsafe as the (SDL) audio driver runs on a
-  separate thread. Samples are stored as signed 16 bit integers
-  (platform endian).
+  separate thread. There is exactly one producer (the TIA, calling enqueue)
+  and one consumer (the sound driver, calling dequeue and closeSink), so the
+  queue is implemented as a wait-free single producer / single consumer ring:
+  each side owns its own slot index and the two sides only communicate
+  through the atomic fragment counters. Neither side ever blocks, so the
+  audio callback cannot be held up by a preempted emulation thread.
+
+  If the queue is full, enqueue drops the fragment that is passed in (the
+  producer cannot reclaim a slot that the consumer may be reading), and the
+  producer keeps filling the same fragment. Samples are stored as signed 16
+  bit integers (platform endian).
 */
 class AudioQueue
 {
@@ -96,6 +105,11 @@ class AudioQueue
      */
     void ignoreOverflows(bool shouldIgnoreOverflows);
 
+    /**
+      The total number of fragments dropped because the queue was full.
+     */
+    uInt32 overflowCount() const;
+
   private:
 
     // The size of an individual fragment (in stereo / mono samples)
@@ -104,7 +118,9 @@ class AudioQueue
     // Are we using stereo samples?
     bool myIsStereo{false};
 
-    // The fragment queue
+    // The fragment queue. Every slot holds a fragment: the slots between the
+    // dequeue and the enqueue position hold queued fragments and belong to the
+    // consumer, all others hold free fragments and belong to the producer.
     vector<Int16*> myFragmentQueue;
 
     // All fragments, including the two fragments that are in circulation.
@@ -113,14 +129,15 @@ class AudioQueue
     // We allocate a consecutive slice of memory for the fragments.
     unique_ptr<Int16[]> myFragmentBuffer;
 
-    // The nubmer if queued fragments
-    uInt32 mySize{0};
+    // Total number of fragments enqueued / dequeued so far. The counters wrap
+    // around, their difference is the number of queued fragments. Each one is
+    // written by one side only and lives on its own cache line, next to the
+    // slot index owned by the same side.
+    alignas(64) std::atomic<uInt32> myEnqueueCount{0};
+    uInt32 myEnqueueIndex{0};
 
-    // The next fragment.
-    uInt32 myNextFragment{0};
-
-    // We need a mutex for thread safety.
-    mutable std::mutex myMutex;
+    alignas(64) std::atomic<uInt32> myDequeueCount{0};
+    uInt32 myDequeueIndex{0};
 
     // The first (empty) enqueue call returns this fragment.
     Int16* myFirstFragmentForEnqueue{nullptr};
@@ -128,7 +145,10 @@ class AudioQueue
     Int16* myFirstFragmentForDequeue{nullptr};
 
     // Log overflows?
-    bool myIgnoreOverflows{true};
+    std::atomic<bool> myIgnoreOverflows{true};
+
+    // Number of overflows, written by the producer only
+    std::atomic<uInt32> myOverflowCount{0};
 
     StaggeredLogger myOverflowLogger{"audio buffer overflow", Logger::Level::INFO};
 
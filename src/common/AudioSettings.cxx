@@ -132,6 +132,12 @@ uInt32 AudioSettings::headroom()
   return customSettings() ? lboundInt(mySettings.getInt(SETTING_HEADROOM), 0) : myPresetHeadroom;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool AudioSettings::adaptive() const
+{
+  return mySettings.getBool(SETTING_ADAPTIVE);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 AudioSettings::ResamplingQuality AudioSettings::resamplingQuality()
 {
@@ -256,6 +262,14 @@ void AudioSettings::setHeadroom(uInt32 headroom)
   normalize(mySettings);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioSettings::setAdaptive(bool isAdaptive)
+{
+  if (!myIsPersistent) return;
+
+  mySettings.setValue(SETTING_ADAPTIVE, isAdaptive);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AudioSettings::setResamplingQuality(AudioSettings::ResamplingQuality resamplingQuality)
 {
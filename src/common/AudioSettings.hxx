@@ -45,6 +45,7 @@ class AudioSettings
     static constexpr const char* SETTING_FRAGMENT_SIZE       = "audio.fragment_size";
     static constexpr const char* SETTING_BUFFER_SIZE         = "audio.buffer_size";
     static constexpr const char* SETTING_HEADROOM            = "audio.headroom";
+    static constexpr const char* SETTING_ADAPTIVE            = "audio.adaptive";
     static constexpr const char* SETTING_RESAMPLING_QUALITY  = "audio.resampling_quality";
     static constexpr const char* SETTING_STEREO              = "audio.stereo";
     static constexpr const char* SETTING_VOLUME              = "audio.volume";
@@ -57,6 +58,7 @@ class AudioSettings
     static constexpr uInt32 DEFAULT_FRAGMENT_SIZE                   = 512;
     static constexpr uInt32 DEFAULT_BUFFER_SIZE                     = 3;
     static constexpr uInt32 DEFAULT_HEADROOM                        = 2;
+    static constexpr bool DEFAULT_ADAPTIVE                          = false;
     static constexpr ResamplingQuality DEFAULT_RESAMPLING_QUALITY   = ResamplingQuality::lanczos_2;
     static constexpr bool DEFAULT_STEREO                            = false;
     static constexpr uInt32 DEFAULT_VOLUME                          = 80;
@@ -83,6 +85,8 @@ class AudioSettings
 
     uInt32 headroom();
 
+    bool adaptive() const;
+
     ResamplingQuality resamplingQuality();
 
     bool stereo() const;
@@ -105,6 +109,8 @@ class AudioSettings
 
     void setHeadroom(uInt32 headroom);
 
+    void setAdaptive(bool isAdaptive);
+
     void setResamplingQuality(ResamplingQuality resamplingQuality);
 
     void setStereo(bool allROMs);
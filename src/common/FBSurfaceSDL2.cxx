@@ -80,6 +80,7 @@ void FBSurfaceSDL2::fillRect(uInt32 x, uInt32 y, uInt32 w, uInt32 h, ColorId col
   tmp.w = w;
   tmp.h = h;
   SDL_FillRect(mySurface, &tmp, myPalette[color]);
+  setDirtyRows(y, h);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -174,19 +175,30 @@ bool FBSurfaceSDL2::render()
 
   if(myIsVisible && myBlitter)
   {
-    myBlitter->blit(*mySurface);
+    myBlitter->blit(*mySurface, myDirtyRows);
+    setDirty(false);
 
     return true;
   }
   return false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FBSurfaceSDL2::setDirtyRows(uInt32 y, uInt32 h)
+{
+  const uInt32 end = std::min<uInt32>(y + h, uInt32(myDirtyRows.size()));
+
+  for(; y < end; ++y)
+    myDirtyRows[y] = true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FBSurfaceSDL2::invalidate()
 {
   ASSERT_MAIN_THREAD;
 
   SDL_FillRect(mySurface, nullptr, 0);
+  setDirty(true);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -203,6 +215,7 @@ void FBSurfaceSDL2::invalidateRect(uInt32 x, uInt32 y, uInt32 w, uInt32 h)
   // Note: Transparency has to be 0 to clear the rectangle foreground
   //  without affecting the background display.
   SDL_FillRect(mySurface, &tmp, 0);
+  setDirtyRows(y, h);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -252,6 +265,8 @@ void FBSurfaceSDL2::createSurface(uInt32 width, uInt32 height,
   myPitch = mySurface->pitch / pf.BytesPerPixel;
   ////////////////////////////////////////////////////
 
+  myDirtyRows.assign(height, true);
+
   myIsStatic = data != nullptr;
   if(myIsStatic)
     SDL_memcpy(mySurface->pixels, data, mySurface->w * mySurface->h * 4);
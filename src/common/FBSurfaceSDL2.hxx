@@ -57,6 +57,10 @@ class FBSurfaceSDL2 : public FBSurface
 
     void translateCoords(Int32& x, Int32& y) const override;
     bool render() override;
+    void setDirty(bool dirty) override {
+      myDirtyRows.assign(myDirtyRows.size(), dirty);
+    }
+    void setDirtyRows(uInt32 y, uInt32 h) override;
     void invalidate() override;
     void invalidateRect(uInt32 x, uInt32 y, uInt32 w, uInt32 h) override;
 
@@ -130,6 +134,9 @@ class FBSurfaceSDL2 : public FBSurface
     bool myIsVisible{true};
     bool myIsStatic{false};
 
+    // The rows changed since the last render
+    Blitter::DirtyRows myDirtyRows;
+
     Common::Rect mySrcGUIR, myDstGUIR;
 };
 
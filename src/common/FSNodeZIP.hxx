@@ -52,6 +52,11 @@ class FilesystemNodeZIP : public AbstractFSNode
     bool isFile() const      override { return _isFile;      }
     bool isReadable() const  override { return _realNode && _realNode->isReadable(); }
     bool isWritable() const  override { return false; }
+    // The archive identifies the version of all files contained in it
+    bool getFileInfo(uInt64& size, uInt64& modTime) const override {
+      return _isFile && _realNode && _realNode->getFileInfo(size, modTime);
+    }
+    bool isArchive() const override { return true; }
 
     //////////////////////////////////////////////////////////
     // For now, ZIP files cannot be modified in any way
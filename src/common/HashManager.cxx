@@ -0,0 +1,220 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+
+#include "MD5.hxx"
+#include "repository/KeyValueRepositoryNoop.hxx"
+#include "HashManager.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+HashManager::HashManager()
+  : myRepository{make_shared<KeyValueRepositoryNoop>()}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void HashManager::setRepository(shared_ptr<KeyValueRepositoryAtomic> repo)
+{
+  myRepository = std::move(repo);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string HashManager::hash(const FilesystemNode& node)
+{
+  uInt64 size = 0, modTime = 0;
+  const bool cacheable = node.getFileInfo(size, modTime);
+  string md5;
+
+  if(lookup(node.getPath(), cacheable, size, modTime, md5))
+    return md5;
+
+  md5 = hashFile(node);
+  if(cacheable && md5 != EmptyString)
+    myRepository->save(node.getPath(), cacheEntry(size, modTime, md5));
+
+  return md5;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HashManager::hash(const FSList& files, const ResultHandler& handler)
+{
+  struct Job {
+    size_t index{0};
+    string path;
+    bool cacheable{false};
+    uInt64 size{0}, modTime{0};
+  };
+  vector<Job> jobs;
+
+  // Report all files which are still valid in the cache
+  for(size_t idx = 0; idx < files.size(); ++idx)
+  {
+    Job job;
+    job.index = idx;
+    job.path = files[idx].getPath();
+    job.cacheable = files[idx].getFileInfo(job.size, job.modTime);
+
+    string md5;
+    if(lookup(job.path, job.cacheable, job.size, job.modTime, md5))
+    {
+      if(!handler(idx, md5))
+        return false;
+    }
+    else
+      jobs.push_back(std::move(job));
+  }
+  if(jobs.empty())
+    return true;
+
+  // Hash the others in parallel; the workers pick the next file from the
+  // list until it is exhausted, and queue up the results for this thread
+  std::mutex mutex;
+  std::condition_variable resultsAvailable;
+  vector<std::pair<size_t, string>> results, batch;
+  std::atomic<size_t> nextJob{0};
+  std::atomic_bool cancelled{false};
+
+  const auto worker = [&]() {
+    size_t job;
+    while(!cancelled && (job = nextJob++) < jobs.size())
+    {
+      string md5 = hashFile(files[jobs[job].index]);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        results.emplace_back(job, std::move(md5));
+      }
+      resultsAvailable.notify_one();
+    }
+  };
+  const size_t numWorkers = std::min<size_t>(jobs.size(),
+      BSPF::clamp(std::thread::hardware_concurrency(), MIN_WORKERS, MAX_WORKERS));
+  vector<std::thread> workers;
+  workers.reserve(numWorkers);
+  for(size_t i = 0; i < numWorkers; ++i)
+    workers.emplace_back(worker);
+
+  std::map<string, Variant> cacheEntries;
+  size_t done = 0;
+  while(done < jobs.size() && !cancelled)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      resultsAvailable.wait(lock, [&]{ return !results.empty(); });
+      batch.swap(results);
+    }
+    for(const auto& [job, md5]: batch)
+    {
+      // Note: the handler may e.g. rename the file, so don't touch it anymore
+      if(jobs[job].cacheable && md5 != EmptyString)
+        cacheEntries[jobs[job].path] = cacheEntry(jobs[job].size, jobs[job].modTime, md5);
+
+      ++done;
+      if(!cancelled && !handler(jobs[job].index, md5))
+        cancelled = true;
+    }
+    batch.clear();
+  }
+
+  for(auto& thread: workers)
+    thread.join();
+
+  // Whatever has been hashed until now is stored in one transaction
+  if(!cacheEntries.empty())
+    myRepository->save(cacheEntries);
+
+  return !cancelled;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HashManager::lookup(const FilesystemNode& node, string& md5)
+{
+  uInt64 size = 0, modTime = 0;
+  const bool cacheable = node.getFileInfo(size, modTime);
+
+  return lookup(node.getPath(), cacheable, size, modTime, md5);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void HashManager::store(const FilesystemNode& node, const string& md5)
+{
+  uInt64 size = 0, modTime = 0;
+
+  if(md5 != EmptyString && node.getFileInfo(size, modTime))
+    myRepository->save(node.getPath(), cacheEntry(size, modTime, md5));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void HashManager::prune()
+{
+  for(const auto& [path, value]: myRepository->load())
+  {
+    const FilesystemNode node(path);
+    uInt64 size = 0, modTime = 0;
+    string md5;
+
+    const bool exists = node.getFileInfo(size, modTime);
+
+    // Files on storage which isn't available at the moment are kept
+    if(exists || node.getParent().isDirectory())
+      lookup(path, exists, size, modTime, md5);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HashManager::lookup(const string& path, bool cacheable, uInt64 size,
+                         uInt64 modTime, string& md5)
+{
+  Variant value;
+  if(!myRepository->get(path, value))
+    return false;
+
+  const string& entry = value.toString();
+  const string& prefix = cacheEntry(size, modTime);
+
+  // Anything else means the file has changed (or is gone) since it was
+  // hashed, so the entry is of no use anymore
+  if(!cacheable || entry.size() != prefix.size() + 32 ||
+     entry.compare(0, prefix.size(), prefix) != 0)
+  {
+    myRepository->remove(path);
+    return false;
+  }
+
+  md5 = entry.substr(prefix.size());
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string HashManager::hashFile(const FilesystemNode& node)
+{
+  if(node.isArchive())
+  {
+    std::lock_guard<std::mutex> lock(myZipMutex);
+    return MD5::hash(node);
+  }
+  return MD5::hash(node);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string HashManager::cacheEntry(uInt64 size, uInt64 modTime, const string& md5)
+{
+  return std::to_string(size) + ":" + std::to_string(modTime) + ":" + md5;
+}
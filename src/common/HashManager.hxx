@@ -0,0 +1,136 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef HASH_MANAGER_HXX
+#define HASH_MANAGER_HXX
+
+#include <functional>
+#include <mutex>
+
+#include "bspf.hxx"
+#include "FSNode.hxx"
+#include "repository/KeyValueRepository.hxx"
+
+/**
+  This class calculates the MD5 checksums of ROM files.
+
+  Results are stored in a persistent cache, keyed by the path of a file and
+  validated against its size and modification time, so unchanged files are
+  never hashed twice.  Entries of changed or deleted files are removed.  Lists of files are hashed by a pool of worker threads,
+  each reading complete files in one go; this mostly helps with slow (e.g.
+  network) storage.
+
+  The cache is only accessed from the thread calling into this class, the
+  workers do nothing but read and hash files.
+*/
+class HashManager
+{
+  public:
+    /**
+      Receives the MD5 of a file (empty if it could not be read) together
+      with its index in the list passed to hash().  Returning false
+      cancels the remaining files.
+    */
+    using ResultHandler = std::function<bool(size_t, const string&)>;
+
+    HashManager();
+    ~HashManager() = default;
+
+    void setRepository(shared_ptr<KeyValueRepositoryAtomic> repo);
+
+    /**
+      Get the MD5 of the given file, from the cache if possible.
+
+      @param node  The file to compute the digest of
+      @return  The MD5, or the empty string if the file could not be read
+    */
+    string hash(const FilesystemNode& node);
+
+    /**
+      Get the MD5 of all given files.  Cached results are reported first,
+      the remaining files are then hashed in parallel.  The handler is
+      always called on the calling thread, but not in list order.
+
+      @param files    The files to compute the digests of
+      @param handler  Called once for each file, can cancel the operation
+      @return  False if the operation was cancelled, else true
+    */
+    bool hash(const FSList& files, const ResultHandler& handler);
+
+    /**
+      Get the MD5 of the given file only if it is available in the cache.
+
+      @param node  The file to lookup
+      @param md5   Receives the MD5, if found
+      @return  True if a valid MD5 was found in the cache
+    */
+    bool lookup(const FilesystemNode& node, string& md5);
+
+    /**
+      Store an MD5 calculated elsewhere (e.g. from an already loaded image)
+      in the cache.
+
+      @param node  The file the MD5 was calculated from
+      @param md5   The MD5 of the file
+    */
+    void store(const FilesystemNode& node, const string& md5);
+
+    /**
+      Remove the cache entries of files which have been changed or deleted.
+      Entries of files in directories which are not available (e.g. on
+      removable or network storage) are kept.
+    */
+    void prune();
+
+  private:
+    /**
+      Lookup the file in the cache; an entry for another version of the file
+      (or for a file which can't be cached anymore) is removed.
+
+      @return  True if the cached MD5 is still valid for this file version
+    */
+    bool lookup(const string& path, bool cacheable, uInt64 size, uInt64 modTime,
+                string& md5);
+
+    /**
+      Hash a single file; ZIP archives are serialized, since all ZIP files
+      share the same decompressor.
+    */
+    string hashFile(const FilesystemNode& node);
+
+    static string cacheEntry(uInt64 size, uInt64 modTime, const string& md5 = "");
+
+  private:
+    // Limits for the number of worker threads; using more threads than
+    // there are CPU cores hides the latency of slow storage
+    static constexpr uInt32 MIN_WORKERS = 4;
+    static constexpr uInt32 MAX_WORKERS = 16;
+
+    shared_ptr<KeyValueRepositoryAtomic> myRepository;
+
+    std::mutex myZipMutex;
+
+  private:
+    // Following constructors and assignment operators not supported
+    HashManager(const HashManager&) = delete;
+    HashManager(HashManager&&) = delete;
+    HashManager& operator=(const HashManager&) = delete;
+    HashManager& operator=(HashManager&&) = delete;
+};
+
+#endif
@@ -0,0 +1,129 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "Console.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+#include "StateManager.hxx"
+
+#include "IncrementalSnapshot.hxx"
+
+static_assert(IncrementalSnapshot::CHUNK_SIZE == System::PAGE_SIZE);
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool IncrementalSnapshot::capture(const Console& console, Mode mode)
+{
+  myCurrent ^= 1;
+
+  Serializer& out = myState[myCurrent];
+  auto& offsets = myOffsets[myCurrent];
+  size_t block = 0;
+
+  // Remember where each device's block starts
+  const auto hook = [&]() {
+    if(++block < NUM_BLOCKS - 1)
+      offsets[block] = out.size();
+  };
+
+  try
+  {
+    out.reset();
+
+    // Same data as StateManager::saveState()
+    offsets[0] = 0;
+    out.putString(STATE_HEADER);
+    if(!Console::saveState(console.system(), console, out, hook) ||
+       block != NUM_BLOCKS - 2)
+      throw runtime_error("save failed");
+
+    offsets[NUM_BLOCKS - 1] = out.size();
+    if(mode == Mode::timeMachine && !console.tia().saveDisplay(out))
+      throw runtime_error("save failed");
+    offsets[NUM_BLOCKS] = out.size();
+  }
+  catch(...)
+  {
+    cerr << "ERROR: IncrementalSnapshot::capture" << endl;
+    myPreviousValid = false;
+    return false;
+  }
+  myMode = mode;
+  myChanges.clear();
+
+  if(mode == Mode::state)
+  {
+    myPreviousValid = true;
+    return true;
+  }
+
+  // Determine the changes to the previous snapshot
+  const uInt8* const current = out.data();
+  const uInt8* const previous = myState[myCurrent ^ 1].data();
+  const auto& prevOffsets = myOffsets[myCurrent ^ 1];
+
+  for(size_t i = 0; i < NUM_BLOCKS; ++i)
+  {
+    const size_t start = offsets[i], end = offsets[i + 1];
+
+    if(!myPreviousValid || start != prevOffsets[i] || end != prevOffsets[i + 1])
+      addChange(start, end - start);
+    else
+      for(size_t pos = start; pos < end; pos += CHUNK_SIZE)
+      {
+        const size_t size = std::min(CHUNK_SIZE, end - pos);
+
+        if(!std::equal(current + pos, current + pos + size, previous + pos))
+          addChange(pos, size);
+      }
+  }
+  myPreviousValid = true;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool IncrementalSnapshot::restore(Console& console)
+{
+  Serializer& in = myState[myCurrent];
+
+  try
+  {
+    in.rewind();
+
+    return in.getString() == STATE_HEADER && console.load(in) &&
+           (myMode != Mode::timeMachine || console.tia().loadDisplay(in));
+  }
+  catch(...)
+  {
+    cerr << "ERROR: IncrementalSnapshot::restore" << endl;
+  }
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void IncrementalSnapshot::addChange(size_t offset, size_t size)
+{
+  if(size == 0)
+    return;
+
+  if(!myChanges.empty() &&
+     myChanges.back().offset + myChanges.back().size == offset)
+    myChanges.back().size += size;
+  else
+    myChanges.push_back({offset, size});
+}
@@ -0,0 +1,133 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef INCREMENTAL_SNAPSHOT_HXX
+#define INCREMENTAL_SNAPSHOT_HXX
+
+class Console;
+
+#include "Serializer.hxx"
+#include "bspf.hxx"
+
+/**
+  This class takes save states of a console and determines which parts of
+  them changed since the previous snapshot.
+
+  Each device (and the TIA display) is saved as a separate block; a block
+  whose size or position changed is reported as changed completely,
+  otherwise it is compared in chunks the size of a system page.  Most of
+  a state (RIOT and cartridge RAM, TIA registers, the display) usually
+  stays unchanged from one frame to the next, so users like the Time
+  Machine only have to process the changed ranges.  Run-ahead restores
+  the console from the last snapshot after emulating the frames ahead,
+  and doesn't need the changes.
+
+  The snapshot data has the same format as StateManager::saveState()
+  (optionally followed by TIA::saveDisplay()); the blocks are found using
+  the save hook of Console::saveState().
+*/
+class IncrementalSnapshot
+{
+  public:
+    // The blocks a snapshot consists of: header and System, M6502, M6532,
+    // TIA, Cart, Random, left and right controller, Switches and the
+    // (optional) display
+    static constexpr size_t NUM_BLOCKS = 10;
+
+    // Unchanged blocks are compared in chunks of this size (a system page)
+    static constexpr size_t CHUNK_SIZE = 64;
+
+    // The contents of a snapshot
+    enum class Mode {
+      state,       // only the console state, without determining the changes
+      timeMachine  // the console state and the display, with the changes
+    };
+
+    // A range of changed bytes within the snapshot data
+    struct Range {
+      size_t offset{0};
+      size_t size{0};
+    };
+
+  public:
+    IncrementalSnapshot() = default;
+
+    /**
+      Save the state of the given console and (depending on the mode)
+      determine the changes to the previous snapshot.
+
+      @param console  The console to save
+      @param mode     What to save, and whether to determine the changes
+      @return  False on any errors, else true
+    */
+    bool capture(const Console& console, Mode mode);
+
+    /**
+      Load the state of the given console from the last snapshot.
+
+      @param console  The console to load
+      @return  False on any errors, else true
+    */
+    bool restore(Console& console);
+
+    /**
+      Forget the previous snapshot, the next one is reported as changed
+      completely.
+    */
+    void invalidate() { myPreviousValid = false; }
+
+    /**
+      The data and size of the last snapshot.
+    */
+    const uInt8* data() const { return myState[myCurrent].data(); }
+    size_t size() const { return myState[myCurrent].size(); }
+
+    /**
+      The ranges of the last snapshot which changed since the previous one,
+      in ascending order.  Adjacent ranges are merged.  Empty if the mode
+      of the last snapshot doesn't determine them.
+    */
+    const vector<Range>& changes() const { return myChanges; }
+
+  private:
+    /**
+      Add the given range to the list of changes.
+    */
+    void addChange(size_t offset, size_t size);
+
+  private:
+    // The last and the previous snapshot; 'myCurrent' selects the last one
+    std::array<Serializer, 2> myState;
+    uInt32 myCurrent{0};
+    bool myPreviousValid{false};
+    Mode myMode{Mode::state};
+
+    // Start offsets of all blocks (plus the end of the data)
+    std::array<std::array<size_t, NUM_BLOCKS + 1>, 2> myOffsets;
+
+    vector<Range> myChanges;
+
+  private:
+    // Following constructors and assignment operators not supported
+    IncrementalSnapshot(const IncrementalSnapshot&) = delete;
+    IncrementalSnapshot(IncrementalSnapshot&&) = delete;
+    IncrementalSnapshot& operator=(const IncrementalSnapshot&) = delete;
+    IncrementalSnapshot& operator=(IncrementalSnapshot&&) = delete;
+};
+
+#endif
@@ -126,25 +126,34 @@ class LinkedObjectPool
         myCurrent = std::prev(myList.end(), 1);
     }
 
+    /**
+      Return an iterator to the node the 'current' iterator points to.
+    */
+    iter currentIter() const { return myCurrent; }
+
     /**
       Return an iterator to the first node in the active list.
     */
     const_iter first() const { return myList.begin(); }
+    iter first() { return myList.begin(); }
 
     /**
       Return an iterator to the last node in the active list.
     */
     const_iter last() const { return std::prev(myList.end(), 1); }
+    iter last() { return std::prev(myList.end(), 1); }
 
     /**
       Return an iterator to the previous node of 'i' in the active list.
     */
     const_iter previous(const_iter i) const { return std::prev(i, 1); }
+    iter previous(iter i) { return std::prev(i, 1); }
 
     /**
       Return an iterator to the next node to 'current' in the active list.
     */
     const_iter next(const_iter i) const { return std::next(i, 1); }
+    iter next(iter i) { return std::next(i, 1); }
 
     /**
       Canonical iterators from C++ STL.
@@ -51,6 +51,8 @@ void Logger::debug(const string& message)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Logger::logMessage(const string& message, Level level)
 {
+  std::lock_guard<std::mutex> lock(myMutex);
+
   if(level == Logger::Level::ERR)
   {
     cout << message << endl << std::flush;
@@ -48,6 +48,33 @@ class MouseControl
       NoControl
     };
 
+    /**
+      The controllers and axes the mouse controls in a mode
+    */
+    struct MouseMode {
+      Controller::Type xtype{Controller::Type::Joystick}, ytype{Controller::Type::Joystick};
+      int xid{-1}, yid{-1};
+      string message;
+
+      explicit MouseMode(const string& msg = "") : message(msg) { }
+      MouseMode(Controller::Type xt, int xi,
+                Controller::Type yt, int yi,
+                const string& msg)
+        : xtype(xt),
+          ytype(yt),
+          xid(xi),
+          yid(yi),
+          message(msg)  { }
+
+      friend ostream& operator<<(ostream& os, const MouseMode& mm)
+      {
+        os << "xtype=" << int(mm.xtype) << ", xid=" << mm.xid
+           << ", ytype=" << int(mm.ytype) << ", yid=" << mm.yid
+           << ", msg=" << mm.message;
+        return os;
+      }
+    };
+
   public:
     /**
       Create a new MouseControl object
@@ -69,6 +96,11 @@ class MouseControl
     */
     bool hasMouseControl() const { return myHasMouseControl; }
 
+    /**
+      Get the current mouse control mode
+    */
+    const MouseMode& currentMode() const { return myModeList[myCurrentModeNum]; }
+
   private:
     void addLeftControllerModes(bool noswap);
     void addRightControllerModes(bool noswap);
@@ -80,30 +112,6 @@ class MouseControl
     Controller& myLeftController;
     Controller& myRightController;
 
-    struct MouseMode {
-      Controller::Type xtype{Controller::Type::Joystick}, ytype{Controller::Type::Joystick};
-      int xid{-1}, yid{-1};
-      string message;
-
-      explicit MouseMode(const string& msg = "") : message(msg) { }
-      MouseMode(Controller::Type xt, int xi,
-                Controller::Type yt, int yi,
-                const string& msg)
-        : xtype(xt),
-          ytype(yt),
-          xid(xi),
-          yid(yi),
-          message(msg)  { }
-
-      friend ostream& operator<<(ostream& os, const MouseMode& mm)
-      {
-        os << "xtype=" << int(mm.xtype) << ", xid=" << mm.xid
-           << ", ytype=" << int(mm.ytype) << ", yid=" << mm.yid
-           << ", msg=" << mm.message;
-        return os;
-      }
-    };
-
     int myCurrentModeNum{0};
     vector<MouseMode> myModeList;
     bool myHasMouseControl{false};
@@ -39,6 +39,21 @@ PNGLibrary::PNGLibrary(OSystem& osystem)
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PNGLibrary::loadImage(const string& filename, FBSurface& surface)
+{
+  decodeImage(filename, ReadInfo);
+
+  // Load image into the surface, setting the correct dimensions
+  loadImagetoSurface(ReadInfo, surface);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::loadImage(const ImageData& image, FBSurface& surface)
+{
+  loadImagetoSurface(image, surface);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::decodeImage(const string& filename, ImageData& image)
 {
   png_structp png_ptr = nullptr;
   png_infop info_ptr = nullptr;
@@ -101,22 +116,19 @@ void PNGLibrary::loadImage(const string& filename, FBSurface& surface)
   }
 
   // Create/initialize storage area for the current image
-  if(!allocateStorage(iwidth, iheight))
+  if(!allocateStorage(image, iwidth, iheight))
     loadImageERROR("Not enough memory to read PNG file");
 
   // The PNG read function expects an array of rows, not a single 1-D array
-  for(uInt32 irow = 0, offset = 0; irow < ReadInfo.height; ++irow, offset += ReadInfo.pitch)
-    ReadInfo.row_pointers[irow] = static_cast<png_bytep>(ReadInfo.buffer.data() + offset);
+  for(uInt32 irow = 0, offset = 0; irow < image.height; ++irow, offset += image.pitch)
+    image.row_pointers[irow] = static_cast<png_bytep>(image.buffer.data() + offset);
 
   // Read the entire image in one go
-  png_read_image(png_ptr, ReadInfo.row_pointers.data());
+  png_read_image(png_ptr, image.row_pointers.data());
 
   // We're finished reading
   png_read_end(png_ptr, info_ptr);
 
-  // Load image into the surface, setting the correct dimensions
-  loadImagetoSurface(surface);
-
   // Cleanup
   if(png_ptr)
     png_destroy_read_struct(&png_ptr, info_ptr ? &info_ptr : nullptr, nullptr);
@@ -382,29 +394,29 @@ void PNGLibrary::takeSnapshot(uInt32 number)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool PNGLibrary::allocateStorage(png_uint_32 w, png_uint_32 h)
+bool PNGLibrary::allocateStorage(ImageData& image, png_uint_32 w, png_uint_32 h)
 {
   // Create space for the entire image (3 bytes per pixel in RGB format)
   size_t req_buffer_size = w * h * 3;
-  if(req_buffer_size > ReadInfo.buffer.size())
-    ReadInfo.buffer.resize(req_buffer_size);
+  if(req_buffer_size > image.buffer.size())
+    image.buffer.resize(req_buffer_size);
 
   size_t req_row_size = h;
-  if(req_row_size > ReadInfo.row_pointers.size())
-    ReadInfo.row_pointers.resize(req_row_size);
+  if(req_row_size > image.row_pointers.size())
+    image.row_pointers.resize(req_row_size);
 
-  ReadInfo.width  = w;
-  ReadInfo.height = h;
-  ReadInfo.pitch  = w * 3;
+  image.width  = w;
+  image.height = h;
+  image.pitch  = w * 3;
 
   return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void PNGLibrary::loadImagetoSurface(FBSurface& surface)
+void PNGLibrary::loadImagetoSurface(const ImageData& image, FBSurface& surface)
 {
   // First determine if we need to resize the surface
-  uInt32 iw = ReadInfo.width, ih = ReadInfo.height;
+  uInt32 iw = image.width, ih = image.height;
   if(iw > surface.width() || ih > surface.height())
     surface.resize(iw, ih);
 
@@ -416,17 +428,18 @@ void PNGLibrary::loadImagetoSurface(FBSurface& surface)
   // Convert RGB triples into pixels and store in the surface
   uInt32 *s_buf, s_pitch;
   surface.basePtr(s_buf, s_pitch);
-  const uInt8* i_buf = ReadInfo.buffer.data();
-  const uInt32 i_pitch = ReadInfo.pitch;
+  const uInt8* i_buf = image.buffer.data();
+  const uInt32 i_pitch = image.pitch;
 
   const FrameBuffer& fb = myOSystem.frameBuffer();
   for(uInt32 irow = 0; irow < ih; ++irow, i_buf += i_pitch, s_buf += s_pitch)
   {
     const uInt8* i_ptr = i_buf;
     uInt32* s_ptr = s_buf;
-    for(uInt32 icol = 0; icol < ReadInfo.width; ++icol, i_ptr += 3)
+    for(uInt32 icol = 0; icol < image.width; ++icol, i_ptr += 3)
       *s_ptr++ = fb.mapRGB(*i_ptr, *(i_ptr+1), *(i_ptr+2));
   }
+  surface.setDirty(true);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -481,6 +494,6 @@ void PNGLibrary::png_user_error(png_structp ctx, png_const_charp str)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-PNGLibrary::ReadInfoType PNGLibrary::ReadInfo;
+PNGLibrary::ImageData PNGLibrary::ReadInfo;
 
 #endif  // PNG_SUPPORT
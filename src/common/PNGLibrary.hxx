@@ -28,6 +28,8 @@ class FBSurface;
 class Properties;
 
 #include "bspf.hxx"
+#include "Rect.hxx"
+#include "Variant.hxx"
 
 /**
   This class implements a thin wrapper around the libpng library, and
@@ -38,6 +40,16 @@ class Properties;
 */
 class PNGLibrary
 {
+  public:
+    /**
+      Decoded RGB data of a PNG image, not yet bound to any surface.
+    */
+    struct ImageData {
+      vector<png_byte> buffer;
+      vector<png_bytep> row_pointers;
+      png_uint_32 width{0}, height{0}, pitch{0};
+    };
+
   public:
     explicit PNGLibrary(OSystem& osystem);
 
@@ -54,6 +66,27 @@ class PNGLibrary
     */
     void loadImage(const string& filename, FBSurface& surface);
 
+    /**
+      Decode a PNG image from the specified file.  This doesn't depend on
+      any state of the library, and can be called from any thread.
+
+      @param filename  The filename to load the PNG image
+      @param image     Receives the decoded image data
+
+      @post  On failure, a runtime_error is thrown containing a more
+             detailed error message.
+    */
+    static void decodeImage(const string& filename, ImageData& image);
+
+    /**
+      Load previously decoded image data into a FBSurface structure,
+      resizing the surface as necessary.
+
+      @param image     The decoded image data
+      @param surface   The FBSurface into which to place the image data
+    */
+    void loadImage(const ImageData& image, FBSurface& surface);
+
     /**
       Save the current FrameBuffer image to a PNG file.  Note that in most
       cases this will be a TIA image, but it could actually be used for
@@ -136,26 +169,23 @@ class PNGLibrary
 
     // The following data remains between invocations of allocateStorage,
     // and is only changed when absolutely necessary.
-    struct ReadInfoType {
-      vector<png_byte> buffer;
-      vector<png_bytep> row_pointers;
-      png_uint_32 width{0}, height{0}, pitch{0};
-    };
-    static ReadInfoType ReadInfo;
+    static ImageData ReadInfo;
 
     /**
       Allocate memory for PNG read operations.  This is used to provide a
       basic memory manager, so that we don't constantly allocate and deallocate
       memory for each image loaded.
 
-      The method fills the 'ReadInfo' struct with valid memory locations
+      The method fills the 'image' struct with valid memory locations
       dependent on the given dimensions.  If memory has been previously
       allocated and it can accommodate the given dimensions, it is used directly.
 
+      @param image   The image data to allocate memory for
       @param iwidth  The width of the PNG image
       @param iheight The height of the PNG image
     */
-    bool allocateStorage(png_uint_32 iwidth, png_uint_32 iheight);
+    static bool allocateStorage(ImageData& image, png_uint_32 iwidth,
+                                png_uint_32 iheight);
 
     /** The actual method which saves a PNG image.
 
@@ -170,12 +200,13 @@ class PNGLibrary
                          const VariantList& comments);
 
     /**
-      Load the PNG data from 'ReadInfo' into the FBSurface.  The surface
+      Load the PNG data from 'image' into the FBSurface.  The surface
       is resized as necessary to accommodate the data.
 
+      @param image    The decoded PNG data
       @param surface  The FBSurface into which to place the PNG data
     */
-    void loadImagetoSurface(FBSurface& surface);
+    void loadImagetoSurface(const ImageData& image, FBSurface& surface);
 
     /**
       Write PNG tEXt chunks to the image.
@@ -0,0 +1,93 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "PerfStats.hxx"
+
+#ifdef PERFSTATS_SUPPORT
+
+#include <mutex>
+
+namespace {
+  std::mutex lastFrameMutex;
+  PerfStats::Counters lastFrameCounters;
+}
+
+thread_local PerfStats::Scope* PerfStats::ourCurrent = nullptr;
+thread_local PerfStats::Counters PerfStats::ourCounters;
+thread_local PerfStats::Counters PerfStats::ourTotals;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PerfStats::endFrame()
+{
+  {
+    std::lock_guard<std::mutex> lock(lastFrameMutex);
+
+    for(size_t i = 0; i < NUM_SECTIONS; ++i)
+      if(ourCounters[i].calls > 0)
+        lastFrameCounters[i] = ourCounters[i];
+  }
+
+  for(size_t i = 0; i < NUM_SECTIONS; ++i)
+  {
+    ourTotals[i].time += ourCounters[i].time;
+    ourTotals[i].calls += ourCounters[i].calls;
+  }
+  ourCounters.fill(Counter());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PerfStats::Counters PerfStats::lastFrame()
+{
+  std::lock_guard<std::mutex> lock(lastFrameMutex);
+
+  return lastFrameCounters;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PerfStats::Counters PerfStats::totals()
+{
+  Counters counters = ourTotals;
+
+  // Include the current (incomplete) frame
+  for(size_t i = 0; i < NUM_SECTIONS; ++i)
+  {
+    counters[i].time += ourCounters[i].time;
+    counters[i].calls += ourCounters[i].calls;
+  }
+
+  return counters;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PerfStats::resetTotals()
+{
+  ourCounters.fill(Counter());
+  ourTotals.fill(Counter());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string PerfStats::name(Section section)
+{
+  static const std::array<string, NUM_SECTIONS> names = {
+    "cpu", "tia", "tiaMovement", "tiaHframe", "tiaRender", "delayQueue",
+    "audio", "io", "cart", "thumbulator", "tiaSurface"
+  };
+
+  return names[static_cast<size_t>(section)];
+}
+
+#endif // PERFSTATS_SUPPORT
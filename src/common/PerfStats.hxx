@@ -0,0 +1,169 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef PERF_STATS_HXX
+#define PERF_STATS_HXX
+
+/**
+  Optional instrumentation which attributes time and call counts to the
+  various subsystems of the emulation core.
+
+  The instrumentation is only compiled in when PERFSTATS_SUPPORT is defined
+  (configure --enable-perfstats); otherwise the PERF_* macros expand to
+  nothing and there is no runtime cost at all.
+
+  Time is accounted 'exclusive': the time spent in a nested section (e.g. TIA
+  emulation triggered by a CPU write to a TIA register) is subtracted from the
+  enclosing section.  The counters are kept per thread, so several emulation
+  cores can be profiled in parallel (see ProfilingRunner).  At the end of each
+  frame, the counters of the calling thread are published as the statistics
+  of the 'last frame', which is what the stats overlay displays.
+
+  Note that the sections which are entered once per color clock add a
+  considerable overhead themselves, so absolute numbers are only useful for
+  comparing sections and ROMs against each other.
+*/
+
+#ifdef PERFSTATS_SUPPORT
+
+#include <chrono>
+
+#include "bspf.hxx"
+
+class PerfStats
+{
+  public:
+    enum class Section: uInt8 {
+      cpu,          // M6502 instruction execution
+      tia,          // TIA::cycle, excluding the subsections below
+      tiaMovement,  // HMOVE movement ticks
+      tiaHframe,    // object ticks during the visible part of a line
+      tiaRender,    // pixel priority resolution and output
+      delayQueue,   // delayed TIA register writes
+      audio,        // TIA audio
+      io,           // TIA and RIOT register accesses
+      cart,         // cartridge accesses (bankswitching, hotspots, ...)
+      thumbulator,  // ARM code of CDF/BUS/DPC+ carts
+      tiaSurface,   // conversion of the frame buffer into RGB
+      numSections
+    };
+
+    static constexpr size_t NUM_SECTIONS = static_cast<size_t>(Section::numSections);
+
+    struct Counter {
+      uInt64 time{0};   // nanoseconds
+      uInt64 calls{0};
+    };
+
+    using Counters = std::array<Counter, NUM_SECTIONS>;
+
+    /**
+      Measures the time between construction and destruction, and
+      attributes it to the given section.
+    */
+    class Scope
+    {
+      public:
+        explicit Scope(Section section)
+          : mySection{section}, myParent{ourCurrent}, myStart{now()}
+        {
+          ourCurrent = this;
+        }
+
+        ~Scope()
+        {
+          const uInt64 elapsed = now() - myStart;
+
+          ourCurrent = myParent;
+          if(myParent)
+            myParent->myChildTime += elapsed;
+
+          Counter& counter = ourCounters[static_cast<size_t>(mySection)];
+          counter.time += elapsed - myChildTime;
+          ++counter.calls;
+        }
+
+      private:
+        Section mySection;
+        Scope* myParent{nullptr};
+        uInt64 myStart{0};
+        uInt64 myChildTime{0};
+
+      private:
+        Scope() = delete;
+        Scope(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope& operator=(Scope&&) = delete;
+    };
+
+  public:
+    /**
+      Publish the counters of the calling thread as the statistics of the
+      last frame, add them to the thread totals and start the next frame.
+      Only sections which were entered by this thread are published.
+    */
+    static void endFrame();
+
+    /**
+      The statistics of the last complete frame (thread-safe).
+    */
+    static Counters lastFrame();
+
+    /**
+      The totals of the calling thread since the last call to resetTotals().
+    */
+    static Counters totals();
+    static void resetTotals();
+
+    /**
+      The name of the given section, suitable for reports.
+    */
+    static string name(Section section);
+
+    /**
+      The current time in nanoseconds.
+    */
+    static uInt64 now() {
+      return uInt64(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+  private:
+    static thread_local Scope* ourCurrent;
+    static thread_local Counters ourCounters;
+    static thread_local Counters ourTotals;
+
+  private:
+    PerfStats() = delete;
+};
+
+#define PERF_SCOPE(section) \
+  const PerfStats::Scope perfScope_(PerfStats::Section::section)
+#define PERF_SCOPE_DYN(section) \
+  const PerfStats::Scope perfScope_(section)
+#define PERF_END_FRAME() PerfStats::endFrame()
+
+#else
+
+#define PERF_SCOPE(section)
+#define PERF_SCOPE_DYN(section)
+#define PERF_END_FRAME()
+
+#endif // PERFSTATS_SUPPORT
+
+#endif // PERF_STATS_HXX
@@ -17,6 +17,11 @@
 
 #include "PhosphorHandler.hxx"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define PHOSPHOR_SSE2
+  #include <emmintrin.h>
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool PhosphorHandler::initialize(bool enable, int blend)
 {
@@ -27,23 +32,53 @@ bool PhosphorHandler::initialize(bool enable, int blend)
   if(blend >= 0 && blend <= 100)
     myPhosphorPercent = blend / 100.F;
 
-  // Used to calculate an averaged color for the 'phosphor' effect
-  auto getPhosphor = [&] (const uInt8 c1, uInt8 c2) -> uInt8 {
-    // Use maximum of current and decayed previous values
-    c2 = static_cast<uInt8>(c2 * myPhosphorPercent);
-    if(c1 > c2)  return c1; // raise (assumed immediate)
-    else         return c2; // decay
-  };
-
-  // Precalculate the average colors for the 'phosphor' effect
+  // Precalculate the decayed colors for the 'phosphor' effect
+  // The maximum of current and decayed previous values is used, so
+  // raising is assumed to be immediate
   if(myUsePhosphor)
   {
-    for(int c = 255; c >= 0; --c)
-      for(int p = 255; p >= 0; --p)
-        ourPhosphorLUT[c][p] = getPhosphor(uInt8(c), uInt8(p));
+    ourPhosphorPercent = myPhosphorPercent;
+    for(int p = 255; p >= 0; --p)
+      ourPhosphorLUT[p] = static_cast<uInt8>(p * myPhosphorPercent);
   }
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PhosphorHandler::blendRow(uInt32* c, uInt32* p, uInt32 count)
+{
+#ifdef PHOSPHOR_SSE2
+  // Decay four pixels at once; the multiplication is done in single
+  // precision exactly like when filling the LUT, so the results are identical
+  const __m128i zero = _mm_setzero_si128(),
+                mask = _mm_set1_epi32(0x00FFFFFF);
+  const __m128  percent = _mm_set1_ps(ourPhosphorPercent);
+  const auto decay = [&](__m128i color16, bool high) {
+    const __m128i color32 = high ? _mm_unpackhi_epi16(color16, zero)
+                                 : _mm_unpacklo_epi16(color16, zero);
+    return _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(color32), percent));
+  };
+
+  for(; count >= 4; count -= 4, c += 4, p += 4)
+  {
+    const __m128i prev   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i prevLo = _mm_unpacklo_epi8(prev, zero),
+                  prevHi = _mm_unpackhi_epi8(prev, zero);
+    const __m128i decayed = _mm_packus_epi16(
+      _mm_packs_epi32(decay(prevLo, false), decay(prevLo, true)),
+      _mm_packs_epi32(decay(prevHi, false), decay(prevHi, true)));
+    const __m128i result = _mm_and_si128(mask, _mm_max_epu8(decayed,
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(c))));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(c), result);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), result);
+  }
+#endif
+
+  for(; count; --count, ++c, ++p)
+    *c = *p = getPixel(*c, *p);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 PhosphorHandler::PhosphorLUT PhosphorHandler::ourPhosphorLUT;
+float PhosphorHandler::ourPhosphorPercent = 0.60F;
@@ -48,10 +48,22 @@ class PhosphorHandler
                   gp = static_cast<uInt8>(p >> 8),
                   bp = static_cast<uInt8>(p);
 
-      return (ourPhosphorLUT[rc][rp] << 16) | (ourPhosphorLUT[gc][gp] << 8) |
-              ourPhosphorLUT[bc][bp];
+      return (std::max(rc, ourPhosphorLUT[rp]) << 16) |
+             (std::max(gc, ourPhosphorLUT[gp]) << 8) |
+              std::max(bc, ourPhosphorLUT[bp]);
     }
 
+    /**
+      Used to calculate the 'phosphor' effect for a whole row of pixels
+      at once (using SIMD instructions if available).  The result is
+      stored into both buffers.
+
+      @param c      RGB colors of the current frame
+      @param p      RGB colors of the previous frame
+      @param count  The number of pixels to blend
+    */
+    static void blendRow(uInt32* c, uInt32* p, uInt32 count);
+
   private:
     // Use phosphor effect
     bool myUsePhosphor{false};
@@ -59,10 +71,14 @@ class PhosphorHandler
     // Amount to blend when using phosphor effect
     float myPhosphorPercent{0.60F};
 
-    // Precalculated averaged phosphor colors
-    using PhosphorLUT = BSPF::array2D<uInt8, kColor, kColor>;
+    // Precalculated decayed phosphor colors of the previous frame; the
+    // resulting color is the maximum of the current and the decayed color
+    using PhosphorLUT = std::array<uInt8, kColor>;
     static PhosphorLUT ourPhosphorLUT;
 
+    // Amount to blend, as used by blendRow()
+    static float ourPhosphorPercent;
+
   private:
     PhosphorHandler(const PhosphorHandler&) = delete;
     PhosphorHandler(PhosphorHandler&&) = delete;
@@ -26,6 +26,152 @@
 
 #include "RewindManager.hxx"
 
+namespace {
+  // Minimum number of equal bytes which are encoded as a run
+  constexpr size_t MIN_RUN = 4;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  void putLength(vector<uInt8>& out, size_t length)
+  {
+    while(length >= 0x80)
+    {
+      out.push_back(uInt8(length) | 0x80);
+      length >>= 7;
+    }
+    out.push_back(uInt8(length));
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  size_t getLength(const uInt8*& in)
+  {
+    size_t length = 0;
+    int shift = 0;
+
+    while(*in & 0x80)
+    {
+      length |= size_t(*in++ & 0x7f) << shift;
+      shift += 7;
+    }
+    return length | (size_t(*in++) << shift);
+  }
+
+  /**
+    XOR two blocks of bytes, a word at a time.
+  */
+  void xorBytes(uInt8* dst, const uInt8* a, const uInt8* b, size_t size)
+  {
+    size_t i = 0;
+    for(; i + sizeof(uInt64) <= size; i += sizeof(uInt64))
+    {
+      uInt64 wordA, wordB;
+      std::copy_n(a + i, sizeof(uInt64), reinterpret_cast<uInt8*>(&wordA));
+      std::copy_n(b + i, sizeof(uInt64), reinterpret_cast<uInt8*>(&wordB));
+      wordA ^= wordB;
+      std::copy_n(reinterpret_cast<uInt8*>(&wordA), sizeof(uInt64), dst + i);
+    }
+    for(; i < size; ++i)
+      dst[i] = a[i] ^ b[i];
+  }
+
+  /**
+    Run-length encode the given data and append it to 'out'.  Each block
+    starts with its length, shifted left by one; a set lowest bit marks a
+    run, which is followed by the repeated byte, otherwise the literal bytes
+    follow.
+  */
+  void encode(const uInt8* data, size_t size, vector<uInt8>& out)
+  {
+    size_t pos = 0, literal = 0;
+    while(pos < size)
+    {
+      const uInt8 value = data[pos];
+      size_t end = pos + 1;
+
+      // Skip whole words first, runs of zeroes are the common case
+      const uInt64 pattern = value * 0x0101010101010101ULL;
+      uInt64 word = 0;
+      while(end + sizeof(word) <= size)
+      {
+        std::copy_n(data + end, sizeof(word), reinterpret_cast<uInt8*>(&word));
+        if(word != pattern)
+          break;
+        end += sizeof(word);
+      }
+      while(end < size && data[end] == value)
+        ++end;
+
+      if(end - pos >= MIN_RUN)
+      {
+        if(pos > literal)
+        {
+          putLength(out, (pos - literal) << 1);
+          out.insert(out.end(), data + literal, data + pos);
+        }
+        putLength(out, ((end - pos) << 1) | 1);
+        out.push_back(value);
+        literal = end;
+      }
+      pos = end;
+    }
+    if(size > literal)
+    {
+      putLength(out, (size - literal) << 1);
+      out.insert(out.end(), data + literal, data + size);
+    }
+  }
+
+  /**
+    Append a run of 'size' zeroes (ie, unchanged bytes) to 'out'.
+  */
+  void encodeZeroes(size_t size, vector<uInt8>& out)
+  {
+    if(size > 0)
+    {
+      putLength(out, (size << 1) | 1);
+      out.push_back(0);
+    }
+  }
+
+  /**
+    Decode run-length encoded data, XORing it into the given data.  Applied
+    to zeroes, this restores the encoded data.
+  */
+  void decode(const uInt8* in, size_t inSize, uInt8* data, size_t size)
+  {
+    const uInt8* const end = in + inSize;
+    size_t pos = 0;
+
+    while(in < end)
+    {
+      const size_t block = getLength(in);
+      const size_t length = std::min(block >> 1, size - pos);
+
+      if(block & 1)
+      {
+        const uInt8 value = *in++;
+        if(value)
+          for(size_t i = 0; i < length; ++i)
+            data[pos + i] ^= value;
+      }
+      else
+      {
+        xorBytes(data + pos, data + pos, in, length);
+        in += block >> 1;
+      }
+      pos += length;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  ByteBuffer copyBuffer(const vector<uInt8>& data)
+  {
+    ByteBuffer buffer = make_unique<uInt8[]>(data.size());
+    std::copy(data.begin(), data.end(), buffer.get());
+
+    return buffer;
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 RewindManager::RewindManager(OSystem& system, StateManager& statemgr)
   : myOSystem{system},
@@ -119,23 +265,23 @@ bool RewindManager::addState(const string& message, bool timeMachine)
   }
 
   // Remove all future states
-  myStateList.removeToLast();
+  removeFutureStates();
 
   // Make sure we never run out of space
   if(myStateList.full())
     compressStates();
 
-  // Add new state at the end of the list (queue adds at end)
-  // This updates the 'current' iterator inside the list
-  myStateList.addLast();
-  RewindState& state = myStateList.current();
-  Serializer& s = state.data;
-
-  s.rewind();  // rewind Serializer internal buffers
-  if(myStateManager.saveState(s) && myOSystem.console().tia().saveDisplay(s))
+  if(mySnapshot.capture(myOSystem.console(), IncrementalSnapshot::Mode::timeMachine))
   {
+    // Add new state at the end of the list (queue adds at end)
+    // This updates the 'current' iterator inside the list
+    myStateList.addLast();
+    RewindState& state = myStateList.current();
+
     state.message = message;
     state.cycles = myOSystem.console().tia().cycles();
+    myOSystem.console().tia().takeAudioSamples(mySamples);
+    encodeSnapshot(mySamples);
     myLastTimeMachineAdd = timeMachine;
     return true;
   }
@@ -161,10 +307,6 @@ uInt32 RewindManager::rewindStates(uInt32 numStates)
         // ...except when the last state was added automatically,
         // because that already happened one interval before
         myLastTimeMachineAdd = false;
-
-      RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-      s.rewind();  // rewind Serializer internal buffers
     }
     else
       break;
@@ -196,10 +338,6 @@ uInt32 RewindManager::unwindStates(uInt32 numStates)
       // Set internal current iterator to nextCycles state (forward in time),
       // since we will now process this state
       myStateList.moveToNext();
-
-      RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-      s.rewind();  // rewind Serializer internal buffers
     }
     else
       break;
@@ -243,37 +381,30 @@ string RewindManager::saveAllStates()
     if (!out)
       return "Can't save to all states file";
 
-    uInt32 curIdx = getCurrentIdx();
-    rewindStates(MAX_BUF_SIZE);
-    uInt32 numStates = uInt32(cyclesList().size());
+    uInt32 numStates = myStateList.size();
 
     // Save header
     buf.str("");
     out.putString(STATE_HEADER);
     out.putShort(numStates);
 
-    for (uInt32 i = 0; i < numStates; ++i)
+    // The first state is always a keyframe, and every following state is
+    // either a keyframe or the difference to the state before
+    for (StateIter it = myStateList.first(); it != myStateList.cend(); ++it)
     {
-      RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-      uInt32 stateSize = uInt32(s.size());
-      unique_ptr<uInt8[]> buffer = make_unique<uInt8[]>(stateSize);
-
-      out.putInt(stateSize);
-
-      // Rewind Serializer internal buffers
-      s.rewind();
+      if (it->distance == 0)
+        myNewState.assign(it->size, 0);
+      decode(it->data.get(), it->dataSize, myNewState.data(), myNewState.size());
 
       // Save state
-      s.getByteArray(buffer.get(), stateSize);
-      out.putByteArray(buffer.get(), stateSize);
-      out.putString(state.message);
-      out.putLong(state.cycles);
-
-      unwindStates(1);
+      out.putInt(it->size);
+      out.putByteArray(myNewState.data(), myNewState.size());
+      out.putString(it->message);
+      out.putLong(it->cycles);
+      decodeSamples(*it, mySamples);
+      out.putInt(uInt32(mySamples.size()));
+      out.putByteArray(mySamples.data(), mySamples.size());
     }
-    // restore old state position
-    rewindStates(numStates - curIdx);
 
     buf.str("");
     buf << "Saved " << numStates << " states";
@@ -316,22 +447,20 @@ string RewindManager::loadAllStates()
         compressStates();
 
       uInt32 stateSize = in.getInt();
-      unique_ptr<uInt8[]> buffer = make_unique<uInt8[]>(stateSize);
+      myNewState.resize(stateSize);
 
       // Add new state at the end of the list (queue adds at end)
       // This updates the 'current' iterator inside the list
       myStateList.addLast();
       RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-
-      // Rewind Serializer internal buffers
-      s.rewind();
 
       // Fill new state with saved values
-      in.getByteArray(buffer.get(), stateSize);
-      s.putByteArray(buffer.get(), stateSize);
+      in.getByteArray(myNewState.data(), stateSize);
       state.message = in.getString();
       state.cycles = in.getLong();
+      mySamples.resize(in.getInt());
+      in.getByteArray(mySamples.data(), mySamples.size());
+      encodeState(myNewState, mySamples);
     }
 
     // initialize current state (parameters ignored)
@@ -354,7 +483,7 @@ void RewindManager::compressStates()
   double maxError = 1.5;
   uInt32 idx = myStateList.size() - 2;
   // in case maxError is <= 1.5 remove first state by default:
-  Common::LinkedObjectPool<RewindState>::const_iter removeIter = myStateList.first();
+  StateIter removeIter = myStateList.first();
   /*if(myUncompressed < mySize)
     //  if compression is enabled, the first but one state is removed by default:
     removeIter++;*/
@@ -378,17 +507,230 @@ void RewindManager::compressStates()
     }
     --idx;
   }
-   myStateList.remove(removeIter); // remove
+  removeState(removeIter); // remove
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::removeState(StateIter it)
+{
+  if(it == myStateList.last())
+    invalidateLastState();
+  else
+  {
+    const StateIter next = myStateList.next(it);
+
+    // Unless it is a keyframe, the next state is stored as the difference
+    // to the removed state, and must be re-encoded
+    if(next->distance > 0)
+    {
+      if(it->distance == 0)
+      {
+        // The next state becomes a keyframe
+        decodeState(next, myDelta);
+        next->distance = 0;
+      }
+      else
+      {
+        // Combine both differences into one
+        myDelta.assign(next->size, 0);
+        decode(it->data.get(), it->dataSize, myDelta.data(), myDelta.size());
+        decode(next->data.get(), next->dataSize, myDelta.data(), myDelta.size());
+        next->distance = it->distance;
+      }
+      myEncoded.clear();
+      encode(myDelta.data(), myDelta.size(), myEncoded);
+
+      // The audio samples stay with the state
+      const uInt8* samples = next->data.get() + next->dataSize;
+      next->dataSize = uInt32(myEncoded.size());
+      myEncoded.insert(myEncoded.end(), samples, samples + next->samplesDataSize);
+      next->data = copyBuffer(myEncoded);
+
+      uInt32 distance = next->distance;
+      for(StateIter i = myStateList.next(next);
+          i != myStateList.cend() && i->distance > 0; ++i)
+        i->distance = ++distance;
+    }
+  }
+  it->data.reset();
+  it->dataSize = 0;
+  myStateList.remove(it);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::removeFutureStates()
+{
+  if(!myStateList.currentIsValid() || !myStateList.atLast())
+  {
+    if(myStateList.currentIsValid())
+      for(StateIter it = myStateList.next(myStateList.currentIter());
+          it != myStateList.cend(); ++it)
+      {
+        it->data.reset();
+        it->dataSize = 0;
+      }
+    invalidateLastState();
+  }
+
+  myStateList.removeToLast();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::clear()
+{
+  for(StateIter it = myStateList.first(); it != myStateList.cend(); ++it)
+  {
+    it->data.reset();
+    it->dataSize = 0;
+  }
+  myStateList.clear();
+  invalidateLastState();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::encodeState(vector<uInt8>& data, const ByteArray& samples)
+{
+  encodeState(data.data(), data.size(), {{0, data.size()}}, samples);
+
+  // The data itself is not needed anymore
+  myLastState.swap(data);
+  myLastStateValid = true;
+
+  // The snapshot doesn't know about the new last state
+  mySnapshot.invalidate();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::encodeSnapshot(const ByteArray& samples)
+{
+  const uInt8* data = mySnapshot.data();
+  const size_t size = mySnapshot.size();
+
+  if(encodeState(data, size, mySnapshot.changes(), samples))
+  {
+    // The decoded last state equals the snapshot outside of the changes
+    for(const auto& change: mySnapshot.changes())
+      std::copy_n(data + change.offset, change.size,
+                  myLastState.data() + change.offset);
+  }
+  else
+    myLastState.assign(data, data + size);
+
+  myLastStateValid = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::encodeState(const uInt8* data, size_t size,
+                                const vector<IncrementalSnapshot::Range>& changes,
+                                const ByteArray& samples)
+{
+  const StateIter it = myStateList.last();
+  RewindState& state = *it;
+
+  myEncoded.clear();
+  state.distance = 0;
+  if(it != myStateList.first())
+  {
+    const StateIter prev = myStateList.previous(it);
+
+    // Store the difference to the previous state, unless a keyframe is due
+    if(prev->distance + 1 < KEYFRAME_INTERVAL && prev->size == size)
+    {
+      if(!myLastStateValid)
+        decodeState(prev, myLastState);
+
+      // Unchanged ranges are runs of zeroes in the difference, which are
+      // merged with the zeroes at the borders of the changed ranges
+      size_t pos = 0, zeroes = 0;
+      for(const auto& change: changes)
+      {
+        myDelta.resize(change.size);
+        xorBytes(myDelta.data(), data + change.offset,
+                 myLastState.data() + change.offset, change.size);
+
+        size_t begin = 0, end = change.size;
+        while(begin < end && myDelta[begin] == 0)
+          ++begin;
+        while(end > begin && myDelta[end - 1] == 0)
+          --end;
+
+        zeroes += change.offset - pos + begin;
+        if(begin < end)
+        {
+          encodeZeroes(zeroes, myEncoded);
+          encode(myDelta.data() + begin, end - begin, myEncoded);
+          zeroes = 0;
+        }
+        zeroes += change.size - end;
+        pos = change.offset + change.size;
+      }
+      encodeZeroes(zeroes + size - pos, myEncoded);
+
+      state.distance = prev->distance + 1;
+    }
+  }
+
+  if(state.distance == 0)
+    encode(data, size, myEncoded);
+
+  state.dataSize = uInt32(myEncoded.size());
+  state.size = uInt32(size);
+
+  encode(samples.data(), samples.size(), myEncoded);
+  state.samplesSize = uInt32(samples.size());
+  state.samplesDataSize = uInt32(myEncoded.size()) - state.dataSize;
+  state.data = copyBuffer(myEncoded);
+
+  return state.distance > 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::decodeState(StateIter it, vector<uInt8>& data) const
+{
+  // Find the keyframe (the first state is always one) ...
+  StateIter key = it;
+  while(key->distance > 0 && key != myStateList.first())
+    --key;
+
+  // ... and apply all differences from there on
+  data.assign(it->size, 0);
+  for(StateIter i = key; ; ++i)
+  {
+    decode(i->data.get(), i->dataSize, data.data(), data.size());
+    if(i == it)
+      break;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::decodeSamples(const RewindState& state,
+                                  ByteArray& samples) const
+{
+  samples.assign(state.samplesSize, 0);
+  decode(state.data.get() + state.dataSize, state.samplesDataSize,
+         samples.data(), samples.size());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string RewindManager::loadState(Int64 startCycles, uInt32 numStates)
 {
   RewindState& state = myStateList.current();
-  Serializer& s = state.data;
+  Serializer& s = myStateData;
+  const vector<uInt8>* data = &myLastState;
+
+  // The last state is usually decoded already
+  if(!myStateList.atLast() || !myLastStateValid)
+  {
+    decodeState(myStateList.currentIter(), myNewState);
+    data = &myNewState;
+  }
+  s.reset();
+  s.putByteArray(data->data(), data->size());
 
   myStateManager.loadState(s);
   myOSystem.console().tia().loadDisplay(s);
+  decodeSamples(state, mySamples);
+  myOSystem.console().tia().playAudioSamples(mySamples.data(), mySamples.size());
 
   Int64 diff = startCycles - state.cycles;
   stringstream message;
@@ -21,7 +21,9 @@
 class OSystem;
 class StateManager;
 
+#include "IncrementalSnapshot.hxx"
 #include "LinkedObjectPool.hxx"
+#include "Serializer.hxx"
 #include "bspf.hxx"
 
 /**
@@ -41,6 +43,16 @@ class StateManager;
   If the list is full, states are either removed at the beginning (compression
   off) or at selective positions (compression on).
 
+  To save memory, states are stored run-length encoded.  Only every
+  KEYFRAME_INTERVAL-th state (a keyframe) is stored completely, all others
+  are stored as the difference (XOR) to their previous state.  Decoding a
+  state applies the differences starting at the last keyframe.
+
+  New states are taken as incremental snapshots, so only the parts which
+  changed since the previous state have to be compared and encoded.  The
+  audio samples generated since the previous state vary in number, so they
+  are run-length encoded on their own and stored after the encoded state.
+
   @author  Stephen Anthony
 */
 class RewindManager
@@ -50,6 +62,8 @@ class RewindManager
 
   public:
     static constexpr uInt32 MAX_BUF_SIZE = 1000;
+    // maximum number of states between two keyframes
+    static constexpr uInt32 KEYFRAME_INTERVAL = 30;
     static constexpr int NUM_INTERVALS = 7;
     // cycle values for the intervals
     const std::array<uInt32, NUM_INTERVALS> INTERVAL_CYCLES = {
@@ -142,10 +156,11 @@ class RewindManager
 
     bool atFirst() const { return myStateList.atFirst(); }
     bool atLast() const  { return myStateList.atLast();  }
-    void resize(uInt32 size) { myStateList.resize(size); }
-    void clear() {
-      myStateList.clear();
+    void resize(uInt32 size) {
+      myStateList.resize(size);
+      invalidateLastState();
     }
+    void clear();
 
     /**
       Convert the cycles into a unit string.
@@ -178,12 +193,18 @@ class RewindManager
     bool   myLastTimeMachineAdd{false};
 
     struct RewindState {
-      Serializer data;  // actual save state
-      string message;   // describes save state origin
-      uInt64 cycles{0}; // cycles since emulation started
+      ByteBuffer data;      // encoded save state (complete or difference)
+      uInt32 dataSize{0};   // size of the encoded data
+      uInt32 size{0};       // size of the decoded save state
+      uInt32 distance{0};   // number of states since last keyframe (0 = keyframe)
+      uInt32 samplesSize{0};      // number of audio samples
+      uInt32 samplesDataSize{0};  // size of the encoded samples after the data
+      string message;       // describes save state origin
+      uInt64 cycles{0};     // cycles since emulation started
 
       // We do nothing on object instantiation or copy
-      // The goal of LinkedObjectPool is to not do any allocations at all
+      // The goal of LinkedObjectPool is to not do any allocations at all;
+      // only the encoded data is allocated, since its size varies a lot
       RewindState() = default;
       RewindState(const RewindState& rs) : cycles(rs.cycles) { }
       RewindState& operator= (const RewindState& rs) { cycles = rs.cycles; return *this; }
@@ -197,12 +218,85 @@ class RewindManager
     // The linked-list to store states (internally it takes care of reducing
     // frequent (de)-allocations)
     Common::LinkedObjectPool<RewindState> myStateList;
+    using StateIter = Common::LinkedObjectPool<RewindState>::iter;
+
+    // Serializer used for loading the decoded states
+    Serializer myStateData;
+
+    // Snapshot used for saving new states; its previous snapshot is the
+    // last state, as long as that is valid
+    IncrementalSnapshot mySnapshot;
+
+    // Decoded data of the last state in the list, used for encoding the
+    // difference to the next state
+    vector<uInt8> myLastState;
+    bool myLastStateValid{false};
+
+    // Scratch buffers for encoding and decoding
+    vector<uInt8> myNewState, myDelta, myEncoded;
+
+    // The audio samples of a new state
+    ByteArray mySamples;
 
     /**
       Remove a save state from the list
     */
     void compressStates();
 
+    /**
+      Remove the given state from the list, re-encoding the following state
+      if it depends on the removed one.
+    */
+    void removeState(StateIter it);
+
+    /**
+      Free the encoded data of all states after the current one and remove
+      them from the list.
+    */
+    void removeFutureStates();
+
+    /**
+      Encode the given data into the last state of the list.  The data is
+      moved into the decoded last state afterwards.
+    */
+    void encodeState(vector<uInt8>& data, const ByteArray& samples);
+
+    /**
+      Encode the last snapshot into the last state of the list.  Only the
+      changed ranges are encoded and copied into the decoded last state.
+    */
+    void encodeSnapshot(const ByteArray& samples);
+
+    /**
+      Encode the given data into the last state of the list, as difference
+      to the decoded last state if possible.  Outside the given changes,
+      the data must be equal to the decoded last state.  The audio samples
+      are encoded separately and stored after the encoded data.
+
+      @return  True if the difference was encoded, false for a keyframe
+    */
+    bool encodeState(const uInt8* data, size_t size,
+                     const vector<IncrementalSnapshot::Range>& changes,
+                     const ByteArray& samples);
+
+    /**
+      Decode the audio samples of the given state.
+    */
+    void decodeSamples(const RewindState& state, ByteArray& samples) const;
+
+    /**
+      Mark the decoded last state as invalid.
+    */
+    void invalidateLastState() {
+      myLastStateValid = false;
+      mySnapshot.invalidate();
+    }
+
+    /**
+      Decode the given state into 'data'.
+    */
+    void decodeState(StateIter it, vector<uInt8>& data) const;
+
     /**
       Load the current state and get the message string for the rewind/unwind
 
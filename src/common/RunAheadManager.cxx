@@ -0,0 +1,169 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "OSystem.hxx"
+#include "Console.hxx"
+#include "Settings.hxx"
+#include "Control.hxx"
+#include "FrameBuffer.hxx"
+#include "EmulationTiming.hxx"
+#include "DispatchResult.hxx"
+#include "M6502.hxx"
+#include "TIA.hxx"
+#include "TimerManager.hxx"
+
+#include "RunAheadManager.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RunAheadManager::RunAheadManager(OSystem& system)
+  : myOSystem{system}
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RunAheadManager::setup()
+{
+  myFrames = BSPF::clamp(myOSystem.settings().getInt("runahead"),
+                         0, int(MAX_FRAMES));
+  myFrameCount = 0;
+  myIntervalUpdates = 0;
+  myIntervalTime = myIntervalStateTime = 0;
+  myStatistics = Statistics();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RunAheadManager::enabled() const
+{
+  if(myFrames == 0 || !myOSystem.hasConsole())
+    return false;
+
+  const Console& console = myOSystem.console();
+
+#ifdef DEBUGGER_SUPPORT
+  if(console.system().m6502().isDebugging())
+    return false;
+#endif
+
+  // Frames emulated ahead would change state which is not restored
+  return !console.leftController().hasExternalState() &&
+         !console.rightController().hasExternalState();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RunAheadManager::update()
+{
+  if(!enabled())
+    return;
+
+  Console& console = myOSystem.console();
+  TIA& tia = console.tia();
+
+  // Only run ahead once per completed frame
+  if(tia.frameCount() == myFrameCount)
+    return;
+
+  const uInt64 startTime = TimerManager::getTicks();
+
+  // Muting also keeps the audio samples recorded for the Time Machine
+  tia.setAudioMuted(true);
+
+  if(!mySnapshot.capture(console, IncrementalSnapshot::Mode::state))
+  {
+    tia.setAudioMuted(false);
+    return;
+  }
+
+  const uInt64 savedTime = TimerManager::getTicks();
+
+  // Emulate the frames ahead; the current frame may be partially emulated
+  // already, so it is completed first.  A timeslice would run past the end of
+  // a frame (into the next one), so the emulation proceeds a scanline at a
+  // time instead.  In case the frame manager doesn't complete a frame, each
+  // one is limited to twice the regular cycles.
+  const EmulationTiming& timing = console.emulationTiming();
+  const uInt64 maxCycles = 2 * uInt64(timing.cyclesPerFrame());
+  DispatchResult result;
+
+  for(uInt32 frame = 0; frame < myFrames; ++frame)
+  {
+    const uInt32 frameCount = tia.frameCount();
+    uInt64 cycles = 0;
+
+    // Only the last frame emulated ahead is displayed
+    tia.setFramesHidden(frame + 1 < myFrames);
+    do
+    {
+      tia.update(result, TIAConstants::H_CYCLES);
+      cycles += result.getCycles();
+    }
+    while(result.getStatus() == DispatchResult::Status::ok &&
+          tia.frameCount() == frameCount && cycles < maxCycles);
+
+    // Errors are reported when the actual emulation gets there
+    if(result.getStatus() != DispatchResult::Status::ok)
+      break;
+  }
+
+  const uInt64 emulatedTime = TimerManager::getTicks();
+
+  const bool restored = mySnapshot.restore(console);
+  tia.setAudioMuted(false);
+  myFrameCount = tia.frameCount();
+
+  if(!restored)
+  {
+    myFrames = 0;
+    myOSystem.frameBuffer().showTextMessage(
+        "Run-ahead disabled, restoring the state failed");
+    return;
+  }
+
+  const uInt64 endTime = TimerManager::getTicks();
+
+  // Accumulate the statistics
+  myIntervalTime += endTime - startTime;
+  myIntervalStateTime += (savedTime - startTime) + (endTime - emulatedTime);
+  if(++myIntervalUpdates == STATS_INTERVAL)
+  {
+    const float frameRate = console.currentFrameRate();
+
+    myStatistics.frames = myFrames;
+    myStatistics.time = myIntervalTime / 1000. / myIntervalUpdates;
+    myStatistics.stateTime = myIntervalStateTime / 1000. / myIntervalUpdates;
+    myStatistics.load = frameRate > 0
+      ? myStatistics.time * frameRate / 10. : 0.;
+
+    myIntervalUpdates = 0;
+    myIntervalTime = myIntervalStateTime = 0;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string RunAheadManager::statisticsString() const
+{
+  if(!enabled()) return EmptyString;
+
+  ostringstream buf;
+
+  buf << "Run-ahead " << myFrames << ": " << std::fixed << std::setprecision(2)
+      << myStatistics.time << "ms (" << std::setprecision(0)
+      << myStatistics.load << "%), state " << std::setprecision(3)
+      << myStatistics.stateTime << "ms";
+
+  return buf.str();
+}
@@ -0,0 +1,116 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef RUN_AHEAD_MANAGER_HXX
+#define RUN_AHEAD_MANAGER_HXX
+
+class OSystem;
+
+#include "IncrementalSnapshot.hxx"
+#include "bspf.hxx"
+
+/**
+  This class implements the run-ahead mode, which removes the input lag of
+  games that react to input one or more frames later.
+
+  Whenever the emulation has completed a frame, its state is saved and the
+  emulation continues for the given number of frames with the current input.
+  Only the last of these frames is displayed, their audio is discarded.  Then
+  the saved state is restored, so the actual emulation (which provides the
+  audio) continues unchanged, while none of its frames is displayed.
+
+  The price is the emulation of the additional frames plus saving and loading
+  a state per frame.  Run-ahead is inactive while the debugger is attached
+  (breakpoints, traps, conditions or developer mode), because frames emulated
+  ahead would trigger these too.  The same applies to controllers with state
+  outside of the save state, like the EEPROM of a SaveKey or AtariVox.
+*/
+class RunAheadManager
+{
+  public:
+    // The maximum number of frames to run ahead
+    static constexpr uInt32 MAX_FRAMES = 4;
+
+    struct Statistics {
+      uInt32 frames{0};      // frames emulated ahead
+      double time{0.};       // average time spent per frame (ms)
+      double stateTime{0.};  // ... thereof saving and loading the state (ms)
+      double load{0.};       // time per frame relative to the frame period (%)
+    };
+
+  public:
+    explicit RunAheadManager(OSystem& system);
+
+  public:
+    /**
+      Read the run-ahead settings, called whenever a console is started.
+    */
+    void setup();
+
+    /**
+      Answer whether frames are emulated ahead.
+    */
+    bool enabled() const;
+
+    /**
+      Run ahead and back to the current state, if a frame was completed since
+      the last time.  Must only be called while the emulation is stopped.
+    */
+    void update();
+
+    /**
+      Get the statistics of the last interval.
+    */
+    Statistics statistics() const { return myStatistics; }
+
+    /**
+      Get the statistics formatted for the frame statistics overlay.
+    */
+    string statisticsString() const;
+
+  private:
+    // Number of run-ahead updates averaged for the statistics
+    static constexpr uInt32 STATS_INTERVAL = 60;
+
+    OSystem& myOSystem;
+
+    // The number of frames to run ahead, 0 if disabled
+    uInt32 myFrames{0};
+
+    // The state to return to after running ahead
+    IncrementalSnapshot mySnapshot;
+
+    // The frame count of the state we last ran ahead from
+    uInt32 myFrameCount{0};
+
+    // Accumulated for the current statistics interval (in microseconds)
+    uInt32 myIntervalUpdates{0};
+    uInt64 myIntervalTime{0}, myIntervalStateTime{0};
+
+    Statistics myStatistics;
+
+  private:
+    // Following constructors and assignment operators not supported
+    RunAheadManager() = delete;
+    RunAheadManager(const RunAheadManager&) = delete;
+    RunAheadManager(RunAheadManager&&) = delete;
+    RunAheadManager& operator=(const RunAheadManager&) = delete;
+    RunAheadManager& operator=(RunAheadManager&&) = delete;
+};
+
+#endif
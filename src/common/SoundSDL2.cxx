@@ -34,6 +34,7 @@
 #include "AudioSettings.hxx"
 #include "audio/SimpleResampler.hxx"
 #include "audio/LanczosResampler.hxx"
+#include "audio/LatencyController.hxx"
 #include "StaggeredLogger.hxx"
 
 #include "ThreadDebugging.hxx"
@@ -200,6 +201,7 @@ void SoundSDL2::close()
 
   if (myAudioQueue) myAudioQueue->closeSink(myCurrentFragment);
   myAudioQueue.reset();
+  myLatencyController.reset();
   myCurrentFragment = nullptr;
 }
 
@@ -330,13 +332,32 @@ string SoundSDL2::about() const
   buf << "    Headroom:      " << std::fixed << std::setprecision(1)
       << (0.5 * myAudioSettings.headroom()) << " frames" << endl
       << "    Buffer size:   " << std::fixed << std::setprecision(1)
-      << (0.5 * myAudioSettings.bufferSize()) << " frames" << endl;
+      << (0.5 * myAudioSettings.bufferSize()) << " frames" << endl
+      << "    Adaptive:      " << (myAudioSettings.adaptive() ? "yes" : "no") << endl;
+  return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string SoundSDL2::statistics() const
+{
+  if (!myAudioQueue || !myLatencyController) return EmptyString;
+
+  const LatencyController::Statistics stats = myLatencyController->statistics();
+  ostringstream buf;
+
+  buf << "Audio " << std::fixed << std::setprecision(1) << stats.latency << "ms";
+  if (stats.adaptive)
+    buf << std::showpos << std::setprecision(2) << " " << stats.rateCorrection
+        << std::noshowpos << "% H" << stats.headroom << " B" << stats.bufferSize;
+  buf << " U" << stats.underruns << " O" << stats.overflows;
+
   return buf.str();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundSDL2::processFragment(float* stream, uInt32 length)
 {
+  myResampler->setRateFactor(myLatencyController->rateFactor());
   myResampler->fillFragment(stream, length);
 
   for (uInt32 i = 0; i < length; ++i)
@@ -346,17 +367,41 @@ void SoundSDL2::processFragment(float* stream, uInt32 length)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundSDL2::initResampler()
 {
+  // The headroom is part of the prebuffer count, and is managed by the
+  // latency controller from here on
+  myLatencyController = make_unique<LatencyController>(
+    myEmulationTiming->prebufferFragmentCount() - myAudioSettings.headroom(),
+    myAudioQueue->capacity(),
+    myAudioSettings.headroom(),
+    myAudioSettings.bufferSize(),
+    static_cast<double>(myEmulationTiming->audioSampleRate()) / myAudioQueue->fragmentSize(),
+    myAudioSettings.adaptive()
+  );
+
   Resampler::NextFragmentCallback nextFragmentCallback = [this] () -> Int16* {
     Int16* nextFragment = nullptr;
+    const uInt32 queuedFragments = myAudioQueue->size();
+    uInt32 dropped = 0;
 
     if (myUnderrun)
-      nextFragment = myAudioQueue->size() >= myEmulationTiming->prebufferFragmentCount() ?
+      nextFragment = queuedFragments >= myLatencyController->prebufferFragmentCount() ?
           myAudioQueue->dequeue(myCurrentFragment) : nullptr;
-    else
+    else {
+      // Skip fragments that exceed the current buffer size
+      dropped = myLatencyController->excessFragments(queuedFragments);
+      for (uInt32 i = 0; i < dropped; ++i)
+        myCurrentFragment = myAudioQueue->dequeue(myCurrentFragment);
+
       nextFragment = myAudioQueue->dequeue(myCurrentFragment);
+      if (!nextFragment) myLatencyController->underrun();
+    }
 
     myUnderrun = nextFragment == nullptr;
-    if (nextFragment) myCurrentFragment = nextFragment;
+    if (nextFragment) {
+      myCurrentFragment = nextFragment;
+      myLatencyController->fragmentDequeued(
+        queuedFragments, myAudioQueue->overflowCount(), dropped);
+    }
 
     return nextFragment;
   };
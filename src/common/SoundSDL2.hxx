@@ -25,6 +25,7 @@ class AudioQueue;
 class EmulationTiming;
 class AudioSettings;
 class Resampler;
+class LatencyController;
 
 #include "SDL_lib.hxx"
 
@@ -107,6 +108,11 @@ class SoundSDL2 : public Sound
     */
     string about() const override;
 
+    /**
+      Provides the current latency, rate correction, underruns and overflows.
+    */
+    string statistics() const override;
+
   protected:
     /**
       This method is called to query the audio devices.
@@ -159,6 +165,9 @@ class SoundSDL2 : public Sound
 
     unique_ptr<Resampler> myResampler;
 
+    // Tracks the queue state and adapts the latency (if enabled)
+    unique_ptr<LatencyController> myLatencyController;
+
     AudioSettings& myAudioSettings;
 
     string myAboutString;
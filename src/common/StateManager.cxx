@@ -23,17 +23,48 @@
 #include "Switches.hxx"
 #include "System.hxx"
 #include "Serializable.hxx"
+#include "EventHandler.hxx"
+#include "TIA.hxx"
+#include "Movie.hxx"
 #include "RewindManager.hxx"
+#include "RunAheadManager.hxx"
+
+#ifdef CHEATCODE_SUPPORT
+  #include "Cheat.hxx"
+  #include "CheatManager.hxx"
+#endif
 
 #include "StateManager.hxx"
 
-// #define MOVIE_HEADER "03030000movie"
+namespace {
+  // The mouse control mode is part of the recorded input
+  MouseControl::MouseMode mouseMode(const OSystem& osystem)
+  {
+    const MouseControl* mouseControl = osystem.eventHandler().mouseControl();
+
+    return mouseControl ? mouseControl->currentMode() : MouseControl::MouseMode();
+  }
+
+  // Cheats change the emulation other than by input, so movies can't contain
+  // them
+  bool cheatsEnabled(const OSystem& osystem)
+  {
+  #ifdef CHEATCODE_SUPPORT
+    for(const auto& cheat: osystem.cheat().list())
+      if(cheat->enabled())
+        return true;
+  #endif
+    return false;
+  }
+}
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 StateManager::StateManager(OSystem& osystem)
   : myOSystem{osystem}
 {
   myRewindManager = make_unique<RewindManager>(myOSystem, *this);
+  myRunAheadManager = make_unique<RunAheadManager>(myOSystem);
+  myMovie = make_unique<Movie>();
   reset();
 }
 
@@ -42,94 +73,104 @@ StateManager::~StateManager()
 {
 }
 
-#if 0
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void StateManager::toggleRecordMode()
+void StateManager::startMovie(const string& filename)
 {
-  if(myActiveMode != kMovieRecordMode)  // Turn on movie record mode
-  {
-    myActiveMode = kOffMode;
-
-    string moviefile = /*myOSystem.baseDir() +*/ "test.inp";
-    if(myMovieWriter.isOpen())
-      myMovieWriter.close();
-    if(!myMovieWriter.open(moviefile))
-      return false;
-
-    // Prepend the ROM md5 so this state file only works with that ROM
-    myMovieWriter.putString(myOSystem.console().properties().get(Cartridge_MD5));
-
-    if(!myOSystem.console().save(myMovieWriter))
-      return false;
-
-    // Save controller types for this ROM
-    // We need to check this, since some controllers save more state than
-    // normal, and those states files wouldn't be compatible with normal
-    // controllers.
-    myMovieWriter.putString(
-      myOSystem.console().controller(Controller::Jack::Left).name());
-    myMovieWriter.putString(
-      myOSystem.console().controller(Controller::Jack::Right).name());
-
-    // If we get this far, we're really in movie record mode
-    myActiveMode = kMovieRecordMode;
-  }
-  else  // Turn off movie record mode
-  {
-    myActiveMode = kOffMode;
-    myMovieWriter.close();
-    return false;
-  }
+  stopMovie();
 
-  return myActiveMode == kMovieRecordMode;
-////////////////////////////////////////////////////////
-// FIXME - For now, I'm going to use this to activate movie playback
-  // Close the writer, since we're about to re-open in read mode
-  myMovieWriter.close();
+  // The movie is created with the next input poll, so that the initial
+  // state and the inputs polled with it match
+  myMovieFile = filename;
+  myActiveMode = Mode::MovieRecord;
+}
 
-  if(myActiveMode != kMoviePlaybackMode)  // Turn on movie playback mode
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::stopMovie(const string& reason)
+{
+  if(myMovie->isRecording())
   {
-    myActiveMode = kOffMode;
-
-    string moviefile = /*myOSystem.baseDir() + */ "test.inp";
-    if(myMovieReader.isOpen())
-      myMovieReader.close();
-    if(!myMovieReader.open(moviefile))
-      return false;
-
-    // Check the ROM md5
-    if(myMovieReader.getString() !=
-       myOSystem.console().properties().get(Cartridge_MD5))
-      return false;
+    myMovie->close();
 
-    if(!myOSystem.console().load(myMovieReader))
-      return false;
-
-    // Check controller types
-    const string& left  = myMovieReader.getString();
-    const string& right = myMovieReader.getString();
+    ostringstream buf;
+    buf << "Movie recording stopped after " << myMovie->records() << " frames";
+    if(!reason.empty())
+      buf << " (" << reason << ")";
+    myOSystem.frameBuffer().showTextMessage(buf.str());
+  }
+  else if(!reason.empty() && myActiveMode == Mode::MovieRecord)
+    myOSystem.frameBuffer().showTextMessage("Can't record movie (" + reason + ")");
+  myMovieFile = "";
 
-    if(left != myOSystem.console().controller(Controller::Jack::Left).name() ||
-       right != myOSystem.console().controller(Controller::Jack::Right).name())
-      return false;
+  if(myActiveMode == Mode::MovieRecord)
+    myActiveMode = timeMachineMode();
+}
 
-    // If we get this far, we're really in movie record mode
-    myActiveMode = kMoviePlaybackMode;
-  }
-  else  // Turn off movie playback mode
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::createMovie()
+{
+  const Console& console = myOSystem.console();
+  const Properties& props = console.properties();
+  Settings& settings = myOSystem.settings();
+
+  // The axis and direction swapping paddle variants can only be selected by
+  // properties, the controllers themselves are just paddles
+  const auto controllerType = [&](const Controller& controller) {
+    const Controller::Type type = Controller::getType(props.get(
+      controller.jack() == Controller::Jack::Left
+        ? PropType::Controller_Left : PropType::Controller_Right));
+
+    return controller.type() == Controller::Type::Paddles &&
+      (type == Controller::Type::PaddlesIAxis ||
+       type == Controller::Type::PaddlesIAxDr) ? type : controller.type();
+  };
+
+  Movie::Info info;
+  info.md5 = props.get(PropType::Cart_MD5);
+  info.romFile = myOSystem.romFile().getPath();
+  info.cartType = console.cartridge().detectedType();
+  info.leftType = controllerType(console.leftController());
+  info.leftJack = console.leftController().jack();
+  info.rightType = controllerType(console.rightController());
+  info.rightJack = console.rightController().jack();
+  info.swapPaddles = props.get(PropType::Controller_SwapPaddles) == "YES";
+  info.timing = console.timing();
+  info.layout = console.tia().frameLayout();
+  info.startCycles = console.system().cycles();
+  info.checksumInterval = std::max(settings.getInt("moviechecksum"), 0);
+  info.paddleXCenter = BSPF::stringToInt(props.get(PropType::Controller_PaddlesXCenter));
+  info.paddleYCenter = BSPF::stringToInt(props.get(PropType::Controller_PaddlesYCenter));
+
+  // The range follows the mode of the mouse axis property (see MouseControl)
+  istringstream mouseAxis(props.get(PropType::Controller_MouseAxis));
+  string axisMode;
+  if(!(mouseAxis >> axisMode >> info.paddleRange))
+    info.paddleRange = 100;
+
+  Serializer state;
+  if(console.save(state) &&
+     myMovie->create(myMovieFile, info, settings, state,
+                     myOSystem.eventHandler().event(), console.switches(),
+                     mouseMode(myOSystem)))
+    myOSystem.frameBuffer().showTextMessage("Movie recording started");
+  else
   {
-    myActiveMode = kOffMode;
-    myMovieReader.close();
-    return false;
+    myOSystem.frameBuffer().showTextMessage("Can't record movie to " + myMovieFile);
+    stopMovie();
   }
 }
-#endif
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::toggleTimeMachine()
 {
   bool devSettings = myOSystem.settings().getBool("dev.settings");
 
+  // The Time Machine replaces a movie recording
+  if(myActiveMode == Mode::MovieRecord)
+  {
+    stopMovie();
+    myActiveMode = Mode::Off;
+  }
+
   myActiveMode = myActiveMode == Mode::TimeMachine ? Mode::Off : Mode::TimeMachine;
   if(myActiveMode == Mode::TimeMachine)
     myOSystem.frameBuffer().showTextMessage("Time Machine enabled");
@@ -179,19 +220,24 @@ void StateManager::update()
       myRewindManager->addState("Time Machine", true);
       break;
 
-#if 0
     case Mode::MovieRecord:
-      myOSystem.console().controller(Controller::Jack::Left).save(myMovieWriter);
-      myOSystem.console().controller(Controller::Jack::Right).save(myMovieWriter);
-      myOSystem.console().switches().save(myMovieWriter);
+      // Frying and cheats are not recorded, so the movie must end before them
+      if(myOSystem.eventHandler().frying())
+        stopMovie("frying");
+      else if(cheatsEnabled(myOSystem))
+        stopMovie("cheats enabled");
+      else if(!myMovie->isRecording())
+        createMovie();
+      else if(!myMovie->record(myOSystem.console().system().cycles(),
+                               myOSystem.eventHandler().event(),
+                               myOSystem.console().switches(), mouseMode(myOSystem),
+                               myOSystem.console().system()))
+      {
+        myOSystem.frameBuffer().showTextMessage("Error writing movie");
+        stopMovie();
+      }
       break;
 
-    case Mode::MoviePlayback:
-      myOSystem.console().controller(Controller::Jack::Left).load(myMovieReader);
-      myOSystem.console().controller(Controller::Jack::Right).load(myMovieReader);
-      myOSystem.console().switches().load(myMovieReader);
-      break;
-#endif
     default:
       break;
   }
@@ -204,6 +250,9 @@ void StateManager::loadState(int slot)
   {
     if(slot < 0) slot = myCurrentSlot;
 
+    // A movie can't continue from another state
+    stopMovie();
+
     ostringstream buf;
     buf << myOSystem.stateDir()
         << myOSystem.console().properties().get(PropType::Cart_Name)
@@ -377,26 +426,24 @@ bool StateManager::saveState(Serializer& out)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::reset()
 {
+  stopMovie();
   myRewindManager->clear();
-  myActiveMode = myOSystem.settings().getBool(
-    myOSystem.settings().getBool("dev.settings") ? "dev.timemachine" : "plr.timemachine") ? Mode::TimeMachine : Mode::Off;
+  myRunAheadManager->setup();
+  myActiveMode = timeMachineMode();
 
-#if 0
-  myCurrentSlot = 0;
-
-  switch(myActiveMode)
+  // A movie given on the commandline records the next started console
+  const string movieFile = myOSystem.settings().getString("movie");
+  if(myOSystem.hasConsole() && !movieFile.empty())
   {
-    case kMovieRecordMode:
-      myMovieWriter.close();
-      break;
-
-    case kMoviePlaybackMode:
-      myMovieReader.close();
-      break;
-
-    default:
-      break;
+    startMovie(movieFile);
+    myOSystem.settings().setValue("movie", "");
   }
-  myActiveMode = kOffMode;
-#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateManager::Mode StateManager::timeMachineMode() const
+{
+  return myOSystem.settings().getBool(
+    myOSystem.settings().getBool("dev.settings") ? "dev.timemachine" : "plr.timemachine")
+    ? Mode::TimeMachine : Mode::Off;
 }
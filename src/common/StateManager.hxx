@@ -18,10 +18,12 @@
 #ifndef STATE_MANAGER_HXX
 #define STATE_MANAGER_HXX
 
-#define STATE_HEADER "06050300state"
+#define STATE_HEADER "06060000state"
 
 class OSystem;
+class Movie;
 class RewindManager;
+class RunAheadManager;
 
 #include "Serializer.hxx"
 
@@ -38,8 +40,7 @@ class StateManager
     enum class Mode {
       Off,
       TimeMachine,
-      MovieRecord,
-      MoviePlayback
+      MovieRecord
     };
 
     /**
@@ -54,12 +55,21 @@ class StateManager
     */
     Mode mode() const { return myActiveMode; }
 
-#if 0
     /**
-      Toggle movie recording mode (FIXME - currently disabled)
+      Start recording a movie into the given file; this uses the Movie class
+      for its functionality.  The recording begins with the next input poll,
+      the Time Machine is disabled meanwhile.
+
+      @param filename  The movie file to create
     */
-    void toggleRecordMode();
-#endif
+    void startMovie(const string& filename);
+
+    /**
+      Stop recording a movie (if any), and complete the movie file.
+
+      @param reason  Why the recording is stopped, if not by the user
+    */
+    void stopMovie(const string& reason = EmptyString);
 
     /**
       Toggle state rewind recording mode; this uses the RewindManager
@@ -69,9 +79,11 @@ class StateManager
 
     /**
       Sets state rewind recording mode; this uses the RewindManager
-      for its functionality.
+      for its functionality.  Ignored while a movie is recorded.
     */
-    void setRewindMode(Mode mode) { myActiveMode = mode; }
+    void setRewindMode(Mode mode) {
+      if(myActiveMode != Mode::MovieRecord)  myActiveMode = mode;
+    }
 
     /**
       Optionally adds one extra state when entering the Time Machine dialog;
@@ -160,6 +172,22 @@ class StateManager
     */
     RewindManager& rewindManager() const { return *myRewindManager; }
 
+    /**
+      The run-ahead facility for the state manager
+    */
+    RunAheadManager& runAheadManager() const { return *myRunAheadManager; }
+
+  private:
+    /**
+      The mode selected by the Time Machine settings.
+    */
+    Mode timeMachineMode() const;
+
+    /**
+      Create the movie file and write the initial state.
+    */
+    void createMovie();
+
   private:
     // The parent OSystem object
     OSystem& myOSystem;
@@ -170,16 +198,18 @@ class StateManager
     // Whether the manager is in record or playback mode
     Mode myActiveMode{Mode::Off};
 
-    // MD5 of the currently active ROM (either in movie or rewind mode)
-    string myMD5;
+    // The movie to record into when the next input is polled
+    string myMovieFile;
 
-    // Serializer classes used to save/load the eventstream
-    Serializer myMovieWriter;
-    Serializer myMovieReader;
+    // The movie currently recorded
+    unique_ptr<Movie> myMovie;
 
     // Stored savestates to be later rewound
     unique_ptr<RewindManager> myRewindManager;
 
+    // Runs the emulation ahead to hide input lag
+    unique_ptr<RunAheadManager> myRunAheadManager;
+
   private:
     // Following constructors and assignment operators not supported
     StateManager() = delete;
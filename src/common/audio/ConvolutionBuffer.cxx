@@ -17,29 +17,80 @@
 
 #include "ConvolutionBuffer.hxx"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define CONVOLUTION_SSE
+  #include <emmintrin.h>
+#endif
+
+namespace {
+  /**
+    Multiply the values pairwise and sum up the products separately for
+    the even and the odd indices ('length' must be even).
+  */
+  inline void dotProduct(const float* a, const float* b, uInt32 length,
+                         float& sumEven, float& sumOdd)
+  {
+    uInt32 i = 0;
+    sumEven = sumOdd = 0.F;
+
+  #ifdef CONVOLUTION_SSE
+    __m128 sum = _mm_setzero_ps();
+    for (; i + 4 <= length; i += 4)
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+
+    alignas(16) std::array<float, 4> sums;
+    _mm_store_ps(sums.data(), sum);
+    sumEven = sums[0] + sums[2];
+    sumOdd  = sums[1] + sums[3];
+  #endif
+
+    for (; i < length; i += 2) {
+      sumEven += a[i] * b[i];
+      sumOdd  += a[i + 1] * b[i + 1];
+    }
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-ConvolutionBuffer::ConvolutionBuffer(uInt32 size)
-  : myData{make_unique<float[]>(size)},
-    mySize{size}
+ConvolutionBuffer::ConvolutionBuffer(uInt32 size, bool stereo)
+  : myData{make_unique<float[]>(2 * size * (stereo ? 2 : 1))},
+    mySize{size},
+    myChannels{stereo ? 2U : 1U}
 {
-  std::fill_n(myData.get(), mySize, 0.F);
+  std::fill_n(myData.get(), 2 * mySize * myChannels, 0.F);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ConvolutionBuffer::shift(float nextValue)
 {
-  myData[myFirstIndex] = nextValue;
-  myFirstIndex = (myFirstIndex + 1) % mySize;
+  myData[myFirstIndex] = myData[myFirstIndex + mySize] = nextValue;
+  if (++myFirstIndex == mySize) myFirstIndex = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-float ConvolutionBuffer::convoluteWith(float* kernel) const
+void ConvolutionBuffer::shift(float nextValueL, float nextValueR)
 {
-  float result = 0.F;
+  const uInt32 index = 2 * myFirstIndex;
 
-  for (uInt32 i = 0; i < mySize; ++i) {
-    result += kernel[i] * myData[(myFirstIndex + i) % mySize];
-  }
+  myData[index]     = myData[index + 2 * mySize]     = nextValueL;
+  myData[index + 1] = myData[index + 2 * mySize + 1] = nextValueR;
+  if (++myFirstIndex == mySize) myFirstIndex = 0;
+}
 
-  return result;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+float ConvolutionBuffer::convoluteWith(const float* kernel) const
+{
+  float resultEven, resultOdd;
+
+  dotProduct(kernel, myData.get() + myFirstIndex, mySize & ~1U, resultEven, resultOdd);
+  if (mySize & 1)
+    resultEven += kernel[mySize - 1] * myData[myFirstIndex + mySize - 1];
+
+  return resultEven + resultOdd;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConvolutionBuffer::convoluteWith(const float* kernel, float& resultL, float& resultR) const
+{
+  dotProduct(kernel, myData.get() + 2 * myFirstIndex, 2 * mySize, resultL, resultR);
 }
@@ -20,15 +20,29 @@
 
 #include "bspf.hxx"
 
+/**
+  A ring buffer of the last 'size' samples, which can be convoluted with a
+  kernel of the same size.  The samples are stored twice in a row, so the
+  samples always are contiguous in memory, starting at the oldest one.
+  In stereo, the samples of both channels are stored interleaved.
+*/
 class ConvolutionBuffer
 {
   public:
 
-    explicit ConvolutionBuffer(uInt32 size);
+    explicit ConvolutionBuffer(uInt32 size, bool stereo = false);
 
     void shift(float nextValue);
 
-    float convoluteWith(float* kernel) const;
+    void shift(float nextValueL, float nextValueR);
+
+    float convoluteWith(const float* kernel) const;
+
+    /**
+      Convolute both channels; the kernel must contain each value twice
+      in a row (2 * size values in total).
+    */
+    void convoluteWith(const float* kernel, float& resultL, float& resultR) const;
 
   private:
 
@@ -38,6 +52,8 @@ class ConvolutionBuffer
 
     uInt32 mySize{0};
 
+    uInt32 myChannels{1};
+
   private:
 
     ConvolutionBuffer() = delete;
@@ -76,15 +76,15 @@ LanczosResampler::LanczosResampler(
   myHighPassR{HIGH_PASS_CUT_OFF, float(formatFrom.sampleRate)},
   myHighPass{HIGH_PASS_CUT_OFF, float(formatFrom.sampleRate)}
 {
-  myPrecomputedKernels = make_unique<float[]>(myPrecomputedKernelCount * myKernelSize);
+  // The kernels are spaced formatTo.sampleRate / myPrecomputedKernelCount
+  // apart on the time index scale, and so is formatFrom.sampleRate
+  myTimeStep = myFormatFrom.sampleRate /
+    (myFormatTo.sampleRate / myPrecomputedKernelCount);
 
-  if (myFormatFrom.stereo)
-  {
-    myBufferL = make_unique<ConvolutionBuffer>(myKernelSize);
-    myBufferR = make_unique<ConvolutionBuffer>(myKernelSize);
-  }
-  else
-    myBuffer = make_unique<ConvolutionBuffer>(myKernelSize);
+  myKernelStride = myFormatFrom.stereo ? 2 * myKernelSize : myKernelSize;
+  myPrecomputedKernels = make_unique<float[]>(myPrecomputedKernelCount * myKernelStride);
+
+  myBuffer = make_unique<ConvolutionBuffer>(myKernelSize, myFormatFrom.stereo);
 
   precomputeKernels();
 }
@@ -94,17 +94,24 @@ void LanczosResampler::precomputeKernels()
 {
   // timeIndex = time * formatFrom.sampleRate * formatTo.sampleRAte
   uInt32 timeIndex = 0;
+  const uInt32 timeUnit = myFormatTo.sampleRate / myPrecomputedKernelCount;
 
   for (uInt32 i = 0; i < myPrecomputedKernelCount; ++i) {
-    float* kernel = myPrecomputedKernels.get() + myKernelSize * i;
+    // Kernels are stored by time index, see myTimeIndex
+    float* kernel = myPrecomputedKernels.get() + myKernelStride * (timeIndex / timeUnit);
     // The kernel is normalized such to be evaluate on time * formatFrom.sampleRate
     float center =
       static_cast<float>(timeIndex) / static_cast<float>(myFormatTo.sampleRate);
 
     for (uInt32 j = 0; j < 2 * myKernelParameter; ++j) {
-      kernel[j] = lanczosKernel(
+      const float value = lanczosKernel(
           center - static_cast<float>(j) + static_cast<float>(myKernelParameter) - 1.F, myKernelParameter
         ) * CLIPPING_FACTOR;
+
+      if (myFormatFrom.stereo)
+        kernel[2*j] = kernel[2*j + 1] = value;
+      else
+        kernel[j] = value;
     }
 
     // Next step: time += 1 / formatTo.sampleRate
@@ -143,12 +150,11 @@ void LanczosResampler::fillFragment(float* fragment, uInt32 length)
   const uInt32 outputSamples = myFormatTo.stereo ? (length >> 1) : length;
 
   for (uInt32 i = 0; i < outputSamples; ++i) {
-    float* kernel = myPrecomputedKernels.get() + (myCurrentKernelIndex * myKernelSize);
-    myCurrentKernelIndex = (myCurrentKernelIndex + 1) % myPrecomputedKernelCount;
+    const float* kernel = myPrecomputedKernels.get() + (myTimeIndex * myKernelStride);
 
     if (myFormatFrom.stereo) {
-      float sampleL = myBufferL->convoluteWith(kernel);
-      float sampleR = myBufferR->convoluteWith(kernel);
+      float sampleL, sampleR;
+      myBuffer->convoluteWith(kernel, sampleL, sampleR);
 
       if (myFormatTo.stereo) {
         fragment[2*i] = sampleL;
@@ -165,12 +171,12 @@ void LanczosResampler::fillFragment(float* fragment, uInt32 length)
         fragment[i] = sample;
     }
 
-    myTimeIndex += myFormatFrom.sampleRate;
+    myTimeIndex += nextTimeStep();
 
-    uInt32 samplesToShift = myTimeIndex / myFormatTo.sampleRate;
+    uInt32 samplesToShift = myTimeIndex / myPrecomputedKernelCount;
     if (samplesToShift == 0) continue;
 
-    myTimeIndex %= myFormatTo.sampleRate;
+    myTimeIndex %= myPrecomputedKernelCount;
     shiftSamples(samplesToShift);
   }
 }
@@ -179,10 +185,11 @@ void LanczosResampler::fillFragment(float* fragment, uInt32 length)
 inline void LanczosResampler::shiftSamples(uInt32 samplesToShift)
 {
   while (samplesToShift-- > 0) {
-    if (myFormatFrom.stereo) {
-      myBufferL->shift(myHighPassL.apply(myCurrentFragment[2*myFragmentIndex] / static_cast<float>(0x7fff)));
-      myBufferR->shift(myHighPassR.apply(myCurrentFragment[2*myFragmentIndex + 1] / static_cast<float>(0x7fff)));
-    }
+    if (myFormatFrom.stereo)
+      myBuffer->shift(
+        myHighPassL.apply(myCurrentFragment[2*myFragmentIndex] / static_cast<float>(0x7fff)),
+        myHighPassR.apply(myCurrentFragment[2*myFragmentIndex + 1] / static_cast<float>(0x7fff))
+      );
     else
       myBuffer->shift(myHighPass.apply(myCurrentFragment[myFragmentIndex] / static_cast<float>(0x7fff)));
 
@@ -45,14 +45,14 @@ class LanczosResampler : public Resampler
 
     uInt32 myPrecomputedKernelCount{0};
     uInt32 myKernelSize{0};
-    uInt32 myCurrentKernelIndex{0};
     unique_ptr<float[]> myPrecomputedKernels;
 
     uInt32 myKernelParameter{0};
 
+    // In stereo, both channels are stored interleaved in one buffer, and
+    // the kernels contain each value twice
     unique_ptr<ConvolutionBuffer> myBuffer;
-    unique_ptr<ConvolutionBuffer> myBufferL;
-    unique_ptr<ConvolutionBuffer> myBufferR;
+    uInt32 myKernelStride{0};
 
     Int16* myCurrentFragment{nullptr};
     uInt32 myFragmentIndex{0};
@@ -62,6 +62,8 @@ class LanczosResampler : public Resampler
     HighPass myHighPassR;
     HighPass myHighPass;
 
+    // The time index is measured in units of formatTo.sampleRate / (number of
+    // kernels), so it doubles as the index of the kernel to apply
     uInt32 myTimeIndex{0};
 };
 
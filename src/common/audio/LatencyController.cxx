@@ -0,0 +1,168 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "LatencyController.hxx"
+
+namespace {
+  // Seconds without underruns or overflows before latency is reduced
+  constexpr double STABLE_SECONDS = 10.;
+
+  // The stable period doubles (up to this factor) if a reduction fails
+  constexpr uInt32 MAX_STABLE_PERIOD_FACTOR = 16;
+
+  // Smoothing factor for the number of queued fragments (per fragment)
+  constexpr float QUEUE_SMOOTHING = 1.F / 64.F;
+
+  // Rate correction per fragment off target (proportional and integral
+  // part), and its maximum. 0.5% are about nine cents, which is not audible
+  // for the kind of drift we see. The integral part takes care of constant
+  // drift, which would otherwise leave the queue off target.
+  constexpr double RATE_GAIN = 0.002;
+  constexpr double RATE_INTEGRAL_GAIN = 0.000005;
+  constexpr double MAX_RATE_CORRECTION = 0.005;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+LatencyController::LatencyController(uInt32 prebufferFragments, uInt32 capacity,
+                                     uInt32 headroom, uInt32 bufferSize,
+                                     double fragmentsPerSecond, bool adaptive)
+  : myPrebufferFragments{prebufferFragments},
+    myCapacity{capacity},
+    myMaxHeadroom{headroom},
+    myMaxBufferSize{bufferSize},
+    myFragmentsPerSecond{fragmentsPerSecond},
+    myIsAdaptive{adaptive},
+    myHeadroom{headroom},
+    myBufferSize{bufferSize}
+{
+  myQueuedFragments = static_cast<float>(prebufferFragmentCount());
+  myMinQueuedFragments = capacity;
+  myStablePeriod = static_cast<uInt32>(STABLE_SECONDS * fragmentsPerSecond);
+
+  publish();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 LatencyController::excessFragments(uInt32 queuedFragments) const
+{
+  if (!myIsAdaptive) return 0;
+
+  const uInt32 limit = myCapacity - (myMaxBufferSize - myBufferSize);
+
+  return queuedFragments > limit ? queuedFragments - limit : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void LatencyController::fragmentDequeued(uInt32 queuedFragments, uInt32 overflows,
+                                         uInt32 dropped)
+{
+  myQueuedFragments +=
+    (static_cast<float>(queuedFragments) - myQueuedFragments) * QUEUE_SMOOTHING;
+  myMinQueuedFragments = std::min(myMinQueuedFragments, queuedFragments);
+
+  const uInt32 newOverflows = overflows - myLastOverflows + dropped;
+  myLastOverflows = overflows;
+
+  if (newOverflows > 0) {
+    myOverflows += newOverflows;
+    if (myIsAdaptive && myBufferSize < myMaxBufferSize) ++myBufferSize;
+
+    problem();
+  }
+  else if (++myStableFragments >= myStablePeriod) {
+    // Only cut the headroom if the queue never ran close to empty
+    if (myIsAdaptive) {
+      if (myHeadroom > 0 && myMinQueuedFragments > 1) {
+        --myHeadroom;
+        myIsReduced = true;
+      }
+      else if (myBufferSize > 0) {
+        --myBufferSize;
+        myIsReduced = true;
+      }
+    }
+
+    myStableFragments = 0;
+    myMinQueuedFragments = myCapacity;
+  }
+
+  if (myIsAdaptive) {
+    const double error =
+      static_cast<double>(myQueuedFragments) - prebufferFragmentCount();
+
+    myRateIntegral = BSPF::clamp(myRateIntegral + error * RATE_INTEGRAL_GAIN,
+                                 -MAX_RATE_CORRECTION, MAX_RATE_CORRECTION);
+    myRateFactor = 1. + BSPF::clamp(error * RATE_GAIN + myRateIntegral,
+                                    -MAX_RATE_CORRECTION, MAX_RATE_CORRECTION);
+  }
+
+  publish();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void LatencyController::underrun()
+{
+  ++myUnderruns;
+  if (myIsAdaptive && myHeadroom < myMaxHeadroom) ++myHeadroom;
+
+  problem();
+  publish();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void LatencyController::problem()
+{
+  // If the last reduction caused the problem, wait longer for the next one
+  if (myIsReduced && myStablePeriod <
+      MAX_STABLE_PERIOD_FACTOR * static_cast<uInt32>(STABLE_SECONDS * myFragmentsPerSecond))
+    myStablePeriod *= 2;
+
+  myIsReduced = false;
+  myStableFragments = 0;
+  myMinQueuedFragments = myCapacity;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void LatencyController::publish()
+{
+  myStatUnderruns.store(myUnderruns, std::memory_order_relaxed);
+  myStatOverflows.store(myOverflows, std::memory_order_relaxed);
+  myStatHeadroom.store(myHeadroom, std::memory_order_relaxed);
+  myStatBufferSize.store(myBufferSize, std::memory_order_relaxed);
+  myStatQueuedFragments.store(myQueuedFragments, std::memory_order_relaxed);
+  myStatRateFactor.store(static_cast<float>(myRateFactor), std::memory_order_relaxed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+LatencyController::Statistics LatencyController::statistics() const
+{
+  Statistics stats;
+
+  stats.underruns = myStatUnderruns.load(std::memory_order_relaxed);
+  stats.overflows = myStatOverflows.load(std::memory_order_relaxed);
+  stats.headroom = myStatHeadroom.load(std::memory_order_relaxed);
+  stats.bufferSize = myStatBufferSize.load(std::memory_order_relaxed);
+  stats.queuedFragments = myStatQueuedFragments.load(std::memory_order_relaxed);
+  stats.latency = static_cast<float>(
+    1000. * static_cast<double>(stats.queuedFragments) / myFragmentsPerSecond);
+  stats.rateCorrection =
+    100.F * (myStatRateFactor.load(std::memory_order_relaxed) - 1.F);
+  stats.adaptive = myIsAdaptive;
+
+  return stats;
+}
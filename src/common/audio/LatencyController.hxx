@@ -0,0 +1,162 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef LATENCY_CONTROLLER_HXX
+#define LATENCY_CONTROLLER_HXX
+
+#include <atomic>
+
+#include "bspf.hxx"
+
+/**
+  This class keeps track of the state of the audio queue as seen by the sound
+  driver: the number of queued fragments, underruns and overflows.
+
+  In adaptive mode, it also tunes the latency at runtime. Headroom and buffer
+  size start out at the configured values, which act as upper bounds. Each
+  underrun increases the headroom and each overflow increases the buffer
+  size, while a period without problems decreases them again. The resampling
+  rate is nudged up or down in order to keep the queue at its target
+  fill level, so the emulation and audio clocks can't drift apart.
+
+  All methods except statistics() must be called from the audio thread.
+*/
+class LatencyController
+{
+  public:
+
+    struct Statistics {
+      uInt32 underruns{0};
+      uInt32 overflows{0};
+      float queuedFragments{0.F};
+      float latency{0.F};         // in ms
+      uInt32 headroom{0};
+      uInt32 bufferSize{0};
+      float rateCorrection{0.F};  // in percent
+      bool adaptive{false};
+    };
+
+  public:
+
+    /**
+      Create a new controller.
+
+      @param prebufferFragments  The fragments to prebuffer after an underrun,
+                                 not including the headroom
+      @param capacity            The capacity of the audio queue
+      @param headroom            The configured headroom (in fragments)
+      @param bufferSize          The configured buffer size (in fragments)
+      @param fragmentsPerSecond  The rate at which fragments are played
+      @param adaptive            Adapt headroom, buffer size and rate?
+     */
+    LatencyController(uInt32 prebufferFragments, uInt32 capacity,
+                      uInt32 headroom, uInt32 bufferSize,
+                      double fragmentsPerSecond, bool adaptive);
+
+    /**
+      The number of queued fragments required to resume after an underrun.
+     */
+    uInt32 prebufferFragmentCount() const {
+      return myPrebufferFragments + myHeadroom;
+    }
+
+    /**
+      The number of queued fragments exceeding the current buffer size. These
+      should be dropped in order to get back to the target latency.
+
+      @param queuedFragments  The number of fragments currently queued
+     */
+    uInt32 excessFragments(uInt32 queuedFragments) const;
+
+    /**
+      Update after a fragment has been taken from the queue.
+
+      @param queuedFragments  The number of fragments queued before dequeueing
+      @param overflows        The total number of overflows of the queue
+      @param dropped          The number of excess fragments dropped
+     */
+    void fragmentDequeued(uInt32 queuedFragments, uInt32 overflows, uInt32 dropped);
+
+    /**
+      Update after the queue has run empty.
+     */
+    void underrun();
+
+    /**
+      The factor to apply to the resampling rate.
+     */
+    double rateFactor() const { return myRateFactor; }
+
+    /**
+      Get the statistics. This may be called from any thread.
+     */
+    Statistics statistics() const;
+
+  private:
+
+    void problem();
+
+    void publish();
+
+  private:
+
+    uInt32 myPrebufferFragments{0};
+    uInt32 myCapacity{0};
+    uInt32 myMaxHeadroom{0};
+    uInt32 myMaxBufferSize{0};
+    double myFragmentsPerSecond{0.};
+    bool myIsAdaptive{false};
+
+    uInt32 myHeadroom{0};
+    uInt32 myBufferSize{0};
+
+    // Smoothed and minimum number of queued fragments
+    float myQueuedFragments{0.F};
+    uInt32 myMinQueuedFragments{0};
+
+    // Fragments played without problems, and the number required before
+    // latency is reduced. The latter grows if a reduction doesn't work out.
+    uInt32 myStableFragments{0};
+    uInt32 myStablePeriod{0};
+    bool myIsReduced{false};
+
+    uInt32 myLastOverflows{0};
+    uInt32 myUnderruns{0};
+    uInt32 myOverflows{0};
+
+    double myRateIntegral{0.};
+    double myRateFactor{1.};
+
+    // Statistics, published for other threads
+    std::atomic<uInt32> myStatUnderruns{0};
+    std::atomic<uInt32> myStatOverflows{0};
+    std::atomic<uInt32> myStatHeadroom{0};
+    std::atomic<uInt32> myStatBufferSize{0};
+    std::atomic<float> myStatQueuedFragments{0.F};
+    std::atomic<float> myStatRateFactor{1.F};
+
+  private:
+
+    LatencyController() = delete;
+    LatencyController(const LatencyController&) = delete;
+    LatencyController(LatencyController&&) = delete;
+    LatencyController& operator=(const LatencyController&) = delete;
+    LatencyController& operator=(LatencyController&&) = delete;
+};
+
+#endif // LATENCY_CONTROLLER_HXX
@@ -18,6 +18,7 @@
 #ifndef RESAMPLER_HXX
 #define RESAMPLER_HXX
 
+#include <cmath>
 #include <functional>
 
 #include "bspf.hxx"
@@ -59,8 +60,36 @@ class Resampler {
 
     virtual void fillFragment(float* fragment, uInt32 length) = 0;
 
+    /**
+      Consume input samples faster (factor > 1) or slower (factor < 1) than
+      the nominal input sample rate. This is used to compensate for drift
+      between the emulation and the audio device, so the factor is expected
+      to be very close to 1.
+     */
+    void setRateFactor(double factor) {
+      myRateCorrection = static_cast<Int32>(
+        std::lround((factor - 1.) * static_cast<double>(myTimeStep) * 0x10000));
+    }
+
     virtual ~Resampler() = default;
 
+  protected:
+
+    /**
+      The step by which the time index advances for each output sample. The
+      rate correction is a fraction of a step unit, so it is dithered over
+      subsequent samples.
+     */
+    uInt32 nextTimeStep() {
+      if (myRateCorrection == 0) return myTimeStep;
+
+      myRateError += myRateCorrection;
+      const Int32 delta = myRateError >> 16;
+      myRateError &= 0xffff;
+
+      return static_cast<uInt32>(static_cast<Int32>(myTimeStep) + delta);
+    }
+
   protected:
 
     Format myFormatFrom;
@@ -70,6 +99,15 @@ class Resampler {
 
     StaggeredLogger myUnderrunLogger;
 
+    // The nominal time step, in units chosen by the implementation
+    uInt32 myTimeStep{0};
+
+  private:
+
+    // Rate correction and accumulated dithering error, in 1/65536 step units
+    Int32 myRateCorrection{0};
+    Int32 myRateError{0};
+
   private:
 
     Resampler() = delete;
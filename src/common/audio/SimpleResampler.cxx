@@ -24,6 +24,7 @@ SimpleResampler::SimpleResampler(
   const Resampler::NextFragmentCallback& nextFragmentCallback)
   : Resampler(formatFrom, formatTo, nextFragmentCallback)
 {
+  myTimeStep = myFormatFrom.sampleRate;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -68,7 +69,7 @@ void SimpleResampler::fillFragment(float* fragment, uInt32 length)
     }
 
     // time += 1 / myFormatTo.sampleRate
-    myTimeIndex += myFormatFrom.sampleRate;
+    myTimeIndex += nextTimeStep();
 
     // time >= 1 / myFormatFrom.sampleRate
     if (myTimeIndex >= myFormatTo.sampleRate) {
@@ -4,6 +4,7 @@ MODULE_OBJS := \
 	src/common/audio/SimpleResampler.o \
 	src/common/audio/ConvolutionBuffer.o \
 	src/common/audio/LanczosResampler.o \
+	src/common/audio/LatencyController.o \
 	src/common/audio/HighPass.o
 
 MODULE_DIRS += \
@@ -9,19 +9,23 @@ MODULE_OBJS := \
 	src/common/FBSurfaceSDL2.o \
 	src/common/FpsMeter.o \
 	src/common/FSNodeZIP.o \
+	src/common/HashManager.o \
 	src/common/HighScoresManager.o \
+	src/common/IncrementalSnapshot.o \
 	src/common/JoyMap.o \
 	src/common/KeyMap.o \
 	src/common/Logger.o \
 	src/common/main.o \
 	src/common/MouseControl.o \
 	src/common/PaletteHandler.o \
+	src/common/PerfStats.o \
 	src/common/PhosphorHandler.o \
 	src/common/PhysicalJoystick.o \
 	src/common/PJoystickHandler.o \
 	src/common/PKeyboardHandler.o \
 	src/common/PNGLibrary.o \
 	src/common/RewindManager.o \
+	src/common/RunAheadManager.o \
 	src/common/SoundSDL2.o \
 	src/common/StaggeredLogger.o \
 	src/common/StateManager.o \
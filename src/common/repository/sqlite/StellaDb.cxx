@@ -64,6 +64,10 @@ void StellaDb::initialize()
     highscoreRepository->initialize();
     myHighscoreRepository = std::move(highscoreRepository);
 
+    auto hashCacheRepository = make_unique<KeyValueRepositorySqlite>(*myDb, "md5cache", "path", "md5_data");
+    hashCacheRepository->initialize();
+    myHashCacheRepository = std::move(hashCacheRepository);
+
     myPropertyRepository = make_unique<CompositeKVRJsonAdapter>(*myPropertyRepositoryHost);
 
     if (myDb->getUserVersion() == 0) {
@@ -78,6 +82,7 @@ void StellaDb::initialize()
     mySettingsRepository = make_unique<KeyValueRepositoryNoop>();
     myPropertyRepository = make_unique<CompositeKeyValueRepositoryNoop>();
     myHighscoreRepository = make_unique<CompositeKeyValueRepositoryNoop>();
+    myHashCacheRepository = make_unique<KeyValueRepositoryNoop>();
 
     myDb.reset();
     myPropertyRepositoryHost.reset();
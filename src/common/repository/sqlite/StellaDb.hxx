@@ -35,6 +35,7 @@ class StellaDb
     KeyValueRepositoryAtomic& settingsRepository() const { return *mySettingsRepository; }
     CompositeKeyValueRepository& propertyRepository() const { return *myPropertyRepository; }
     CompositeKeyValueRepositoryAtomic& highscoreRepository() const { return *myHighscoreRepository; }
+    KeyValueRepositoryAtomic& hashCacheRepository() const { return *myHashCacheRepository; }
 
     const string databaseFileName() const;
 
@@ -60,6 +61,7 @@ class StellaDb
     unique_ptr<KeyValueRepositoryAtomic> myPropertyRepositoryHost;
     unique_ptr<CompositeKeyValueRepository> myPropertyRepository;
     unique_ptr<CompositeKeyValueRepositoryAtomic> myHighscoreRepository;
+    unique_ptr<KeyValueRepositoryAtomic> myHashCacheRepository;
 };
 
 #endif // STELLA_DB_HXX
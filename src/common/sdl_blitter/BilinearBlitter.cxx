@@ -79,18 +79,30 @@ void BilinearBlitter::free()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void BilinearBlitter::blit(SDL_Surface& surface)
+void BilinearBlitter::blit(SDL_Surface& surface, const DirtyRows& dirtyRows)
 {
   ASSERT_MAIN_THREAD;
 
+  // Newly created textures have to be updated completely
+  const bool recreated = !myTexturesAreAllocated || myRecreateTextures;
+
   recreateTexturesIfNecessary();
 
   SDL_Texture* texture = myTexture;
 
   if(myStaticData == nullptr) {
-    SDL_UpdateTexture(myTexture, &mySrcRect, surface.pixels, surface.pitch);
-    myTexture = mySecondaryTexture;
-    mySecondaryTexture = texture;
+    if(recreated)
+      for(auto& rows: myPendingRows)
+        rows.assign(dirtyRows.size(), true);
+
+    if(addDirtyRows(myPendingRows, dirtyRows) || recreated) {
+      updateTexture(myTexture, mySrcRect, surface, myPendingRows[0]);
+      myTexture = mySecondaryTexture;
+      mySecondaryTexture = texture;
+      std::swap(myPendingRows[0], myPendingRows[1]);
+    }
+    else
+      texture = mySecondaryTexture;  // the most recently updated one
   }
 
   SDL_RenderCopy(myFB.renderer(), texture, &mySrcRect, &myDstRect);
@@ -38,7 +38,7 @@ class BilinearBlitter : public Blitter {
       SDL_Surface* staticData = nullptr
     ) override;
 
-    virtual void blit(SDL_Surface& surface) override;
+    virtual void blit(SDL_Surface& surface, const DirtyRows& dirtyRows) override;
 
   private:
     FBBackendSDL2& myFB;
@@ -54,6 +54,10 @@ class BilinearBlitter : public Blitter {
 
     SDL_Surface* myStaticData{nullptr};
 
+    // The rows which must still be uploaded to the (primary and secondary)
+    // source textures
+    std::array<DirtyRows, 2> myPendingRows;
+
   private:
 
     void free();
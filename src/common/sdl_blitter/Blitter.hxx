@@ -35,12 +35,81 @@ class Blitter {
       SDL_Surface* staticData = nullptr
     ) = 0;
 
-    virtual void blit(SDL_Surface& surface) = 0;
+    // One entry per row of the surface, true if the row has changed
+    using DirtyRows = std::vector<bool>;
+
+    /**
+      Draw the surface.  Only the rows changed since the last blit must be
+      uploaded; if no row changed, the previously uploaded texture may be
+      reused.
+    */
+    virtual void blit(SDL_Surface& surface, const DirtyRows& dirtyRows) = 0;
 
   protected:
 
     Blitter() = default;
 
+    /**
+      The blitters alternate between two textures, so each texture has to
+      be updated with the rows changed since it was updated last.  This adds
+      the rows changed since the last blit to the pending rows of both
+      textures, and returns whether any rows changed at all.
+    */
+    static bool addDirtyRows(std::array<DirtyRows, 2>& pendingRows,
+                             const DirtyRows& dirtyRows)
+    {
+      bool changed = false;
+
+      for(auto& rows: pendingRows)
+      {
+        // A resized surface has to be updated completely
+        if(rows.size() != dirtyRows.size())
+        {
+          rows.assign(dirtyRows.size(), true);
+          changed = true;
+        }
+      }
+      for(size_t y = 0; y < dirtyRows.size(); ++y)
+      {
+        if(dirtyRows[y])
+        {
+          pendingRows[0][y] = pendingRows[1][y] = true;
+          changed = true;
+        }
+      }
+      return changed;
+    }
+
+    /**
+      Upload the pending rows of the surface into the texture, merging
+      adjacent rows into one update.  The pending rows are cleared.
+    */
+    static void updateTexture(SDL_Texture* texture, const SDL_Rect& srcRect,
+                              const SDL_Surface& surface, DirtyRows& pendingRows)
+    {
+      const size_t height = std::min<size_t>(srcRect.h, pendingRows.size());
+
+      for(size_t y = 0; y < height; )
+      {
+        if(!pendingRows[y])
+        {
+          ++y;
+          continue;
+        }
+        size_t end = y + 1;
+        while(end < height && pendingRows[end])
+          ++end;
+
+        const SDL_Rect rect{srcRect.x, srcRect.y + static_cast<int>(y),
+                            srcRect.w, static_cast<int>(end - y)};
+        SDL_UpdateTexture(texture, &rect,
+            static_cast<const uInt8*>(surface.pixels) + y * surface.pitch,
+            surface.pitch);
+        y = end;
+      }
+      pendingRows.assign(pendingRows.size(), false);
+    }
+
   private:
 
     Blitter(const Blitter&) = delete;
@@ -88,25 +88,37 @@ void QisBlitter::free()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void QisBlitter::blit(SDL_Surface& surface)
+void QisBlitter::blit(SDL_Surface& surface, const DirtyRows& dirtyRows)
 {
   ASSERT_MAIN_THREAD;
 
+  // Newly created textures have to be updated completely
+  const bool recreated = !myTexturesAreAllocated || myRecreateTextures;
+
   recreateTexturesIfNecessary();
 
   SDL_Texture* intermediateTexture = myIntermediateTexture;
 
   if(myStaticData == nullptr) {
-    SDL_UpdateTexture(mySrcTexture, &mySrcRect, surface.pixels, surface.pitch);
+    if(recreated)
+      for(auto& rows: myPendingRows)
+        rows.assign(dirtyRows.size(), true);
 
-    blitToIntermediate();
+    if(addDirtyRows(myPendingRows, dirtyRows) || recreated) {
+      updateTexture(mySrcTexture, mySrcRect, surface, myPendingRows[0]);
 
-    myIntermediateTexture = mySecondaryIntermedateTexture;
-    mySecondaryIntermedateTexture = intermediateTexture;
+      blitToIntermediate();
 
-    SDL_Texture* temporary = mySrcTexture;
-    mySrcTexture = mySecondarySrcTexture;
-    mySecondarySrcTexture = temporary;
+      myIntermediateTexture = mySecondaryIntermedateTexture;
+      mySecondaryIntermedateTexture = intermediateTexture;
+
+      SDL_Texture* temporary = mySrcTexture;
+      mySrcTexture = mySecondarySrcTexture;
+      mySecondarySrcTexture = temporary;
+      std::swap(myPendingRows[0], myPendingRows[1]);
+    }
+    else
+      intermediateTexture = mySecondaryIntermedateTexture;  // the most recently updated one
   }
 
   SDL_RenderCopy(myFB.renderer(), intermediateTexture, &myIntermediateRect, &myDstRect);
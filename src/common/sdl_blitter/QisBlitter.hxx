@@ -40,7 +40,7 @@ class QisBlitter : public Blitter {
       SDL_Surface* staticData = nullptr
     ) override;
 
-    virtual void blit(SDL_Surface& surface) override;
+    virtual void blit(SDL_Surface& surface, const DirtyRows& dirtyRows) override;
 
   private:
 
@@ -59,6 +59,10 @@ class QisBlitter : public Blitter {
 
     SDL_Surface* myStaticData{nullptr};
 
+    // The rows which must still be uploaded to the (primary and secondary)
+    // source textures
+    std::array<DirtyRows, 2> myPendingRows;
+
   private:
 
     void free();
@@ -19,6 +19,47 @@
 #include "AtariNTSC.hxx"
 #include "PhosphorHandler.hxx"
 
+// SSE2 is always available on x86-64, so no runtime detection is required
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define ATARI_NTSC_SSE2
+  #include <emmintrin.h>
+
+  // Generates four pixels at once, same as ATARI_NTSC_RGB_OUT_8888 for
+  // pixels index to index + 3
+  #define ATARI_NTSC_RGB_OUT_8888_X4( index, rgb_out ) {\
+    __m128i raw_ = _mm_add_epi32(\
+      _mm_add_epi32(atariNTSCLoad(kernel0 + (index)),\
+                    atariNTSCLoad(kernel1 + ((index)+10)%7+14)),\
+      _mm_add_epi32(atariNTSCLoad(kernelx0 + ((index)+7)%14),\
+                    atariNTSCLoad(kernelx1 + ((index)+3)%7+14+7)));\
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb_out), atariNTSCPack(raw_,\
+      atari_ntsc_clamp_mask, atari_ntsc_clamp_add));\
+  }
+
+namespace {
+  inline __m128i atariNTSCLoad(const uInt32* kernel)
+  {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(kernel));
+  }
+
+  // Vector version of ATARI_NTSC_CLAMP (shift = 0) plus the 8888 packing
+  inline __m128i atariNTSCPack(__m128i raw, uInt32 clampMask, uInt32 clampAdd)
+  {
+    const __m128i sub = _mm_and_si128(_mm_srli_epi32(raw, 9),
+      _mm_set1_epi32(clampMask));
+    __m128i clamp = _mm_sub_epi32(_mm_set1_epi32(clampAdd), sub);
+    raw = _mm_or_si128(raw, clamp);
+    clamp = _mm_sub_epi32(clamp, sub);
+    raw = _mm_and_si128(raw, clamp);
+
+    return _mm_or_si128(_mm_or_si128(
+      _mm_and_si128(_mm_srli_epi32(raw, 5), _mm_set1_epi32(0x00FF0000)),
+      _mm_and_si128(_mm_srli_epi32(raw, 3), _mm_set1_epi32(0x0000FF00))),
+      _mm_and_si128(_mm_srli_epi32(raw, 1), _mm_set1_epi32(0x000000FF)));
+  }
+} // namespace
+#endif
+
 // blitter related
 #ifndef restrict
   #if defined (__GNUC__)
@@ -80,22 +121,74 @@ void AtariNTSC::generateKernels()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void AtariNTSC::enableThreading(bool enable)
+void AtariNTSC::enableThreading(bool enable, uInt32 numThreads)
 {
-  uInt32 systemThreads = enable ? std::thread::hardware_concurrency() : 0;
-  if(systemThreads <= 1)
+  if(!enable)
+    numThreads = 1;
+  else if(numThreads == 0)
   {
-    myWorkerThreads = 0;
-    myTotalThreads  = 1;
+    const uInt32 systemThreads = std::thread::hardware_concurrency();
+    numThreads = systemThreads <= 1 ? 1
+      : std::max<uInt32>(1, std::min<uInt32>(4, systemThreads - 1));
   }
   else
+    numThreads = std::min(numThreads, MAX_THREADS);
+
+  if(numThreads == myTotalThreads)
+    return;
+
+  stopThreads();
+
+  myWorkerThreads = numThreads - 1;
+  myTotalThreads  = numThreads;
+
+  startThreads(myWorkerThreads);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AtariNTSC::startThreads(uInt32 numWorkers)
+{
+  myQuitThreads = false;
+  myThreads.reserve(numWorkers);
+  for(uInt32 i = 0; i < numWorkers; ++i)
+    myThreads.emplace_back(&AtariNTSC::workerThread, this, myJobGeneration);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AtariNTSC::stopThreads()
+{
+  {
+    std::lock_guard<std::mutex> lock(myThreadMutex);
+    myQuitThreads = true;
+  }
+  myWakeupCondition.notify_all();
+
+  for(auto& thread: myThreads)
+    thread.join();
+  myThreads.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AtariNTSC::workerThread(uInt32 generation)
+{
+  std::unique_lock<std::mutex> lock(myThreadMutex);
+
+  while(true)
   {
-    systemThreads = std::max<uInt32>(1, std::min<uInt32>(4, systemThreads - 1));
+    // Sleep until there is a new frame to render (or we're told to quit)
+    myWakeupCondition.wait(lock, [&] {
+      return myQuitThreads || myJobGeneration != generation;
+    });
+    if(myQuitThreads)
+      return;
+    generation = myJobGeneration;
 
-    myWorkerThreads = systemThreads - 1;
-    myTotalThreads  = systemThreads;
+    lock.unlock();
+    renderBands();
+    lock.lock();
 
-    myThreads = make_unique<std::thread[]>(myWorkerThreads);  // NOLINT
+    if(--myBusyWorkers == 0)
+      myDoneCondition.notify_one();
   }
 }
 
@@ -103,22 +196,37 @@ void AtariNTSC::enableThreading(bool enable)
 void AtariNTSC::render(const uInt8* atari_in, const uInt32 in_width, const uInt32 in_height,
   void* rgb_out, const uInt32 out_pitch, uInt32* rgb_in)
 {
-  // Spawn the threads...
-  for(uInt32 i = 0; i < myWorkerThreads; ++i)
+  // Split the frame into bands of rows, which are picked up by whichever
+  // thread is available next
+  myJob.atari_in  = atari_in;
+  myJob.in_width  = in_width;
+  myJob.in_height = in_height;
+  myJob.rgb_out   = rgb_out;
+  myJob.out_pitch = out_pitch;
+  myJob.rgb_in    = rgb_in;
+  myJob.numBands  = myWorkerThreads > 0
+    ? std::min(in_height, myTotalThreads * bands_per_thread) : 1;
+  myNextBand = 0;
+
+  if(myWorkerThreads > 0)
   {
-    myThreads[i] = std::thread([=] {
-    rgb_in == nullptr ?
-      renderThread(atari_in, in_width, in_height, myTotalThreads, i+1, rgb_out, out_pitch) :
-      renderWithPhosphorThread(atari_in, in_width, in_height, myTotalThreads, i+1, rgb_in, rgb_out, out_pitch);
-    });
+    // Wake up the threads...
+    {
+      std::lock_guard<std::mutex> lock(myThreadMutex);
+      myBusyWorkers = myWorkerThreads;
+      ++myJobGeneration;
+    }
+    myWakeupCondition.notify_all();
+
+    // ...make the main thread busy too...
+    renderBands();
+
+    // ...and wait until they are done
+    std::unique_lock<std::mutex> lock(myThreadMutex);
+    myDoneCondition.wait(lock, [&] { return myBusyWorkers == 0; });
   }
-  // Make the main thread busy too
-  rgb_in == nullptr ?
-    renderThread(atari_in, in_width, in_height, myTotalThreads, 0, rgb_out, out_pitch) :
-    renderWithPhosphorThread(atari_in, in_width, in_height, myTotalThreads, 0, rgb_in, rgb_out, out_pitch);
-  // ...and make them join again
-  for(uInt32 i = 0; i < myWorkerThreads; ++i)
-    myThreads[i].join();
+  else
+    renderBands();
 
   // Copy phosphor values into out buffer
   if(rgb_in != nullptr)
@@ -126,13 +234,27 @@ void AtariNTSC::render(const uInt8* atari_in, const uInt32 in_width, const uInt3
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void AtariNTSC::renderThread(const uInt8* atari_in, const uInt32 in_width,
-  const uInt32 in_height, const uInt32 numThreads, const uInt32 threadNum,
+void AtariNTSC::renderBands()
+{
+  for(uInt32 band = myNextBand++; band < myJob.numBands; band = myNextBand++)
+  {
+    if(myJob.rgb_in == nullptr)
+      renderBand(myJob.atari_in, myJob.in_width, myJob.in_height,
+                 myJob.numBands, band, myJob.rgb_out, myJob.out_pitch);
+    else
+      renderWithPhosphorBand(myJob.atari_in, myJob.in_width, myJob.in_height,
+                             myJob.numBands, band, myJob.rgb_in, myJob.rgb_out, myJob.out_pitch);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AtariNTSC::renderBand(const uInt8* atari_in, const uInt32 in_width,
+  const uInt32 in_height, const uInt32 numBands, const uInt32 band,
   void* rgb_out, const uInt32 out_pitch)
 {
-  // Adapt parameters to thread number
-  const uInt32 yStart = in_height * threadNum / numThreads;
-  const uInt32 yEnd = in_height * (threadNum + 1) / numThreads;
+  // Adapt parameters to band number
+  const uInt32 yStart = in_height * band / numBands;
+  const uInt32 yEnd = in_height * (band + 1) / numBands;
   atari_in += in_width * yStart;
   rgb_out  = static_cast<char*>(rgb_out) + out_pitch * yStart;
 
@@ -140,59 +262,7 @@ void AtariNTSC::renderThread(const uInt8* atari_in, const uInt32 in_width,
 
   for(uInt32 y = yStart; y < yEnd; ++y)
   {
-    const uInt8* line_in = atari_in;
-    ATARI_NTSC_BEGIN_ROW(NTSC_black, line_in[0]);
-    uInt32* restrict line_out = static_cast<uInt32*>(rgb_out);
-    ++line_in;
-
-    // shift right by 2 pixel
-    line_out[0] = line_out[1] = 0;
-    line_out += 2;
-
-    for(uInt32 n = chunk_count; n; --n)
-    {
-      // order of input and output pixels must not be altered
-      ATARI_NTSC_COLOR_IN(0, line_in[0])
-      ATARI_NTSC_RGB_OUT_8888(0, line_out[0])
-      ATARI_NTSC_RGB_OUT_8888(1, line_out[1])
-      ATARI_NTSC_RGB_OUT_8888(2, line_out[2])
-      ATARI_NTSC_RGB_OUT_8888(3, line_out[3])
-
-      ATARI_NTSC_COLOR_IN(1, line_in[1])
-      ATARI_NTSC_RGB_OUT_8888(4, line_out[4])
-      ATARI_NTSC_RGB_OUT_8888(5, line_out[5])
-      ATARI_NTSC_RGB_OUT_8888(6, line_out[6])
-
-      line_in += 2;
-      line_out += 7;
-    }
-
-    // finish final pixels
-    ATARI_NTSC_COLOR_IN(0, line_in[0])
-    ATARI_NTSC_RGB_OUT_8888(0, line_out[0])
-    ATARI_NTSC_RGB_OUT_8888(1, line_out[1])
-    ATARI_NTSC_RGB_OUT_8888(2, line_out[2])
-    ATARI_NTSC_RGB_OUT_8888(3, line_out[3])
-
-    ATARI_NTSC_COLOR_IN(1, NTSC_black)
-    ATARI_NTSC_RGB_OUT_8888(4, line_out[4])
-    ATARI_NTSC_RGB_OUT_8888(5, line_out[5])
-    ATARI_NTSC_RGB_OUT_8888(6, line_out[6])
-
-    line_out += 7;
-
-    ATARI_NTSC_COLOR_IN(0, NTSC_black)
-    ATARI_NTSC_RGB_OUT_8888(0, line_out[0])
-    ATARI_NTSC_RGB_OUT_8888(1, line_out[1])
-    ATARI_NTSC_RGB_OUT_8888(2, line_out[2])
-    ATARI_NTSC_RGB_OUT_8888(3, line_out[3])
-
-    ATARI_NTSC_COLOR_IN(1, NTSC_black)
-    ATARI_NTSC_RGB_OUT_8888(4, line_out[4])
-#if 0
-    ATARI_NTSC_RGB_OUT_8888(5, line_out[5])
-    ATARI_NTSC_RGB_OUT_8888(6, line_out[6])
-#endif
+    renderRow(atari_in, chunk_count, static_cast<uInt32*>(rgb_out));
 
     atari_in += in_width;
     rgb_out = static_cast<char*>(rgb_out) + out_pitch;
@@ -200,13 +270,13 @@ void AtariNTSC::renderThread(const uInt8* atari_in, const uInt32 in_width,
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void AtariNTSC::renderWithPhosphorThread(const uInt8* atari_in, const uInt32 in_width,
-  const uInt32 in_height, const uInt32 numThreads, const uInt32 threadNum,
+void AtariNTSC::renderWithPhosphorBand(const uInt8* atari_in, const uInt32 in_width,
+  const uInt32 in_height, const uInt32 numBands, const uInt32 band,
   uInt32* rgb_in, void* rgb_out, const uInt32 out_pitch)
 {
-  // Adapt parameters to thread number
-  const uInt32 yStart = in_height * threadNum / numThreads;
-  const uInt32 yEnd = in_height * (threadNum + 1) / numThreads;
+  // Adapt parameters to band number
+  const uInt32 yStart = in_height * band / numBands;
+  const uInt32 yEnd = in_height * (band + 1) / numBands;
   uInt32 bufofs = AtariNTSC::outWidth(in_width) * yStart;
   uInt32* out = static_cast<uInt32*>(rgb_out);
   atari_in += in_width * yStart;
@@ -216,104 +286,84 @@ void AtariNTSC::renderWithPhosphorThread(const uInt8* atari_in, const uInt32 in_
 
   for(uInt32 y = yStart; y < yEnd; ++y)
   {
-    const uInt8* line_in = atari_in;
-    ATARI_NTSC_BEGIN_ROW(NTSC_black, line_in[0]);
-    uInt32* restrict line_out = static_cast<uInt32*>(rgb_out);
-    ++line_in;
+    renderRow(atari_in, chunk_count, static_cast<uInt32*>(rgb_out));
 
-    // shift right by 2 pixel
-    line_out[0] = line_out[1] = 0;
-    line_out += 2;
+    // Do phosphor mode (blend the resulting frames) and store back into
+    // displayed frame buffer (for next frame)
+    // Note: AtariNTSC::outWidth(kTIAW) == outPitch == 568
+    const uInt32 blendWidth = AtariNTSC::outWidth(in_width) / 8 * 8;
+    PhosphorHandler::blendRow(out + bufofs, rgb_in + bufofs, blendWidth);
+    bufofs += blendWidth;
 
-    for(uInt32 n = chunk_count; n; --n)
-    {
-      // order of input and output pixels must not be altered
-      ATARI_NTSC_COLOR_IN(0, line_in[0])
-      ATARI_NTSC_RGB_OUT_8888(0, line_out[0])
-      ATARI_NTSC_RGB_OUT_8888(1, line_out[1])
-      ATARI_NTSC_RGB_OUT_8888(2, line_out[2])
-      ATARI_NTSC_RGB_OUT_8888(3, line_out[3])
-
-      ATARI_NTSC_COLOR_IN(1, line_in[1])
-      ATARI_NTSC_RGB_OUT_8888(4, line_out[4])
-      ATARI_NTSC_RGB_OUT_8888(5, line_out[5])
-      ATARI_NTSC_RGB_OUT_8888(6, line_out[6])
-
-      line_in += 2;
-      line_out += 7;
-    }
+    atari_in += in_width;
+    rgb_out = static_cast<char*>(rgb_out) + out_pitch;
+  }
+}
 
-    // finish final pixels
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AtariNTSC::renderRow(const uInt8* line_in, const uInt32 chunk_count,
+  uInt32* restrict line_out) const
+{
+  ATARI_NTSC_BEGIN_ROW(NTSC_black, line_in[0]);
+  ++line_in;
+
+  // shift right by 2 pixel
+  line_out[0] = line_out[1] = 0;
+  line_out += 2;
+
+  for(uInt32 n = chunk_count; n; --n)
+  {
+    // order of input and output pixels must not be altered
     ATARI_NTSC_COLOR_IN(0, line_in[0])
+#ifdef ATARI_NTSC_SSE2
+    ATARI_NTSC_RGB_OUT_8888_X4(0, line_out)
+#else
     ATARI_NTSC_RGB_OUT_8888(0, line_out[0])
     ATARI_NTSC_RGB_OUT_8888(1, line_out[1])
     ATARI_NTSC_RGB_OUT_8888(2, line_out[2])
     ATARI_NTSC_RGB_OUT_8888(3, line_out[3])
+#endif
 
-    ATARI_NTSC_COLOR_IN(1, NTSC_black)
+    ATARI_NTSC_COLOR_IN(1, line_in[1])
+#ifdef ATARI_NTSC_SSE2
+    // the 4th pixel is garbage, and is overwritten by the next chunk
+    ATARI_NTSC_RGB_OUT_8888_X4(4, line_out + 4)
+#else
     ATARI_NTSC_RGB_OUT_8888(4, line_out[4])
     ATARI_NTSC_RGB_OUT_8888(5, line_out[5])
     ATARI_NTSC_RGB_OUT_8888(6, line_out[6])
+#endif
 
+    line_in += 2;
     line_out += 7;
+  }
 
-    ATARI_NTSC_COLOR_IN(0, NTSC_black)
-    ATARI_NTSC_RGB_OUT_8888(0, line_out[0])
-    ATARI_NTSC_RGB_OUT_8888(1, line_out[1])
-    ATARI_NTSC_RGB_OUT_8888(2, line_out[2])
-    ATARI_NTSC_RGB_OUT_8888(3, line_out[3])
+  // finish final pixels
+  ATARI_NTSC_COLOR_IN(0, line_in[0])
+  ATARI_NTSC_RGB_OUT_8888(0, line_out[0])
+  ATARI_NTSC_RGB_OUT_8888(1, line_out[1])
+  ATARI_NTSC_RGB_OUT_8888(2, line_out[2])
+  ATARI_NTSC_RGB_OUT_8888(3, line_out[3])
 
-    ATARI_NTSC_COLOR_IN(1, NTSC_black)
-    ATARI_NTSC_RGB_OUT_8888(4, line_out[4])
-#if 0
-    ATARI_NTSC_RGB_OUT_8888(5, line_out[5])
-    ATARI_NTSC_RGB_OUT_8888(6, line_out[6])
-#endif
+  ATARI_NTSC_COLOR_IN(1, NTSC_black)
+  ATARI_NTSC_RGB_OUT_8888(4, line_out[4])
+  ATARI_NTSC_RGB_OUT_8888(5, line_out[5])
+  ATARI_NTSC_RGB_OUT_8888(6, line_out[6])
 
-    // Do phosphor mode (blend the resulting frames)
-    // Note: The unrolled code assumed that AtariNTSC::outWidth(kTIAW) == outPitch == 565
-    // Now this got changed to 568 so the final 5 calculations got removed.
-    for (uInt32 x = AtariNTSC::outWidth(in_width) / 8; x; --x)
-    {
-      // Store back into displayed frame buffer (for next frame)
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-      rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-      ++bufofs;
-    }
-    // finish final 565 % 8 = 5 pixels
-    /*rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;
-    rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;
-    rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;
-    rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;
-    rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;*/
+  line_out += 7;
+
+  ATARI_NTSC_COLOR_IN(0, NTSC_black)
+  ATARI_NTSC_RGB_OUT_8888(0, line_out[0])
+  ATARI_NTSC_RGB_OUT_8888(1, line_out[1])
+  ATARI_NTSC_RGB_OUT_8888(2, line_out[2])
+  ATARI_NTSC_RGB_OUT_8888(3, line_out[3])
+
+  ATARI_NTSC_COLOR_IN(1, NTSC_black)
+  ATARI_NTSC_RGB_OUT_8888(4, line_out[4])
 #if 0
-    rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;
-    rgb_in[bufofs] = PhosphorHandler::getPixel(out[bufofs], rgb_in[bufofs]);
-    ++bufofs;
+  ATARI_NTSC_RGB_OUT_8888(5, line_out[5])
+  ATARI_NTSC_RGB_OUT_8888(6, line_out[6])
 #endif
-
-    atari_in += in_width;
-    rgb_out = static_cast<char*>(rgb_out) + out_pitch;
-  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
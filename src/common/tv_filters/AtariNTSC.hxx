@@ -40,7 +40,10 @@
 #ifndef ATARI_NTSC_HXX
 #define ATARI_NTSC_HXX
 
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 
 #include "FrameBufferConstants.hxx"
@@ -49,8 +52,12 @@
 class AtariNTSC
 {
   public:
+    // The maximum number of rendering threads (including the calling one)
+    static constexpr uInt32 MAX_THREADS = 16;
+
     // By default, threading is turned off and palette is blank
     AtariNTSC() { enableThreading(false); myRGBPalette.fill(0); }
+    ~AtariNTSC() { stopThreads(); }
 
     // Image parameters, ranging from -1.0 to 1.0. Actual internal values shown
     // in parenthesis and should remain fairly stable in future versions.
@@ -79,8 +86,11 @@ class AtariNTSC
     // Set palette for normal Blarrg mode
     void setPalette(const PaletteArray& palette);
 
-    // Set up threading
-    void enableThreading(bool enable);
+    // Set up threading; the rendering threads are kept running and woken
+    // up for each frame.  If numThreads is 0, the number of threads is
+    // derived from the number of available cores, otherwise it is limited
+    // to MAX_THREADS.
+    void enableThreading(bool enable, uInt32 numThreads = 0);
 
     // Filters one or more rows of pixels. Input pixels are 8-bit Atari
     // palette colors.
@@ -100,11 +110,22 @@ class AtariNTSC
     // Generate kernels from raw RGB palette
     void generateKernels();
 
-    // Threaded rendering
-    void renderThread(const uInt8* atari_in, const uInt32 in_width,
-      const uInt32 in_height, const uInt32 numThreads, const uInt32 threadNum, void* rgb_out, const uInt32 out_pitch);
-    void renderWithPhosphorThread(const uInt8* atari_in, const uInt32 in_width,
-      const uInt32 in_height, const uInt32 numThreads, const uInt32 threadNum, uInt32* rgb_in, void* rgb_out, const uInt32 out_pitch);
+    // Rendering thread management
+    void startThreads(uInt32 numWorkers);
+    void stopThreads();
+    void workerThread(uInt32 generation);
+
+    // Render bands of the current frame until none are left
+    void renderBands();
+
+    // Render one row of pixels
+    void renderRow(const uInt8* line_in, const uInt32 chunk_count, uInt32* line_out) const;
+
+    // Render one band of rows
+    void renderBand(const uInt8* atari_in, const uInt32 in_width,
+      const uInt32 in_height, const uInt32 numBands, const uInt32 band, void* rgb_out, const uInt32 out_pitch);
+    void renderWithPhosphorBand(const uInt8* atari_in, const uInt32 in_width,
+      const uInt32 in_height, const uInt32 numBands, const uInt32 band, uInt32* rgb_in, void* rgb_out, const uInt32 out_pitch);
 
   private:
     static constexpr Int32
@@ -148,11 +169,35 @@ class AtariNTSC
     std::array<uInt8, palette_size*3> myRGBPalette;
     BSPF::array2D<uInt32, palette_size, entry_size> myColorTable;
 
-    // Rendering threads
-    unique_ptr<std::thread[]> myThreads;  // NOLINT
+    // Each thread renders this many bands of rows per frame (on average);
+    // smaller bands balance the load better between the threads
+    static constexpr uInt32 bands_per_thread = 4;
+
+    // Rendering worker threads (the calling thread renders too)
+    std::vector<std::thread> myThreads;
     // Number of rendering and total threads
     uInt32 myWorkerThreads{0}, myTotalThreads{0};
 
+    // The frame currently being rendered
+    struct RenderJob
+    {
+      const uInt8* atari_in{nullptr};
+      uInt32 in_width{0}, in_height{0};
+      void* rgb_out{nullptr};
+      uInt32 out_pitch{0};
+      uInt32* rgb_in{nullptr};
+      uInt32 numBands{0};
+    };
+    RenderJob myJob;
+    // The next band of the current frame to be rendered
+    std::atomic<uInt32> myNextBand{0};
+
+    // Wake up the workers for a new frame, and wait until all are done
+    std::mutex myThreadMutex;
+    std::condition_variable myWakeupCondition, myDoneCondition;
+    uInt32 myJobGeneration{0}, myBusyWorkers{0};
+    bool myQuitThreads{false};
+
     struct init_t
     {
       std::array<float, burst_count * 6> to_rgb{0.F};
@@ -762,6 +762,9 @@ void Debugger::setStartState()
   // Lock the bus each time the debugger is entered, so we don't disturb anything
   lockSystem();
 
+  // Emulate with breakpoints, traps and access tracking while debugging
+  mySystem.m6502().setDebuggerActive(true);
+
   // Save initial state and add it to the rewind list (except when in currently rewinding)
   RewindManager& r = myOSystem.state().rewindManager();
   // avoid invalidating future states when entering the debugger e.g. during rewind
@@ -788,6 +791,8 @@ void Debugger::setQuitState()
   // sitting at a breakpoint/trap, this will get us past it.
   // Somehow this feels like a hack to me, but I don't know why
   mySystem.m6502().execute(1);
+
+  mySystem.m6502().setDebuggerActive(false);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -189,8 +189,13 @@ string TiaOutputWidget::getToolTip(const Common::Point& pos) const
   // limit to 274 lines (PAL default without scaling)
   const uInt32 yStart = height <= FrameManager::Metrics::baseHeightPAL
     ? 0 : (height - FrameManager::Metrics::baseHeightPAL) >> 1;
-  const Int32 i = idx.x + (yStart + idx.y) * instance().console().tia().width();
-  uInt8* tiaOutputBuffer = instance().console().tia().outputBuffer();
+  const uInt32 i = idx.x + (yStart + idx.y) * instance().console().tia().width();
+  uInt32 scanx, scany;
+  instance().console().tia().electronBeamPos(scanx, scany);
+  // Below the current beam position, the last frame is shown
+  uInt8* tiaOutputBuffer = i < instance().console().tia().width() * scany + scanx
+    ? instance().console().tia().outputBuffer()
+    : instance().console().tia().lastFrameBuffer();
   ostringstream buf;
 
   buf << _toolTipText
@@ -228,7 +233,10 @@ void TiaOutputWidget::drawWidget(bool hilite)
   uInt32 scanx, scany, scanoffset;
   bool visible = instance().console().tia().electronBeamPos(scanx, scany);
   scanoffset = width * scany + scanx;
+  // Above the current beam position, the frame being drawn is shown,
+  // below it the last completed frame (greyed out)
   uInt8* tiaOutputBuffer = instance().console().tia().outputBuffer();
+  uInt8* tiaLastFrameBuffer = instance().console().tia().lastFrameBuffer();
   const TIASurface& tiaSurface = instance().frameBuffer().tiaSurface();
 
   for(uInt32 y = 0, i = yStart * width; y < height; ++y)
@@ -237,7 +245,8 @@ void TiaOutputWidget::drawWidget(bool hilite)
     for(uInt32 x = 0; x < width; ++x, ++i)
     {
       uInt8 shift = i >= scanoffset ? 1 : 0;
-      uInt32 pixel = tiaSurface.mapIndexedPixel(tiaOutputBuffer[i], shift);
+      uInt32 pixel = tiaSurface.mapIndexedPixel(
+          shift ? tiaLastFrameBuffer[i] : tiaOutputBuffer[i], shift);
       *line_ptr++ = pixel;
       *line_ptr++ = pixel;
     }
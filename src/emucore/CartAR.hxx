@@ -228,7 +228,7 @@ class CartridgeAR : public Cartridge
     uInt16 myCurrentBank{0};
 
     // Fake SC-BIOS code to simulate the Supercharger load bars
-    static std::array<uInt8, 294> ourDummyROMCode;
+    static const std::array<uInt8, 294> ourDummyROMCode;
 
     // Default 256-byte header to use if one isn't included in the ROM
     // This data comes from z26
@@ -343,17 +343,35 @@ string Console::formatFromFilename() const
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Console::save(Serializer& out) const
+{
+  return saveState(*mySystem, *this, out);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Console::load(Serializer& in)
+{
+  return loadState(*mySystem, *this, in);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Console::saveState(const System& system, const ConsoleIO& io,
+                        Serializer& out, const SaveHook& hook)
 {
   try
   {
     // First save state for the system
-    if(!mySystem->save(out))
+    if(!system.save(out, hook))
       return false;
 
     // Now save the console controllers and switches
-    if(!(myLeftControl->save(out) && myRightControl->save(out) &&
-         mySwitches->save(out)))
-      return false;
+    for(const Serializable* device: std::initializer_list<const Serializable*>{
+        &io.leftController(), &io.rightController(), &io.switches()})
+    {
+      if(hook)
+        hook();
+      if(!device->save(out))
+        return false;
+    }
   }
   catch(...)
   {
@@ -365,17 +383,17 @@ bool Console::save(Serializer& out) const
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Console::load(Serializer& in)
+bool Console::loadState(System& system, const ConsoleIO& io, Serializer& in)
 {
   try
   {
     // First load state for the system
-    if(!mySystem->load(in))
+    if(!system.load(in))
       return false;
 
     // Then load the console controllers and switches
-    if(!(myLeftControl->load(in) && myRightControl->load(in) &&
-         mySwitches->load(in)))
+    if(!(io.leftController().load(in) && io.rightController().load(in) &&
+         io.switches().load(in)))
       return false;
   }
   catch(...)
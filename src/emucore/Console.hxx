@@ -154,6 +154,31 @@ class Console : public Serializable, public ConsoleIO
     */
     bool load(Serializer& in) override;
 
+    /**
+      Save the state of the given system, controllers and switches; this is
+      the state of a console (see save()), also for systems without one
+      (e.g. headless replays).
+
+      @param system  The system to save
+      @param io      The controllers and switches to save
+      @param out     The serializer device to save to.
+      @param hook    Called before the state of each device is saved
+      @return The result of the save.  True on success, false on failure.
+    */
+    static bool saveState(const System& system, const ConsoleIO& io,
+                          Serializer& out, const SaveHook& hook = nullptr);
+
+    /**
+      Load the state of the given system, controllers and switches (see
+      saveState()).
+
+      @param system  The system to load
+      @param io      The controllers and switches to load
+      @param in      The serializer device to load from.
+      @return The result of the load.  True on success, false on failure.
+    */
+    static bool loadState(System& system, const ConsoleIO& io, Serializer& in);
+
     /**
       Set the properties to those given
 
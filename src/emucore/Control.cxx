@@ -89,9 +89,9 @@ bool Controller::load(Serializer& in)
     setPin(DigitalPin::Four,  in.getBool());
     setPin(DigitalPin::Six,   in.getBool());
 
-    // Input the analog pins
-    getPin(AnalogPin::Five).load(in);
-    getPin(AnalogPin::Nine).load(in);
+    // Input the analog pins (getPin() only returns a copy)
+    myAnalogPinValue[static_cast<int>(AnalogPin::Five)].load(in);
+    myAnalogPinValue[static_cast<int>(AnalogPin::Nine)].load(in);
   }
   catch(...)
   {
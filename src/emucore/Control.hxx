@@ -192,6 +192,13 @@ class Controller : public Serializable
     */
     virtual bool isAnalog() const { return false; }
 
+    /**
+      Answers whether the controller has state outside of its save state
+      (e.g. an EEPROM file), which would not be restored along with it.
+      Specific controllers should override and implement this method.
+    */
+    virtual bool hasExternalState() const { return false; }
+
     /**
       Notification method invoked by the system after its reset method has
       been called.  It may be necessary to override this method for
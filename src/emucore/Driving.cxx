@@ -186,6 +186,47 @@ void Driving::updateStelladaptorAxes()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Driving::save(Serializer& out) const
+{
+  if(!Controller::save(out))
+    return false;
+
+  try
+  {
+    // The gray code position is needed to continue the rotation exactly
+    out.putInt(myCounter);
+    out.putInt(myGrayIndex);
+    out.putInt(myLastYaxis);
+  }
+  catch(...)
+  {
+    cerr << "ERROR: Driving::save() exception\n";
+    return false;
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Driving::load(Serializer& in)
+{
+  if(!Controller::load(in))
+    return false;
+
+  try
+  {
+    myCounter = Int32(in.getInt());
+    myGrayIndex = in.getInt();
+    myLastYaxis = Int32(in.getInt());
+  }
+  catch(...)
+  {
+    cerr << "ERROR: Driving::load() exception\n";
+    return false;
+  }
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Driving::setMouseControl(
     Controller::Type xtype, int xid, Controller::Type ytype, int yid)
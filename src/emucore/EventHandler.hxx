@@ -358,6 +358,7 @@ class EventHandler
     */
     void changeMouseControl(int direction = +1);
     bool hasMouseControl() const;
+    const MouseControl* mouseControl() const { return myMouseControl.get(); }
 
     void saveKeyMapping();
     void saveJoyMapping();
@@ -55,6 +55,7 @@ void FBSurface::pixel(uInt32 x, uInt32 y, ColorId color)
   uInt32* buffer = myPixels + y * myPitch + x;
 
   *buffer = myPalette[color];
+  setDirtyRows(y, 1);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -128,6 +129,7 @@ void FBSurface::hLine(uInt32 x, uInt32 y, uInt32 x2, ColorId color)
   uInt32* buffer = myPixels + y * myPitch + x;
   while(x++ <= x2)
     *buffer++ = myPalette[color];
+  setDirtyRows(y, 1);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -136,6 +138,8 @@ void FBSurface::vLine(uInt32 x, uInt32 y, uInt32 y2, ColorId color)
   if(!checkBounds(x, y) || !checkBounds(x, y2))
     return;
 
+  setDirtyRows(y, y2 - y + 1);
+
   uInt32* buffer = static_cast<uInt32*>(myPixels + y * myPitch + x);
   while(y++ <= y2)
   {
@@ -156,60 +160,46 @@ void FBSurface::drawChar(const GUI::Font& font, uInt8 chr,
                          uInt32 tx, uInt32 ty, ColorId color, ColorId shadowColor)
 {
 #ifdef GUI_SUPPORT
-  if(shadowColor != kNone)
-  {
-    drawChar(font, chr, tx + 1, ty + 0, shadowColor);
-    drawChar(font, chr, tx + 0, ty + 1, shadowColor);
-    drawChar(font, chr, tx + 1, ty + 1, shadowColor);
-  }
+  const GUI::Font::Glyph* glyph = font.getGlyph(chr);
+  if(glyph == nullptr)
+    return;
 
-  const FontDesc& desc = font.desc();
+  const uInt32 cx = tx + glyph->bbx;
+  const uInt32 cy = ty + font.desc().ascent - glyph->bby - glyph->bbh;
 
-  // If this character is not included in the font, use the default char.
-  if(chr < desc.firstchar || chr >= desc.firstchar + desc.size)
-  {
-    if (chr == ' ') return;
-    chr = desc.defaultchar;
-  }
-  chr -= desc.firstchar;
-
-  // Get the bounding box of the character
-  int bbw, bbh, bbx, bby;
-  if(!desc.bbx)
-  {
-    bbw = desc.fbbw;
-    bbh = desc.fbbh;
-    bbx = desc.fbbx;
-    bby = desc.fbby;
-  }
-  else
+  if(shadowColor != kNone)
   {
-    bbw = desc.bbx[chr].w;  // NOLINT
-    bbh = desc.bbx[chr].h;  // NOLINT
-    bbx = desc.bbx[chr].x;  // NOLINT
-    bby = desc.bbx[chr].y;  // NOLINT
+    // Draw the pre-calculated shadow at once if it fits completely
+    if(cx <= width() && cy <= height() &&
+       cx + glyph->bbw <= width() && cy + glyph->bbh <= height())
+      drawGlyphRuns(glyph->shadowRuns, cx, cy, glyph->bbh + 1, shadowColor);
+    else
+    {
+      drawChar(font, chr, tx + 1, ty + 0, shadowColor);
+      drawChar(font, chr, tx + 0, ty + 1, shadowColor);
+      drawChar(font, chr, tx + 1, ty + 1, shadowColor);
+    }
   }
 
-  uInt32 cx = tx + bbx;
-  uInt32 cy = ty + desc.ascent - bby - bbh;
-
-  if(!checkBounds(cx , cy) || !checkBounds(cx + bbw - 1, cy + bbh - 1))
+  if(!checkBounds(cx , cy) || !checkBounds(cx + glyph->bbw - 1, cy + glyph->bbh - 1))
     return;
 
-  const uInt16* tmp = desc.bits + (desc.offset ? desc.offset[chr] : (chr * desc.fbbh));
-  uInt32* buffer = myPixels + cy * myPitch + cx;
+  drawGlyphRuns(glyph->runs, cx, cy, glyph->bbh, color);
+#endif
+}
 
-  for(int y = 0; y < bbh; y++)
-  {
-    const uInt16 ptr = *tmp++;
-    uInt16 mask = 0x8000;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FBSurface::drawGlyphRuns(const vector<GlyphRun>& runs,
+                              uInt32 x, uInt32 y, uInt32 h, ColorId color)
+{
+#ifdef GUI_SUPPORT
+  uInt32* buffer = myPixels + y * myPitch + x;
+  const uInt32 pixel = myPalette[color];
 
-    for(int x = 0; x < bbw; x++, mask >>= 1)
-      if(ptr & mask)
-        buffer[x] = myPalette[color];
+  for(const auto& run: runs)
+    std::fill_n(buffer + run.y * myPitch + run.x, run.len, pixel);
 
-    buffer += myPitch;
-  }
+  setDirtyRows(y, h);
 #endif
 }
 
@@ -228,6 +218,7 @@ void FBSurface::drawBitmap(const uInt32* bitmap, uInt32 tx, uInt32 ty,
     return;
 
   uInt32* buffer = myPixels + ty * myPitch + tx;
+  setDirtyRows(ty, h);
 
   for(uInt32 y = 0; y < h; ++y)
   {
@@ -247,6 +238,7 @@ void FBSurface::drawPixels(const uInt32* data, uInt32 tx, uInt32 ty, uInt32 nump
     return;
 
   uInt32* buffer = myPixels + ty * myPitch + tx;
+  setDirtyRows(ty, 1);
 
   for(uInt32 i = 0; i < numpixels; ++i)
     *buffer++ = data[i];
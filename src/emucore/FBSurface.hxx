@@ -21,6 +21,8 @@
 class FrameBuffer;
 class TIASurface;
 
+struct GlyphRun;
+
 namespace GUI {
   class Font;
 }
@@ -53,7 +55,8 @@ class FBSurface
 
     /**
       This method returns the surface pixel pointer and pitch, which are
-      used when one wishes to modify the surface pixels directly.
+      used when one wishes to modify the surface pixels directly.  The
+      modified pixels must be marked using setDirty() or setDirtyRows().
     */
     inline void basePtr(uInt32*& pixels, uInt32& pitch) const
     {
@@ -345,6 +348,24 @@ class FBSurface
     */
     virtual bool render() = 0;
 
+    /**
+      This method should be called to indicate whether all surface pixels
+      have changed since the last render (or none of them).  The drawing
+      primitives above mark the rows they change automatically, so this is
+      only needed when the pixels are accessed directly (see basePtr()).
+      The backend can then skip uploading unchanged pixels again.
+    */
+    virtual void setDirty(bool) { }
+
+    /**
+      This method should be called to indicate that some rows of the
+      surface have changed since the last render.
+
+      @param y  The first changed row
+      @param h  The number of changed rows
+    */
+    virtual void setDirtyRows(uInt32 y, uInt32 h) { }
+
     /**
       This method should be called to reset the surface to empty
       pixels / colour black.
@@ -398,6 +419,18 @@ class FBSurface
     */
     bool checkBounds(const uInt32 x, const uInt32 y) const;
 
+    /**
+      This method draws the runs of a pre-decoded glyph (or its shadow).
+
+      @param runs   The runs of set pixels
+      @param x      The x coordinate of the glyph bounding box
+      @param y      The y coordinate of the glyph bounding box
+      @param h      The height of the glyph bounding box
+      @param color  The color of the glyph
+    */
+    void drawGlyphRuns(const vector<GlyphRun>& runs, uInt32 x, uInt32 y,
+                       uInt32 h, ColorId color);
+
     /**
       Check if the given character is a whitespace.
       @param s      Character to check
@@ -73,7 +73,7 @@ bool FilesystemNode::getAllChildren(FSList& fslist, ListMode mode,
                                     bool includeParentDirectory,
                                     const CancelCheck& isCancelled) const
 {
-  if(getChildren(fslist, mode, filter, includeParentDirectory, true, isCancelled))
+  if(getChildren(fslist, mode, filter, true, includeParentDirectory, isCancelled))
   {
     // Sort only once at the end
   #if defined(ZIP_SUPPORT)
@@ -319,6 +319,18 @@ bool FilesystemNode::isWritable() const
   return _realNode ? _realNode->isWritable() : false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNode::getFileInfo(uInt64& size, uInt64& modTime) const
+{
+  return _realNode ? _realNode->getFileInfo(size, modTime) : false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNode::isArchive() const
+{
+  return _realNode ? _realNode->isArchive() : false;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool FilesystemNode::makeDir()
 {
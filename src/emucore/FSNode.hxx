@@ -226,6 +226,25 @@ class FilesystemNode
      */
     bool isWritable() const;
 
+    /**
+     * Get the size and the time of the last modification of the file.
+     * Together with the path, these identify a specific version of a file
+     * (e.g. for caching data derived from its contents).
+     *
+     * @param size     The size of the file in bytes
+     * @param modTime  The last modification time, in a platform-specific unit
+     *
+     * @return bool true if the information is available, false otherwise.
+     */
+    bool getFileInfo(uInt64& size, uInt64& modTime) const;
+
+    /**
+     * Indicates whether the object referred by this path is (inside) an
+     * archive, e.g. a ZIP file.  Archives are read through a shared handler,
+     * so they must not be read by multiple threads at the same time.
+     */
+    bool isArchive() const;
+
     /**
      * Create a directory from the current node path.
      *
@@ -420,6 +439,21 @@ class AbstractFSNode
      */
     virtual bool isWritable() const = 0;
 
+    /**
+     * Get the size and the time of the last modification of the file.
+     *
+     * @param size     The size of the file in bytes
+     * @param modTime  The last modification time, in a platform-specific unit
+     *
+     * @return bool true if the information is available, false otherwise.
+     */
+    virtual bool getFileInfo(uInt64& size, uInt64& modTime) const { return false; }
+
+    /**
+     * Indicates whether this path is (inside) an archive.
+     */
+    virtual bool isArchive() const { return false; }
+
     /**
      * Create a directory from the current node path.
      *
@@ -34,6 +34,8 @@
 #include "PaletteHandler.hxx"
 #include "StateManager.hxx"
 #include "RewindManager.hxx"
+#include "RunAheadManager.hxx"
+#include "PerfStats.hxx"
 
 #ifdef DEBUGGER_SUPPORT
   #include "Debugger.hxx"
@@ -287,7 +289,15 @@ FBInitStatus FrameBuffer::createDisplay(const string& title, BufferType type,
   const GUI::Font& f = hidpiEnabled() ? infoFont() : font();
   myStatsMsg.color = kColorInfo;
   myStatsMsg.w = f.getMaxCharWidth() * 40 + 3;
-  myStatsMsg.h = (f.getFontHeight() + 2) * 3;
+  int statsLines = 3;
+#ifdef SOUND_SUPPORT
+  statsLines += 1;
+#endif
+#ifdef PERFSTATS_SUPPORT
+  statsLines += 3;
+#endif
+  // Leave room for the run-ahead line, which is only shown while enabled
+  myStatsMsg.h = (f.getFontHeight() + 2) * (statsLines + 1);
 
   if(!myStatsMsg.surface)
   {
@@ -555,6 +565,7 @@ void FrameBuffer::updateInEmulationMode(float framesPerSecond)
 
   clear();  // TODO - test this: it may cause slowdowns on older systems
   myTIASurface->render();
+  PERF_END_FRAME();
 
   // Show frame statistics
   if(myStatsMsg.enabled)
@@ -701,9 +712,51 @@ void FrameBuffer::drawFrameStats(float framesPerSecond)
   myStatsMsg.surface->drawString(f, ss.str(), xPos, yPos,
       myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
 
+#ifdef SOUND_SUPPORT
+  // Audio latency, rate correction, underruns and overflows
+  yPos += dy;
+  myStatsMsg.surface->drawString(f, myOSystem.sound().statistics(), xPos, yPos,
+      myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
+#endif
+
+  // Run-ahead frames and their emulation time
+  const bool runAhead = myOSystem.state().runAheadManager().enabled();
+  if(runAhead)
+  {
+    yPos += dy;
+    myStatsMsg.surface->drawString(f,
+        myOSystem.state().runAheadManager().statisticsString(), xPos, yPos,
+        myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
+  }
+
+#ifdef PERFSTATS_SUPPORT
+  // Time spent per subsystem in the last frame (ms)
+  static const std::array<string, PerfStats::NUM_SECTIONS> labels = {
+    "CPU", "TIA", "Mov", "Frm", "Pix", "DQ", "Aud", "I/O", "Cart", "ARM", "Surf"
+  };
+  const PerfStats::Counters perf = PerfStats::lastFrame();
+
+  ss.str("");
+  for(size_t i = 0; i < PerfStats::NUM_SECTIONS; ++i)
+  {
+    ss << labels[i] << " " << std::fixed << std::setprecision(2)
+       << perf[i].time / 1000000.0 << " ";
+
+    if(i % 4 == 3 || i == PerfStats::NUM_SECTIONS - 1)
+    {
+      yPos += dy;
+      myStatsMsg.surface->drawString(f, ss.str(), xPos, yPos,
+          myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
+      ss.str("");
+    }
+  }
+#endif
+
+  const int h = runAhead ? myStatsMsg.h : myStatsMsg.h - dy;
+  myStatsMsg.surface->setSrcSize(myStatsMsg.w, h);
   myStatsMsg.surface->setDstPos(imageRect().x() + 10, imageRect().y() + 8);
   myStatsMsg.surface->setDstSize(myStatsMsg.w * hidpiScaleFactor(),
-                                 myStatsMsg.h * hidpiScaleFactor());
+                                 h * hidpiScaleFactor());
   myStatsMsg.surface->render();
 #endif
 }
@@ -897,10 +950,7 @@ shared_ptr<FBSurface> FrameBuffer::allocateSurface(
 void FrameBuffer::deallocateSurface(shared_ptr<FBSurface> surface)
 {
   if(surface)
-  {
-    cerr << "deallocateSurface: " << surface << endl;
     mySurfaceList.remove(surface);
-  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
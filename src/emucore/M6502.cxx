@@ -42,6 +42,7 @@
 #include "System.hxx"
 #include "M6502.hxx"
 #include "DispatchResult.hxx"
+#include "PerfStats.hxx"
 #include "exception/EmulationWarning.hxx"
 #include "exception/FatalEmulationError.hxx"
 
@@ -94,11 +95,13 @@ void M6502::reset()
   myReadFromWritePortBreak = devSettings ? mySettings.getBool("dev.rwportbreak") : false;
   myWriteToReadPortBreak = devSettings ? mySettings.getBool("dev.wrportbreak") : false;
   myLogBreaks = mySettings.getBool("dbg.logbreaks");
+  myTrackAccesses = devSettings;
 
   myLastBreakCycle = ULLONG_MAX;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool debugging>
 inline uInt8 M6502::peek(uInt16 address, Device::AccessFlags flags)
 {
   handleHalt();
@@ -114,11 +117,11 @@ inline uInt8 M6502::peek(uInt16 address, Device::AccessFlags flags)
   mySystem->incrementCycles(SYSTEM_CYCLES_PER_CPU);
   icycles += SYSTEM_CYCLES_PER_CPU;
   myFlags = flags;
-  uInt8 result = mySystem->peek(address, flags);
+  uInt8 result = mySystem->peek<debugging>(address, flags);
   myLastPeekAddress = address;
 
 #ifdef DEBUGGER_SUPPORT
-  if(myReadTraps.isInitialized() && myReadTraps.isSet(address)
+  if(debugging && myReadTraps.isInitialized() && myReadTraps.isSet(address)
      && (myGhostReadsTrap || flags != DISASM_NONE))
   {
     myLastPeekBaseAddress = myDebugger->getBaseAddress(myLastPeekAddress, true); // mirror handling
@@ -139,6 +142,7 @@ inline uInt8 M6502::peek(uInt16 address, Device::AccessFlags flags)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool debugging>
 inline void M6502::poke(uInt16 address, uInt8 value, Device::AccessFlags flags)
 {
   ////////////////////////////////////////////////
@@ -151,11 +155,11 @@ inline void M6502::poke(uInt16 address, uInt8 value, Device::AccessFlags flags)
   ////////////////////////////////////////////////
   mySystem->incrementCycles(SYSTEM_CYCLES_PER_CPU);
   icycles += SYSTEM_CYCLES_PER_CPU;
-  mySystem->poke(address, value, flags);
+  mySystem->poke<debugging>(address, value, flags);
   myLastPokeAddress = address;
 
 #ifdef DEBUGGER_SUPPORT
-  if(myWriteTraps.isInitialized() && myWriteTraps.isSet(address))
+  if(debugging && myWriteTraps.isInitialized() && myWriteTraps.isSet(address))
   {
     myLastPokeBaseAddress = myDebugger->getBaseAddress(myLastPokeAddress, false); // mirror handling
     int cond = evalCondTraps();
@@ -190,7 +194,12 @@ inline void M6502::handleHalt()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::execute(uInt64 number, DispatchResult& result)
 {
-  _execute(number, result);
+#ifdef DEBUGGER_SUPPORT
+  if(isDebugging())
+    _execute<true>(number, result);
+  else
+#endif
+    _execute<false>(number, result);
 
 #ifdef DEBUGGER_SUPPORT
   // Debugger hack: this ensures that stepping a "STA WSYNC" will actually end at the
@@ -218,8 +227,11 @@ bool M6502::execute(uInt64 number)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool debugging>
 inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
 {
+  PERF_SCOPE(cpu);
+
   myExecutionStatus = 0;
 
 #ifdef DEBUGGER_SUPPORT
@@ -236,84 +248,88 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
     while (!myExecutionStatus && currentCycles < cycles * SYSTEM_CYCLES_PER_CPU)
     {
   #ifdef DEBUGGER_SUPPORT
-      // Don't break if we haven't actually executed anything yet
-      if (myLastBreakCycle != mySystem->cycles()) {
-        if(myJustHitReadTrapFlag || myJustHitWriteTrapFlag)
-        {
-          bool read = myJustHitReadTrapFlag;
-          myJustHitReadTrapFlag = myJustHitWriteTrapFlag = false;
+      if constexpr(debugging)
+      {
+        // Don't break if we haven't actually executed anything yet
+        if (myLastBreakCycle != mySystem->cycles()) {
+          if(myJustHitReadTrapFlag || myJustHitWriteTrapFlag)
+          {
+            bool read = myJustHitReadTrapFlag;
+            myJustHitReadTrapFlag = myJustHitWriteTrapFlag = false;
 
-          myLastBreakCycle = mySystem->cycles();
+            myLastBreakCycle = mySystem->cycles();
 
-          if(myLogBreaks)
-            myDebugger->log(myHitTrapInfo.message);
-          else
-          {
-            result.setDebugger(currentCycles, myHitTrapInfo.message + " ",
-                               read ? "Read trap" : "Write trap",
-                               myHitTrapInfo.address, read);
-            return;
+            if(myLogBreaks)
+              myDebugger->log(myHitTrapInfo.message);
+            else
+            {
+              result.setDebugger(currentCycles, myHitTrapInfo.message + " ",
+                                 read ? "Read trap" : "Write trap",
+                                 myHitTrapInfo.address, read);
+              return;
+            }
           }
-        }
 
-        if(myBreakPoints.isInitialized())
-        {
-          uInt8 bank = mySystem->cart().getBank(PC);
+          if(myBreakPoints.isInitialized())
+          {
+            uInt8 bank = mySystem->cart().getBank(PC);
+
+            if(myBreakPoints.check(PC, bank))
+            {
+              myLastBreakCycle = mySystem->cycles();
+              // disable a one-shot breakpoint
+              if(myBreakPoints.get(PC, bank) & BreakpointMap::ONE_SHOT)
+              {
+                myBreakPoints.erase(PC, bank);
+                return;
+              }
+              else
+              {
+                if(myLogBreaks)
+                  myDebugger->log("BP:");
+                else
+                {
+                  ostringstream msg;
+
+                  msg << "BP: $" << Common::Base::HEX4 << PC << ", bank #" << std::dec << int(bank);
+                  result.setDebugger(currentCycles, msg.str(), "Breakpoint");
+                  return;
+                }
+              }
+            }
+          }
 
-          if(myBreakPoints.check(PC, bank))
+          int cond = evalCondBreaks();
+          if(cond > -1)
           {
+            ostringstream msg;
+
             myLastBreakCycle = mySystem->cycles();
-            // disable a one-shot breakpoint
-            if(myBreakPoints.get(PC, bank) & BreakpointMap::ONE_SHOT)
+
+            if(myLogBreaks)
             {
-              myBreakPoints.erase(PC, bank);
-              return;
+              msg << "CBP[" << Common::Base::HEX2 << cond << "]:";
+              myDebugger->log(msg.str());
             }
             else
             {
-              if(myLogBreaks)
-                myDebugger->log("BP:");
-              else
-              {
-                ostringstream msg;
-
-                msg << "BP: $" << Common::Base::HEX4 << PC << ", bank #" << std::dec << int(bank);
-                result.setDebugger(currentCycles, msg.str(), "Breakpoint");
-                return;
-              }
+              msg << "CBP[" << Common::Base::HEX2 << cond << "]: " << myCondBreakNames[cond];
+              result.setDebugger(currentCycles, msg.str(), "Conditional breakpoint");
+              return;
             }
           }
         }
 
-        int cond = evalCondBreaks();
+        int cond = evalCondSaveStates();
         if(cond > -1)
         {
           ostringstream msg;
-
-          myLastBreakCycle = mySystem->cycles();
-
-          if(myLogBreaks)
-          {
-            msg << "CBP[" << Common::Base::HEX2 << cond << "]:";
-            myDebugger->log(msg.str());
-          }
-          else
-          {
-            msg << "CBP[" << Common::Base::HEX2 << cond << "]: " << myCondBreakNames[cond];
-            result.setDebugger(currentCycles, msg.str(), "Conditional breakpoint");
-            return;
-          }
+          msg << "conditional savestate [" << Common::Base::HEX2 << cond << "]";
+          myDebugger->addState(msg.str());
         }
       }
 
-      int cond = evalCondSaveStates();
-      if(cond > -1)
-      {
-        ostringstream msg;
-        msg << "conditional savestate [" << Common::Base::HEX2 << cond << "]";
-        myDebugger->addState(msg.str());
-      }
-
+      // The cartridge records RAM read accesses in every debugger build
       mySystem->cart().clearAllRAMAccesses();
   #endif  // DEBUGGER_SUPPORT
 
@@ -330,7 +346,7 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
     #endif
 
         // Fetch instruction at the program counter
-        IR = peek(PC++, DISASM_CODE);  // This address represents a code section
+        IR = peek<debugging>(PC++, DISASM_CODE);  // This address represents a code section
 
         // Call code to execute the instruction
         switch(IR)
@@ -343,7 +359,7 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
         }
 
     #ifdef DEBUGGER_SUPPORT
-        if(myReadFromWritePortBreak)
+        if(debugging && myReadFromWritePortBreak)
         {
           uInt16 rwpAddr = mySystem->cart().getIllegalRAMReadAccess();
           if(rwpAddr)
@@ -355,7 +371,7 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
           }
         }
 
-        if (myWriteToReadPortBreak)
+        if (debugging && myWriteToReadPortBreak)
         {
           uInt16 wrpAddr = mySystem->cart().getIllegalRAMWriteAccess();
           if (wrpAddr)
@@ -378,7 +394,7 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
       currentCycles = (mySystem->cycles() - previousCycles);
 
   #ifdef DEBUGGER_SUPPORT
-      if(myStepStateByInstruction)
+      if(debugging && myStepStateByInstruction)
       {
         // Check out M6502::execute for an explanation.
         handleHalt();
@@ -678,6 +694,17 @@ const StringList& M6502::getCondTrapNames() const
   return myTrapCondNames;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool M6502::isDebugging() const
+{
+  return myDebuggerActive || myTrackAccesses ||
+         myJustHitReadTrapFlag || myJustHitWriteTrapFlag ||
+         myBreakPoints.isInitialized() ||
+         myReadTraps.isInitialized() || myWriteTraps.isInitialized() ||
+         myStepStateByInstruction ||
+         myReadFromWritePortBreak || myWriteToReadPortBreak;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::updateStepStateByInstruction()
 {
@@ -35,6 +35,7 @@ class DispatchResult;
 
 #include "bspf.hxx"
 #include "Device.hxx"
+#include "System.hxx"
 #include "Serializable.hxx"
 
 /**
@@ -234,6 +235,14 @@ class M6502 : public Serializable
 
     BreakpointMap& breakPoints() { return myBreakPoints; }
 
+    /**
+      Answer whether the debugger-instrumented execution loop is required.
+      This is the case while the debugger is open, when any breakpoints,
+      traps, conditions or port access breaks are installed, and in developer
+      mode (which always tracks memory accesses for the disassembler).
+    */
+    bool isDebugging() const;
+
     // methods for 'breakif' handling
     uInt32 addCondBreak(Expression* e, const string& name, bool oneShot = false);
     bool delCondBreak(uInt32 idx);
@@ -257,6 +266,9 @@ class M6502 : public Serializable
     void setWriteToReadPortBreak(bool enable) { myWriteToReadPortBreak = enable; }
     void setLogBreaks(bool enable) { myLogBreaks = enable; }
     bool getLogBreaks() { return myLogBreaks; }
+
+    // Use the instrumented execution loop while the debugger is open
+    void setDebuggerActive(bool active) { myDebuggerActive = active; }
 #endif  // DEBUGGER_SUPPORT
 
   private:
@@ -266,21 +278,27 @@ class M6502 : public Serializable
       conclusively determine code sections, even if the disassembler cannot
       find them itself.
 
+      @tparam debugging  Check traps and track accesses for the debugger
+
       @param address  The address from which the value should be loaded
       @param flags    Indicates that this address has the given flags
                       for type of access (CODE, DATA, GFX, etc)
 
       @return The byte at the specified address
     */
+    template<bool debugging>
     uInt8 peek(uInt16 address, Device::AccessFlags flags);
 
     /**
       Change the byte at the specified address to the given value and
       update the cycle count.
 
+      @tparam debugging  Check traps and track accesses for the debugger
+
       @param address  The address where the value should be stored
       @param value    The value to be stored at the address
     */
+    template<bool debugging>
     void poke(uInt16 address, uInt8 value, Device::AccessFlags flags = Device::NONE);
 
     /**
@@ -330,7 +348,12 @@ class M6502 : public Serializable
     /**
       This is the actual dispatch function that does the grunt work. M6502::execute
       wraps it and makes sure that any pending halt is processed before returning.
+
+      There are two instantiations: the debugger-instrumented one, which checks
+      breakpoints, traps and conditions and tracks memory accesses, and the plain
+      one, which is used whenever none of this is required (see isDebugging()).
     */
+    template<bool debugging>
     void _execute(uInt64 cycles, DispatchResult& result);
 
 #ifdef DEBUGGER_SUPPORT
@@ -472,6 +495,8 @@ class M6502 : public Serializable
     bool myWriteToReadPortBreak{false};    // trap on writes to read ports
     bool myStepStateByInstruction{false};
     bool myLogBreaks{false};               // log breaks/taps and continue emulation
+    bool myDebuggerActive{false};          // the debugger is open
+    bool myTrackAccesses{false};           // always track accesses (developer mode)
 
   private:
     // Following constructors and assignment operators not supported
@@ -46,7 +46,7 @@
 
 #ifndef SET_LAST_POKE
   #ifdef DEBUGGER_SUPPORT
-    #define SET_LAST_POKE(_addr) myDataAddressForPoke = _addr;
+    #define SET_LAST_POKE(_addr) if constexpr(debugging) myDataAddressForPoke = _addr;
   #else
     #define SET_LAST_POKE(_addr)
   #endif
@@ -54,270 +54,270 @@
 
 
 define(M6502_IMPLIED, `{
-  peek(PC, DISASM_NONE);
+  peek<debugging>(PC, DISASM_NONE);
 }')
 
 define(M6502_IMMEDIATE_READ, `{
-  operand = peek(PC++, DISASM_CODE);
+  operand = peek<debugging>(PC++, DISASM_CODE);
 }')
 
 define(M6502_IMMEDIATE_READ_DISCARD_OPERAND, `{
-  peek(PC++, DISASM_CODE);
+  peek<debugging>(PC++, DISASM_CODE);
 }')
 
 define(M6502_ABSOLUTE_READ, `{
-  intermediateAddress = peek(PC++, DISASM_CODE);
-  intermediateAddress |= (uInt16(peek(PC++, DISASM_CODE)) << 8);
-  operand = peek(intermediateAddress, DISASM_DATA);
+  intermediateAddress = peek<debugging>(PC++, DISASM_CODE);
+  intermediateAddress |= (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
+  operand = peek<debugging>(intermediateAddress, DISASM_DATA);
 }')
 
 define(M6502_ABSOLUTE_READ_DISCARD_OPERAND, `{
-  intermediateAddress = peek(PC++, DISASM_CODE);
-  intermediateAddress |= (uInt16(peek(PC++, DISASM_CODE)) << 8);
-  peek(intermediateAddress, DISASM_DATA);
+  intermediateAddress = peek<debugging>(PC++, DISASM_CODE);
+  intermediateAddress |= (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
+  peek<debugging>(intermediateAddress, DISASM_DATA);
 }')
 
 define(M6502_ABSOLUTE_WRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  operandAddress |= (uInt16(peek(PC++, DISASM_CODE)) << 8);
+  operandAddress = peek<debugging>(PC++, DISASM_CODE);
+  operandAddress |= (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
 }')
 
 define(M6502_ABSOLUTE_READMODIFYWRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  operandAddress |= (uInt16(peek(PC++, DISASM_CODE)) << 8);
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand, DISASM_WRITE);
+  operandAddress = peek<debugging>(PC++, DISASM_CODE);
+  operandAddress |= (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
+  operand = peek<debugging>(operandAddress, DISASM_DATA);
+  poke<debugging>(operandAddress, operand, DISASM_WRITE);
 }')
 
 define(M6502_ABSOLUTEX_READ, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = (uInt16(peek(PC++, DISASM_CODE)) << 8);
+  uInt16 low = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 high = (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
   intermediateAddress = high | uInt8(low + X);
   if((low + X) > 0xFF)
   {
-    peek(intermediateAddress, DISASM_NONE);
+    peek<debugging>(intermediateAddress, DISASM_NONE);
     intermediateAddress = (high | low) + X;
-    operand = peek(intermediateAddress, DISASM_DATA);
+    operand = peek<debugging>(intermediateAddress, DISASM_DATA);
   }
   else
   {
-    operand = peek(intermediateAddress, DISASM_DATA);
+    operand = peek<debugging>(intermediateAddress, DISASM_DATA);
   }
 }')
 
 define(M6502_ABSOLUTEX_READ_DISCARD_OPERAND, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = (uInt16(peek(PC++, DISASM_CODE)) << 8);
+  uInt16 low = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 high = (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
   intermediateAddress = high | uInt8(low + X);
   if((low + X) > 0xFF)
   {
-    peek(intermediateAddress, DISASM_NONE);
+    peek<debugging>(intermediateAddress, DISASM_NONE);
     intermediateAddress = (high | low) + X;
-    peek(intermediateAddress, DISASM_DATA);
+    peek<debugging>(intermediateAddress, DISASM_DATA);
   }
   else
   {
-    peek(intermediateAddress, DISASM_DATA);
+    peek<debugging>(intermediateAddress, DISASM_DATA);
   }
 }')
 
 define(M6502_ABSOLUTEX_WRITE, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = (uInt16(peek(PC++, DISASM_CODE)) << 8);
-  peek(high | uInt8(low + X), DISASM_NONE);
+  uInt16 low = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 high = (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
+  peek<debugging>(high | uInt8(low + X), DISASM_NONE);
   operandAddress = (high | low) + X;
 }')
 
 define(M6502_ABSOLUTEX_READMODIFYWRITE, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = (uInt16(peek(PC++, DISASM_CODE)) << 8);
-  peek(high | uInt8(low + X), DISASM_NONE);
+  uInt16 low = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 high = (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
+  peek<debugging>(high | uInt8(low + X), DISASM_NONE);
   operandAddress = (high | low) + X;
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand, DISASM_WRITE);
+  operand = peek<debugging>(operandAddress, DISASM_DATA);
+  poke<debugging>(operandAddress, operand, DISASM_WRITE);
 }')
 
 define(M6502_ABSOLUTEY_READ, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = (uInt16(peek(PC++, DISASM_CODE)) << 8);
+  uInt16 low = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 high = (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
   intermediateAddress = high | uInt8(low + Y);
   if((low + Y) > 0xFF)
   {
-    peek(intermediateAddress, DISASM_NONE);
+    peek<debugging>(intermediateAddress, DISASM_NONE);
     intermediateAddress = (high | low) + Y;
-    operand = peek(intermediateAddress, DISASM_DATA);
+    operand = peek<debugging>(intermediateAddress, DISASM_DATA);
   }
   else
   {
-    operand = peek(intermediateAddress, DISASM_DATA);
+    operand = peek<debugging>(intermediateAddress, DISASM_DATA);
   }
 }')
 
 define(M6502_ABSOLUTEY_WRITE, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = (uInt16(peek(PC++, DISASM_CODE)) << 8);
-  peek(high | uInt8(low + Y), DISASM_NONE);
+  uInt16 low = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 high = (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
+  peek<debugging>(high | uInt8(low + Y), DISASM_NONE);
   operandAddress = (high | low) + Y;
 }')
 
 define(M6502_ABSOLUTEY_READMODIFYWRITE, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = (uInt16(peek(PC++, DISASM_CODE)) << 8);
-  peek(high | uInt8(low + Y), DISASM_NONE);
+  uInt16 low = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 high = (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
+  peek<debugging>(high | uInt8(low + Y), DISASM_NONE);
   operandAddress = (high | low) + Y;
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand, DISASM_WRITE);
+  operand = peek<debugging>(operandAddress, DISASM_DATA);
+  poke<debugging>(operandAddress, operand, DISASM_WRITE);
 }')
 
 define(M6502_ZERO_READ, `{
-  intermediateAddress = peek(PC++, DISASM_CODE);
-  operand = peek(intermediateAddress, DISASM_DATA);
+  intermediateAddress = peek<debugging>(PC++, DISASM_CODE);
+  operand = peek<debugging>(intermediateAddress, DISASM_DATA);
 }')
 
 define(M6502_ZERO_READ_DISCARD_OPERAND, `{
-  intermediateAddress = peek(PC++, DISASM_CODE);
-  peek(intermediateAddress, DISASM_DATA);
+  intermediateAddress = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(intermediateAddress, DISASM_DATA);
 }')
 
 define(M6502_ZERO_WRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
+  operandAddress = peek<debugging>(PC++, DISASM_CODE);
 }')
 
 define(M6502_ZERO_READMODIFYWRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand, DISASM_WRITE);
+  operandAddress = peek<debugging>(PC++, DISASM_CODE);
+  operand = peek<debugging>(operandAddress, DISASM_DATA);
+  poke<debugging>(operandAddress, operand, DISASM_WRITE);
 }')
 
 define(M6502_ZEROX_READ, `{
-  intermediateAddress = peek(PC++, DISASM_CODE);
-  peek(intermediateAddress, DISASM_NONE);
+  intermediateAddress = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(intermediateAddress, DISASM_NONE);
   intermediateAddress += X;
-  operand = peek(intermediateAddress, DISASM_DATA);
+  operand = peek<debugging>(intermediateAddress, DISASM_DATA);
 }')
 
 define(M6502_ZEROX_READ_DISCARD_OPERAND, `{
-  intermediateAddress = peek(PC++, DISASM_CODE);
-  peek(intermediateAddress, DISASM_NONE);
+  intermediateAddress = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(intermediateAddress, DISASM_NONE);
   intermediateAddress += X;
-  peek(intermediateAddress, DISASM_DATA);
+  peek<debugging>(intermediateAddress, DISASM_DATA);
 }')
 
 define(M6502_ZEROX_WRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  peek(operandAddress, DISASM_NONE);
+  operandAddress = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(operandAddress, DISASM_NONE);
   operandAddress = (operandAddress + X) & 0xFF;
 }')
 
 define(M6502_ZEROX_READMODIFYWRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  peek(operandAddress, DISASM_NONE);
+  operandAddress = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(operandAddress, DISASM_NONE);
   operandAddress = (operandAddress + X) & 0xFF;
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand, DISASM_WRITE);
+  operand = peek<debugging>(operandAddress, DISASM_DATA);
+  poke<debugging>(operandAddress, operand, DISASM_WRITE);
 }')
 
 define(M6502_ZEROY_READ, `{
-  intermediateAddress = peek(PC++, DISASM_CODE);
-  peek(intermediateAddress, DISASM_NONE);
+  intermediateAddress = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(intermediateAddress, DISASM_NONE);
   intermediateAddress += Y;
-  operand = peek(intermediateAddress, DISASM_DATA);
+  operand = peek<debugging>(intermediateAddress, DISASM_DATA);
 }')
 
 define(M6502_ZEROY_WRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  peek(operandAddress, DISASM_NONE);
+  operandAddress = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(operandAddress, DISASM_NONE);
   operandAddress = (operandAddress + Y) & 0xFF;
 }')
 
 define(M6502_ZEROY_READMODIFYWRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  peek(operandAddress, DISASM_NONE);
+  operandAddress = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(operandAddress, DISASM_NONE);
   operandAddress = (operandAddress + Y) & 0xFF;
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand, DISASM_WRITE);
+  operand = peek<debugging>(operandAddress, DISASM_DATA);
+  poke<debugging>(operandAddress, operand, DISASM_WRITE);
 }')
 
 define(M6502_INDIRECT, `{
-  uInt16 addr = peek(PC++, DISASM_CODE);
-  addr |= (uInt16(peek(PC++, DISASM_CODE)) << 8);
+  uInt16 addr = peek<debugging>(PC++, DISASM_CODE);
+  addr |= (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
 
   // Simulate the error in the indirect addressing mode!
   uInt16 high = NOTSAMEPAGE(addr, addr + 1) ? (addr & 0xff00) : (addr + 1);
 
-  operandAddress = peek(addr, DISASM_DATA);
-  operandAddress |= (uInt16(peek(high, DISASM_DATA)) << 8);
+  operandAddress = peek<debugging>(addr, DISASM_DATA);
+  operandAddress |= (uInt16(peek<debugging>(high, DISASM_DATA)) << 8);
 }')
 
 define(M6502_INDIRECTX_READ, `{
-  uInt8 pointer = peek(PC++, DISASM_CODE);
-  peek(pointer, DISASM_NONE);
+  uInt8 pointer = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(pointer, DISASM_NONE);
   pointer += X;
-  intermediateAddress = peek(pointer++, DISASM_DATA);
-  intermediateAddress |= (uInt16(peek(pointer, DISASM_DATA)) << 8);
-  operand = peek(intermediateAddress, DISASM_DATA);
+  intermediateAddress = peek<debugging>(pointer++, DISASM_DATA);
+  intermediateAddress |= (uInt16(peek<debugging>(pointer, DISASM_DATA)) << 8);
+  operand = peek<debugging>(intermediateAddress, DISASM_DATA);
 }')
 
 define(M6502_INDIRECTX_WRITE, `{
-  uInt8 pointer = peek(PC++, DISASM_CODE);
-  peek(pointer, DISASM_NONE);
+  uInt8 pointer = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(pointer, DISASM_NONE);
   pointer += X;
-  operandAddress = peek(pointer++, DISASM_DATA);
-  operandAddress |= (uInt16(peek(pointer, DISASM_DATA)) << 8);
+  operandAddress = peek<debugging>(pointer++, DISASM_DATA);
+  operandAddress |= (uInt16(peek<debugging>(pointer, DISASM_DATA)) << 8);
 }')
 
 define(M6502_INDIRECTX_READMODIFYWRITE, `{
-  uInt8 pointer = peek(PC++, DISASM_CODE);
-  peek(pointer, DISASM_NONE);
+  uInt8 pointer = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(pointer, DISASM_NONE);
   pointer += X;
-  operandAddress = peek(pointer++, DISASM_DATA);
-  operandAddress |= (uInt16(peek(pointer, DISASM_DATA)) << 8);
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand, DISASM_WRITE);
+  operandAddress = peek<debugging>(pointer++, DISASM_DATA);
+  operandAddress |= (uInt16(peek<debugging>(pointer, DISASM_DATA)) << 8);
+  operand = peek<debugging>(operandAddress, DISASM_DATA);
+  poke<debugging>(operandAddress, operand, DISASM_WRITE);
 }')
 
 define(M6502_INDIRECTY_READ, `{
-  uInt8 pointer = peek(PC++, DISASM_CODE);
-  uInt16 low = peek(pointer++, DISASM_DATA);
-  uInt16 high = (uInt16(peek(pointer, DISASM_DATA)) << 8);
+  uInt8 pointer = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 low = peek<debugging>(pointer++, DISASM_DATA);
+  uInt16 high = (uInt16(peek<debugging>(pointer, DISASM_DATA)) << 8);
   intermediateAddress = high | uInt8(low + Y);
   if((low + Y) > 0xFF)
   {
-    peek(intermediateAddress, DISASM_NONE);
+    peek<debugging>(intermediateAddress, DISASM_NONE);
     intermediateAddress = (high | low) + Y;
-    operand = peek(intermediateAddress, DISASM_DATA);
+    operand = peek<debugging>(intermediateAddress, DISASM_DATA);
   }
   else
   {
-    operand = peek(intermediateAddress, DISASM_DATA);
+    operand = peek<debugging>(intermediateAddress, DISASM_DATA);
   }
 }')
 
 define(M6502_INDIRECTY_WRITE, `{
-  uInt8 pointer = peek(PC++, DISASM_CODE);
-  uInt16 low = peek(pointer++, DISASM_DATA);
-  uInt16 high = (uInt16(peek(pointer, DISASM_DATA)) << 8);
-  peek(high | uInt8(low + Y), DISASM_NONE);
+  uInt8 pointer = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 low = peek<debugging>(pointer++, DISASM_DATA);
+  uInt16 high = (uInt16(peek<debugging>(pointer, DISASM_DATA)) << 8);
+  peek<debugging>(high | uInt8(low + Y), DISASM_NONE);
   operandAddress = (high | low) + Y;
 }')
 
 define(M6502_INDIRECTY_READMODIFYWRITE, `{
-  uInt8 pointer = peek(PC++, DISASM_CODE);
-  uInt16 low = peek(pointer++, DISASM_DATA);
-  uInt16 high = (uInt16(peek(pointer, DISASM_DATA)) << 8);
-  peek(high | uInt8(low + Y), DISASM_NONE);
+  uInt8 pointer = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 low = peek<debugging>(pointer++, DISASM_DATA);
+  uInt16 high = (uInt16(peek<debugging>(pointer, DISASM_DATA)) << 8);
+  peek<debugging>(high | uInt8(low + Y), DISASM_NONE);
   operandAddress = (high | low) + Y;
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand, DISASM_WRITE);
+  operand = peek<debugging>(operandAddress, DISASM_DATA);
+  poke<debugging>(operandAddress, operand, DISASM_WRITE);
 }')
 
 define(M6502_BCC, `{
   if(!C)
   {
-    peek(PC, DISASM_NONE);
+    peek<debugging>(PC, DISASM_NONE);
     uInt16 address = PC + Int8(operand);
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debugging>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -325,10 +325,10 @@ define(M6502_BCC, `{
 define(M6502_BCS, `{
   if(C)
   {
-    peek(PC, DISASM_NONE);
+    peek<debugging>(PC, DISASM_NONE);
     uInt16 address = PC + Int8(operand);
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debugging>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -336,10 +336,10 @@ define(M6502_BCS, `{
 define(M6502_BEQ, `{
   if(!notZ)
   {
-    peek(PC, DISASM_NONE);
+    peek<debugging>(PC, DISASM_NONE);
     uInt16 address = PC + Int8(operand);
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debugging>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -347,10 +347,10 @@ define(M6502_BEQ, `{
 define(M6502_BMI, `{
   if(N)
   {
-    peek(PC, DISASM_NONE);
+    peek<debugging>(PC, DISASM_NONE);
     uInt16 address = PC + Int8(operand);
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debugging>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -358,10 +358,10 @@ define(M6502_BMI, `{
 define(M6502_BNE, `{
   if(notZ)
   {
-    peek(PC, DISASM_NONE);
+    peek<debugging>(PC, DISASM_NONE);
     uInt16 address = PC + Int8(operand);
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debugging>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -369,10 +369,10 @@ define(M6502_BNE, `{
 define(M6502_BPL, `{
   if(!N)
   {
-    peek(PC, DISASM_NONE);
+    peek<debugging>(PC, DISASM_NONE);
     uInt16 address = PC + Int8(operand);
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debugging>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -380,10 +380,10 @@ define(M6502_BPL, `{
 define(M6502_BVC, `{
   if(!V)
   {
-    peek(PC, DISASM_NONE);
+    peek<debugging>(PC, DISASM_NONE);
     uInt16 address = PC + Int8(operand);
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debugging>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -391,10 +391,10 @@ define(M6502_BVC, `{
 define(M6502_BVS, `{
   if(V)
   {
-    peek(PC, DISASM_NONE);
+    peek<debugging>(PC, DISASM_NONE);
     uInt16 address = PC + Int8(operand);
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debugging>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -498,7 +498,7 @@ define(M6502_ASL, `{
   C = operand & 0x80;
 
   operand <<= 1;
-  poke(operandAddress, operand, DISASM_WRITE);
+  poke<debugging>(operandAddress, operand, DISASM_WRITE);
 
   notZ = operand;
   N = operand & 0x80;
@@ -533,18 +533,18 @@ define(M6502_BIT, `{
 }')
 
 define(M6502_BRK, `{
-  peek(PC++, DISASM_NONE);
+  peek<debugging>(PC++, DISASM_NONE);
 
   B = true;
 
-  poke(0x0100 + SP--, PC >> 8, DISASM_WRITE);
-  poke(0x0100 + SP--, PC & 0x00ff, DISASM_WRITE);
-  poke(0x0100 + SP--, PS(), DISASM_WRITE);
+  poke<debugging>(0x0100 + SP--, PC >> 8, DISASM_WRITE);
+  poke<debugging>(0x0100 + SP--, PC & 0x00ff, DISASM_WRITE);
+  poke<debugging>(0x0100 + SP--, PS(), DISASM_WRITE);
 
   I = true;
 
-  PC = peek(0xfffe, DISASM_DATA);
-  PC |= (uInt16(peek(0xffff, DISASM_DATA)) << 8);
+  PC = peek<debugging>(0xfffe, DISASM_DATA);
+  PC |= (uInt16(peek<debugging>(0xffff, DISASM_DATA)) << 8);
 }')
 
 define(M6502_CLC, `{
@@ -589,7 +589,7 @@ define(M6502_CPY, `{
 
 define(M6502_DCP, `{
   uInt8 value = operand - 1;
-  poke(operandAddress, value, DISASM_WRITE);
+  poke<debugging>(operandAddress, value, DISASM_WRITE);
 
   uInt16 value2 = uInt16(A) - uInt16(value);
   notZ = value2;
@@ -599,7 +599,7 @@ define(M6502_DCP, `{
 
 define(M6502_DEC, `{
   uInt8 value = operand - 1;
-  poke(operandAddress, value, DISASM_WRITE);
+  poke<debugging>(operandAddress, value, DISASM_WRITE);
 
   notZ = value;
   N = value & 0x80;
@@ -628,7 +628,7 @@ define(M6502_EOR, `{
 
 define(M6502_INC, `{
   uInt8 value = operand + 1;
-  poke(operandAddress, value, DISASM_WRITE);
+  poke<debugging>(operandAddress, value, DISASM_WRITE);
 
   notZ = value;
   N = value & 0x80;
@@ -648,7 +648,7 @@ define(M6502_INY, `{
 
 define(M6502_ISB, `{
   operand = operand + 1;
-  poke(operandAddress, operand, DISASM_WRITE);
+  poke<debugging>(operandAddress, operand, DISASM_WRITE);
 
   // N, V, Z, C flags are the same in either mode (C calculated at the end)
   Int32 sum = A - operand - (C ? 0 : 1);
@@ -682,16 +682,16 @@ define(M6502_JMP, `{
 }')
 
 define(M6502_JSR, `{
-  uInt8 low = peek(PC++, DISASM_CODE);
-  peek(0x0100 + SP, DISASM_NONE);
+  uInt8 low = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(0x0100 + SP, DISASM_NONE);
 
   // It seems that the 650x does not push the address of the next instruction
   // on the stack it actually pushes the address of the next instruction
   // minus one.  This is compensated for in the RTS instruction
-  poke(0x0100 + SP--, PC >> 8, DISASM_WRITE);
-  poke(0x0100 + SP--, PC & 0xff, DISASM_WRITE);
+  poke<debugging>(0x0100 + SP--, PC >> 8, DISASM_WRITE);
+  poke<debugging>(0x0100 + SP--, PC & 0xff, DISASM_WRITE);
 
-  PC = (low | (uInt16(peek(PC, DISASM_CODE)) << 8));
+  PC = (low | (uInt16(peek<debugging>(PC, DISASM_CODE)) << 8));
 }')
 
 define(M6502_LAS, `{
@@ -730,7 +730,7 @@ define(M6502_LSR, `{
   C = operand & 0x01;
 
   operand >>= 1;
-  poke(operandAddress, operand, DISASM_WRITE);
+  poke<debugging>(operandAddress, operand, DISASM_WRITE);
 
   notZ = operand;
   N = false;
@@ -765,28 +765,28 @@ define(M6502_ORA, `{
 }')
 
 define(M6502_PHA, `{
-  poke(0x0100 + SP--, A, DISASM_WRITE);
+  poke<debugging>(0x0100 + SP--, A, DISASM_WRITE);
 }')
 
 define(M6502_PHP, `{
-  poke(0x0100 + SP--, PS(), DISASM_WRITE);
+  poke<debugging>(0x0100 + SP--, PS(), DISASM_WRITE);
 }')
 
 define(M6502_PLA, `{
-  peek(0x0100 + SP++, DISASM_NONE);
-  A = peek(0x0100 + SP, DISASM_DATA);
+  peek<debugging>(0x0100 + SP++, DISASM_NONE);
+  A = peek<debugging>(0x0100 + SP, DISASM_DATA);
   notZ = A;
   N = A & 0x80;
 }')
 
 define(M6502_PLP, `{
-  peek(0x0100 + SP++, DISASM_NONE);
-  PS(peek(0x0100 + SP, DISASM_DATA));
+  peek<debugging>(0x0100 + SP++, DISASM_NONE);
+  PS(peek<debugging>(0x0100 + SP, DISASM_DATA));
 }')
 
 define(M6502_RLA, `{
   uInt8 value = (operand << 1) | (C ? 1 : 0);
-  poke(operandAddress, value, DISASM_WRITE);
+  poke<debugging>(operandAddress, value, DISASM_WRITE);
 
   A &= value;
   C = operand & 0x80;
@@ -801,7 +801,7 @@ define(M6502_ROL, `{
   C = operand & 0x80;
 
   operand = (operand << 1) | (oldC ? 1 : 0);
-  poke(operandAddress, operand, DISASM_WRITE);
+  poke<debugging>(operandAddress, operand, DISASM_WRITE);
 
   notZ = operand;
   N = operand & 0x80;
@@ -826,7 +826,7 @@ define(M6502_ROR, `{
   C = operand & 0x01;
 
   operand = ((operand >> 1) & 0x7f) | (oldC ? 0x80 : 0x00);
-  poke(operandAddress, operand, DISASM_WRITE);
+  poke<debugging>(operandAddress, operand, DISASM_WRITE);
 
   notZ = operand;
   N = operand & 0x80;
@@ -851,7 +851,7 @@ define(M6502_RRA, `{
   C = operand & 0x01;
 
   operand = ((operand >> 1) & 0x7f) | (oldC ? 0x80 : 0x00);
-  poke(operandAddress, operand, DISASM_WRITE);
+  poke<debugging>(operandAddress, operand, DISASM_WRITE);
 
   if(!D)
   {
@@ -884,21 +884,21 @@ define(M6502_RRA, `{
 }')
 
 define(M6502_RTI, `{
-  peek(0x0100 + SP++, DISASM_NONE);
-  PS(peek(0x0100 + SP++, DISASM_DATA));
-  PC = peek(0x0100 + SP++, DISASM_DATA);
-  PC |= (uInt16(peek(0x0100 + SP, DISASM_DATA)) << 8);
+  peek<debugging>(0x0100 + SP++, DISASM_NONE);
+  PS(peek<debugging>(0x0100 + SP++, DISASM_DATA));
+  PC = peek<debugging>(0x0100 + SP++, DISASM_DATA);
+  PC |= (uInt16(peek<debugging>(0x0100 + SP, DISASM_DATA)) << 8);
 }')
 
 define(M6502_RTS, `{
-  peek(0x0100 + SP++, DISASM_NONE);
-  PC = peek(0x0100 + SP++, DISASM_DATA);
-  PC |= (uInt16(peek(0x0100 + SP, DISASM_DATA)) << 8);
-  peek(PC++, DISASM_NONE);
+  peek<debugging>(0x0100 + SP++, DISASM_NONE);
+  PC = peek<debugging>(0x0100 + SP++, DISASM_DATA);
+  PC |= (uInt16(peek<debugging>(0x0100 + SP, DISASM_DATA)) << 8);
+  peek<debugging>(PC++, DISASM_NONE);
 }')
 
 define(M6502_SAX, `{
-  poke(operandAddress, A & X, DISASM_WRITE);
+  poke<debugging>(operandAddress, A & X, DISASM_WRITE);
 }')
 
 define(M6502_SBC, `{
@@ -953,26 +953,26 @@ define(M6502_SEI, `{
 define(M6502_SHA, `{
   // NOTE: There are mixed reports on the actual operation
   // of this instruction!
-  poke(operandAddress, A & X & (((operandAddress >> 8) & 0xff) + 1), DISASM_WRITE);
+  poke<debugging>(operandAddress, A & X & (((operandAddress >> 8) & 0xff) + 1), DISASM_WRITE);
 }')
 
 define(M6502_SHS, `{
   // NOTE: There are mixed reports on the actual operation
   // of this instruction!
   SP = A & X;
-  poke(operandAddress, A & X & (((operandAddress >> 8) & 0xff) + 1), DISASM_WRITE);
+  poke<debugging>(operandAddress, A & X & (((operandAddress >> 8) & 0xff) + 1), DISASM_WRITE);
 }')
 
 define(M6502_SHX, `{
   // NOTE: There are mixed reports on the actual operation
   // of this instruction!
-  poke(operandAddress, X & (((operandAddress >> 8) & 0xff) + 1), DISASM_WRITE);
+  poke<debugging>(operandAddress, X & (((operandAddress >> 8) & 0xff) + 1), DISASM_WRITE);
 }')
 
 define(M6502_SHY, `{
   // NOTE: There are mixed reports on the actual operation
   // of this instruction!
-  poke(operandAddress, Y & (((operandAddress >> 8) & 0xff) + 1), DISASM_WRITE);
+  poke<debugging>(operandAddress, Y & (((operandAddress >> 8) & 0xff) + 1), DISASM_WRITE);
 }')
 
 define(M6502_SLO, `{
@@ -980,7 +980,7 @@ define(M6502_SLO, `{
   C = operand & 0x80;
 
   operand <<= 1;
-  poke(operandAddress, operand, DISASM_WRITE);
+  poke<debugging>(operandAddress, operand, DISASM_WRITE);
 
   A |= operand;
   notZ = A;
@@ -992,7 +992,7 @@ define(M6502_SRE, `{
   C = operand & 0x01;
 
   operand = (operand >> 1) & 0x7f;
-  poke(operandAddress, operand, DISASM_WRITE);
+  poke<debugging>(operandAddress, operand, DISASM_WRITE);
 
   A ^= operand;
   notZ = A;
@@ -1000,15 +1000,15 @@ define(M6502_SRE, `{
 }')
 
 define(M6502_STA, `{
-  poke(operandAddress, A, DISASM_WRITE);
+  poke<debugging>(operandAddress, A, DISASM_WRITE);
 }')
 
 define(M6502_STX, `{
-  poke(operandAddress, X, DISASM_WRITE);
+  poke<debugging>(operandAddress, X, DISASM_WRITE);
 }')
 
 define(M6502_STY, `{
-  poke(operandAddress, Y, DISASM_WRITE);
+  poke<debugging>(operandAddress, Y, DISASM_WRITE);
 }')
 
 define(M6502_TAX, `{
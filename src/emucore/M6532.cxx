@@ -147,7 +147,12 @@ void M6532::updateEmulation()
   myLastCycle = mySystem->cycles();
 
 #ifdef DEBUGGER_SUPPORT
-  myTimWrappedOnRead = myTimWrappedOnWrite = false;
+  // RAM is accessed through peek() and poke() only while a flag is set
+  if(myTimWrappedOnRead || myTimWrappedOnWrite)
+  {
+    myTimWrappedOnRead = myTimWrappedOnWrite = false;
+    mapRAM(true);
+  }
 #endif
 }
 
@@ -155,6 +160,22 @@ void M6532::updateEmulation()
 void M6532::install(System& system)
 {
   installDelegate(system, *this);
+
+  // ZP RAM (and its mirrors) holds no state besides its contents, so the
+  // system can read and write it directly, bypassing peek() and poke()
+  mapRAM(true);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6532::mapRAM(bool direct)
+{
+  for (uInt16 addr = 0; addr < 0x1000; addr += System::PAGE_SIZE)
+    if ((addr & 0x0280) == 0x0080 && mySystem->getPageAccess(addr).device == this) {
+      System::PageAccess access(this, System::PageAccessType::READWRITE);
+      if (direct)
+        access.directPeekBase = access.directPokeBase = &myRAM[addr & 0x007f];
+      mySystem->setPageAccess(addr, access);
+    }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -225,7 +246,9 @@ uInt8 M6532::peek(uInt16 addr)
       // Timer Flag is always cleared when accessing INTIM
       if (!myWrappedThisCycle) myInterruptFlag &= ~TimerBit;
   #ifdef DEBUGGER_SUPPORT
+      // The flag is cleared by the next access of the RIOT, including RAM
       myTimWrappedOnRead = myWrappedThisCycle;
+      if (myTimWrappedOnRead) mapRAM(false);
       myTimReadCycles += 7;
   #endif
       return myTimer;
@@ -327,7 +350,9 @@ void M6532::setTimerRegister(uInt8 value, uInt8 interval)
   // Interrupt timer flag is cleared (and invalid) when writing to the timer
   if (!myWrappedThisCycle) myInterruptFlag &= ~TimerBit;
 #ifdef DEBUGGER_SUPPORT
+  // The flag is cleared by the next access of the RIOT, including RAM
   myTimWrappedOnWrite = myWrappedThisCycle;
+  if (myTimWrappedOnWrite) mapRAM(false);
 #endif
 
   mySetTimerCycle = mySystem->cycles();
@@ -149,6 +149,13 @@ class M6532 : public Device
     void setTimerRegister(uInt8 data, uInt8 interval);
     void setPinState(bool shcha);
 
+    /**
+      Map ZP RAM (and its mirrors) for direct access by the system, or for
+      access through peek() and poke().  Pages mapped to a delegate device
+      are left alone.
+    */
+    void mapRAM(bool direct);
+
   #ifdef DEBUGGER_SUPPORT
     // The following are used by the debugger to read INTIM/TIMINT
     // We need separate methods to do this, so the state of the system
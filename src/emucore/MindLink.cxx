@@ -67,6 +67,45 @@ void MindLink::nextMindlinkBit()
 	}
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MindLink::save(Serializer& out) const
+{
+  if(!Controller::save(out))
+    return false;
+
+  try
+  {
+    // The position is needed to continue the transfer exactly
+    out.putInt(myMindlinkPos);
+    out.putInt(myMindlinkShift);
+  }
+  catch(...)
+  {
+    cerr << "ERROR: MindLink::save() exception\n";
+    return false;
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MindLink::load(Serializer& in)
+{
+  if(!Controller::load(in))
+    return false;
+
+  try
+  {
+    myMindlinkPos = Int32(in.getInt());
+    myMindlinkShift = Int32(in.getInt());
+  }
+  catch(...)
+  {
+    cerr << "ERROR: MindLink::load() exception\n";
+    return false;
+  }
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool MindLink::setMouseControl(
     Controller::Type xtype, int xid, Controller::Type ytype, int yid)
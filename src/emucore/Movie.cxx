@@ -0,0 +1,471 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "FSNode.hxx"
+#include "Settings.hxx"
+#include "Switches.hxx"
+#include "System.hxx"
+#include "M6502.hxx"
+#include "M6532.hxx"
+#include "TIA.hxx"
+#include "Cart.hxx"
+#include "Joystick.hxx"
+#include "Paddles.hxx"
+#include "PointingDevice.hxx"
+#include "Driving.hxx"
+
+#include "Movie.hxx"
+
+namespace {
+  // The settings which change the emulation of a loaded state
+  constexpr std::array<const char*, 19> EMULATION_SETTINGS = {
+    "dev.settings", "dev.tia.type", "dev.tia.plinvphase", "dev.tia.msinvphase",
+    "dev.tia.blinvphase", "dev.tia.delaypfbits", "dev.tia.delaypfcolor",
+    "dev.tia.delaybkcolor", "dev.tia.delayplswap", "dev.tia.delayblswap",
+    "dev.tiadriven", "dev.console", "plr.console", "dev.tv.jitter",
+    "plr.tv.jitter", "dev.tv.jitter_recovery", "plr.tv.jitter_recovery",
+    "fastscbios", "romloadcount"
+  };
+
+  // The settings of the controllers (see EventHandler and Console)
+  constexpr std::array<const char*, 9> INPUT_SETTINGS = {
+    "joydeadzone", "dejitter.base", "dejitter.diff", "dsense", "psense",
+    "msense", "tsense", "dcsense", "autofirerate"
+  };
+
+  bool isInputSetting(const string& key)
+  {
+    for(const char* name: INPUT_SETTINGS)
+      if(key == name)
+        return true;
+
+    return false;
+  }
+
+  // Unsigned values are stored with 7 bits per byte, the MSB indicates that
+  // more bytes follow
+  void putVarint(Serializer& out, uInt64 value)
+  {
+    while(value >= 0x80)
+    {
+      out.putByte(uInt8(value) | 0x80);
+      value >>= 7;
+    }
+    out.putByte(uInt8(value));
+  }
+
+  uInt64 getVarint(const Serializer& in)
+  {
+    uInt64 value = 0;
+
+    for(uInt32 shift = 0; shift < 64; shift += 7)
+    {
+      const uInt8 b = in.getByte();
+
+      value |= uInt64(b & 0x7f) << shift;
+      if(!(b & 0x80))
+        return value;
+    }
+    throw runtime_error("Movie: invalid number");
+  }
+
+  // Signed values are zigzag encoded first, so small negative values are
+  // small too
+  inline uInt64 zigzag(Int64 value)
+  {
+    return (uInt64(value) << 1) ^ uInt64(value >> 63);
+  }
+
+  inline Int64 unzigzag(uInt64 value)
+  {
+    return Int64(value >> 1) ^ -Int64(value & 1);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Movie::create(const string& filename, const Info& info,
+                   const Settings& settings, const Serializer& state,
+                   const Event& event, const Switches& switches,
+                   const MouseControl::MouseMode& mouseMode)
+{
+  close();
+
+  myInfo = info;
+  myValues.fill(0);
+  mySwitches = switches.read();
+  myMouseMode = MouseControl::MouseMode();
+  myCycles = info.startCycles;
+  myRecords = 0;
+
+  myFile = make_unique<Serializer>(filename, Serializer::Mode::ReadWriteTrunc);
+  if(!*myFile)
+  {
+    myFile.reset();
+    return false;
+  }
+
+  try
+  {
+    Serializer& out = *myFile;
+
+    out.putString(MOVIE_HEADER);
+    out.putInt(Event::VERSION);
+
+    out.putString(info.md5);
+    out.putString(info.romFile);
+    out.putString(info.cartType);
+    out.putString(Controller::getPropName(info.leftType));
+    out.putByte(uInt8(info.leftJack));
+    out.putString(Controller::getPropName(info.rightType));
+    out.putByte(uInt8(info.rightJack));
+    out.putBool(info.swapPaddles);
+    out.putByte(uInt8(info.timing));
+    out.putByte(uInt8(info.layout));
+    out.putLong(info.startCycles);
+    out.putInt(info.checksumInterval);
+    out.putInt(info.paddleXCenter);
+    out.putInt(info.paddleYCenter);
+    out.putInt(info.paddleRange);
+
+    out.putShort(uInt16(EMULATION_SETTINGS.size() + INPUT_SETTINGS.size()));
+    for(const char* key: EMULATION_SETTINGS)
+    {
+      out.putString(key);
+      out.putString(settings.getString(key));
+    }
+    for(const char* key: INPUT_SETTINGS)
+    {
+      out.putString(key);
+      out.putString(settings.getString(key));
+    }
+
+    out.putInt(uInt32(state.size()));
+    out.putByteArray(state.data(), state.size());
+
+    putChanges(event, mySwitches, mouseMode);
+    resetMouseMotion();
+  }
+  catch(...)
+  {
+    myFile.reset();
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Movie::record(uInt64 cycles, const Event& event, const Switches& switches,
+                   const MouseControl::MouseMode& mouseMode, System& system)
+{
+  if(!myFile)
+    return false;
+
+  try
+  {
+    // The cycles are offset by one, zero marks the end of the movie
+    putVarint(*myFile, cycles - myCycles + 1);
+    myCycles = cycles;
+
+    putChanges(event, switches.read(), mouseMode);
+    resetMouseMotion();
+
+    ++myRecords;
+    if(myInfo.checksumInterval && myRecords % myInfo.checksumInterval == 0)
+      myFile->putLong(checksum(system));
+  }
+  catch(...)
+  {
+    myFile.reset();
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Movie::close()
+{
+  if(!myFile)
+    return;
+
+  try
+  {
+    putVarint(*myFile, 0);
+  }
+  catch(...)
+  {
+    cerr << "ERROR: Movie::close" << endl;
+  }
+  myFile.reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Movie::open(const string& filename)
+{
+  close();
+
+  try
+  {
+    ByteBuffer image;
+    const size_t size = FilesystemNode(filename).read(image);
+
+    myData.reset();
+    myData.putByteArray(image.get(), size);
+    myData.rewind();
+
+    if(myData.getString() != MOVIE_HEADER ||
+       Int32(myData.getInt()) != Event::VERSION)
+      return false;
+
+    myInfo.md5 = myData.getString();
+    myInfo.romFile = myData.getString();
+    myInfo.cartType = myData.getString();
+    myInfo.leftType = Controller::getType(myData.getString());
+    myInfo.leftJack = Controller::Jack(myData.getByte());
+    myInfo.rightType = Controller::getType(myData.getString());
+    myInfo.rightJack = Controller::Jack(myData.getByte());
+    myInfo.swapPaddles = myData.getBool();
+    myInfo.timing = ConsoleTiming(myData.getByte());
+    myInfo.layout = FrameLayout(myData.getByte());
+    myInfo.startCycles = myData.getLong();
+    myInfo.checksumInterval = myData.getInt();
+    myInfo.paddleXCenter = Int32(myData.getInt());
+    myInfo.paddleYCenter = Int32(myData.getInt());
+    myInfo.paddleRange = Int32(myData.getInt());
+
+    mySettings.clear();
+    for(uInt16 i = myData.getShort(); i > 0; --i)
+    {
+      const string key = myData.getString();
+      mySettings.emplace_back(key, myData.getString());
+    }
+  }
+  catch(...)
+  {
+    return false;
+  }
+
+  myValues.fill(0);
+  myMouseMode = MouseControl::MouseMode();
+  myCycles = myInfo.startCycles;
+  myRecords = 0;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Movie::applySettings(Settings& settings) const
+{
+  for(const auto& [key, value]: mySettings)
+  {
+    // Make sure a multicart selects the recorded ROM again
+    if(key == "romloadcount")
+    {
+      settings.setValue(key, BSPF::stringToInt(value) + 1);
+      settings.setValue("romloadprev", true);
+    }
+    else
+      settings.setValue(key, value);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Movie::applyInputSettings() const
+{
+  for(const auto& [key, value]: mySettings)
+  {
+    const int setting = BSPF::stringToInt(value);
+
+    if(key == "joydeadzone")         Joystick::setDeadZone(setting);
+    else if(key == "dejitter.base")  Paddles::setDejitterBase(setting);
+    else if(key == "dejitter.diff")  Paddles::setDejitterDiff(setting);
+    else if(key == "dsense")         Paddles::setDigitalSensitivity(setting);
+    else if(key == "psense")         Paddles::setAnalogSensitivity(setting);
+    else if(key == "msense")         Paddles::setMouseSensitivity(setting);
+    else if(key == "tsense")         PointingDevice::setSensitivity(setting);
+    else if(key == "dcsense")        Driving::setSensitivity(setting);
+    else if(key == "autofirerate")   Controller::setAutoFireRate(setting);
+  }
+  Paddles::setAnalogXCenter(myInfo.paddleXCenter);
+  Paddles::setAnalogYCenter(myInfo.paddleYCenter);
+  Paddles::setDigitalPaddleRange(myInfo.paddleRange);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string Movie::inputSettings() const
+{
+  ostringstream buf;
+
+  for(const auto& [key, value]: mySettings)
+    if(isInputSetting(key))
+      buf << key << "=" << value << " ";
+  buf << "xcenter=" << myInfo.paddleXCenter << " ycenter=" << myInfo.paddleYCenter
+      << " range=" << myInfo.paddleRange;
+
+  return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Movie::start(Serializer& state, Event& event, Record& record)
+{
+  const uInt32 size = myData.getInt();
+  ByteBuffer data = make_unique<uInt8[]>(size);
+
+  myData.getByteArray(data.get(), size);
+  state.reset();
+  state.putByteArray(data.get(), size);
+  state.rewind();
+
+  record.hasSwitches = record.hasMouseMode = false;
+  getChanges(event, record);
+  endPoll(event);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Movie::next(Record& record, Event& event)
+{
+  const uInt64 cycles = getVarint(myData);
+  if(cycles == 0)
+    return false;
+
+  myCycles += cycles - 1;
+  record.cycles = myCycles;
+  record.hasSwitches = record.hasMouseMode = false;
+  getChanges(event, record);
+
+  ++myRecords;
+  record.hasChecksum =
+    myInfo.checksumInterval && myRecords % myInfo.checksumInterval == 0;
+  if(record.hasChecksum)
+    record.checksum = myData.getLong();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Movie::applySwitches(Switches& switches, uInt8 value)
+{
+  switches.setTvColor(value & 0x08);
+  switches.setLeftDifficultyA(value & 0x40);
+  switches.setRightDifficultyA(value & 0x80);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Movie::endPoll(Event& event)
+{
+  event.set(Event::MouseAxisXMove, 0);
+  event.set(Event::MouseAxisYMove, 0);
+  resetMouseMotion();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 Movie::checksum(System& system)
+{
+  myChecksumState.reset();
+  system.m6502().save(myChecksumState);
+  system.m6532().save(myChecksumState);
+  system.cart().save(myChecksumState);
+  system.tia().saveChecksumState(myChecksumState);
+  myChecksumState.putLong(system.cycles());
+
+  // 64 bit FNV-1a
+  uInt64 hash = 0xcbf29ce484222325ULL;
+  const uInt8* data = myChecksumState.data();
+  for(size_t i = 0; i < myChecksumState.size(); ++i)
+    hash = (hash ^ data[i]) * 0x100000001b3ULL;
+
+  return hash;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Movie::putChanges(const Event& event, uInt8 switches,
+                       const MouseControl::MouseMode& mouseMode)
+{
+  myChanges.clear();
+
+  for(uInt32 type = Event::NoType + 1; type < Event::LastType; ++type)
+  {
+    const Int32 value = event.get(Event::Type(type));
+
+    if(value != myValues[type])
+    {
+      myChanges.emplace_back(type, Int64(value) - myValues[type]);
+      myValues[type] = value;
+    }
+  }
+  if((switches ^ mySwitches) & SWITCHES_MASK)
+  {
+    myChanges.emplace_back(SWITCHES, switches);
+    mySwitches = switches;
+  }
+  const bool mouseModeChanged =
+    mouseMode.xtype != myMouseMode.xtype || mouseMode.xid != myMouseMode.xid ||
+    mouseMode.ytype != myMouseMode.ytype || mouseMode.yid != myMouseMode.yid;
+
+  putVarint(*myFile, myChanges.size() + (mouseModeChanged ? 1 : 0));
+  for(const auto& [type, delta]: myChanges)
+  {
+    putVarint(*myFile, type);
+    putVarint(*myFile, type == SWITCHES ? uInt64(delta) : zigzag(delta));
+  }
+  if(mouseModeChanged)
+  {
+    putVarint(*myFile, MOUSE_MODE);
+    myFile->putString(Controller::getPropName(mouseMode.xtype));
+    putVarint(*myFile, zigzag(mouseMode.xid));
+    myFile->putString(Controller::getPropName(mouseMode.ytype));
+    putVarint(*myFile, zigzag(mouseMode.yid));
+    myMouseMode = mouseMode;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Movie::getChanges(Event& event, Record& record)
+{
+  for(uInt64 changes = getVarint(myData); changes > 0; --changes)
+  {
+    const uInt64 type = getVarint(myData);
+
+    if(type == SWITCHES)
+    {
+      record.hasSwitches = true;
+      record.switches = uInt8(getVarint(myData));
+    }
+    else if(type == MOUSE_MODE)
+    {
+      record.hasMouseMode = true;
+      record.mouseMode.xtype = Controller::getType(myData.getString());
+      record.mouseMode.xid = int(unzigzag(getVarint(myData)));
+      record.mouseMode.ytype = Controller::getType(myData.getString());
+      record.mouseMode.yid = int(unzigzag(getVarint(myData)));
+    }
+    else if(type > Event::NoType && type < Event::LastType)
+    {
+      myValues[type] = Int32(myValues[type] + unzigzag(getVarint(myData)));
+      event.set(Event::Type(type), myValues[type]);
+    }
+    else
+      throw runtime_error("Movie: invalid event");
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Movie::resetMouseMotion()
+{
+  myValues[Event::MouseAxisXMove] = myValues[Event::MouseAxisYMove] = 0;
+}
@@ -0,0 +1,256 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef MOVIE_HXX
+#define MOVIE_HXX
+
+#define MOVIE_HEADER "06060000movie"
+
+class Settings;
+class Switches;
+class System;
+
+#include "bspf.hxx"
+#include "Control.hxx"
+#include "MouseControl.hxx"
+#include "Event.hxx"
+#include "ConsoleTiming.hxx"
+#include "FrameLayout.hxx"
+#include "Serializer.hxx"
+
+/**
+  This class reads and writes movies, which are input logs of an emulation
+  session.  A movie consists of a header describing the ROM, controllers and
+  emulation relevant settings, the console state at the start of the
+  recording and a stream of records, one per input poll (i.e. normally one
+  per frame).
+
+  Each record contains the number of system cycles since the previous
+  record, and only the event values (and the console switches and mouse
+  control mode) which have changed since then.  All numbers are stored as
+  variable length integers, so a record without any input change takes only
+  a few bytes.  Optionally, every n-th record also contains a checksum of
+  the emulation state, which allows a replay to detect where it started to
+  differ from the recording.
+
+  Since the inputs are applied at exactly the same cycles as they were
+  recorded at, a movie can be replayed without any display, sound or
+  throttling (see ProfilingRunner).
+*/
+class Movie
+{
+  public:
+    struct Info {
+      string md5;       // md5 of the (multicart) ROM
+      string romFile;   // the ROM image the movie was recorded with
+      string cartType;  // bankswitching type of the cartridge
+      Controller::Type leftType{Controller::Type::Joystick};
+      Controller::Jack leftJack{Controller::Jack::Left};
+      Controller::Type rightType{Controller::Type::Joystick};
+      Controller::Jack rightJack{Controller::Jack::Right};
+      bool swapPaddles{false};
+      ConsoleTiming timing{ConsoleTiming::ntsc};
+      FrameLayout layout{FrameLayout::ntsc};
+      uInt64 startCycles{0};       // system cycles of the initial state
+      uInt32 checksumInterval{0};  // records per checksum, 0 = none
+      Int32 paddleXCenter{0};      // analog paddle centers (properties)
+      Int32 paddleYCenter{0};
+      Int32 paddleRange{100};      // digital paddle range in percent
+    };
+
+    struct Record {
+      uInt64 cycles{0};          // system cycles of the input poll
+      bool hasSwitches{false};   // switches changed other than by events
+      uInt8 switches{0};
+      bool hasMouseMode{false};  // mouse control mode changed
+      MouseControl::MouseMode mouseMode;
+      bool hasChecksum{false};
+      uInt64 checksum{0};
+    };
+
+  public:
+    Movie() = default;
+    ~Movie() { close(); }
+
+  public:
+    /**
+      Create a new movie file and write the header and the initial state.
+
+      @param filename  The movie file to create
+      @param info      The description of the recorded console
+      @param settings  The settings to take the emulation settings from
+      @param state     The console state the recording starts with
+      @param event     The event values the recording starts with
+      @param switches  The console switches the recording starts with
+      @param mouseMode The mouse control mode the recording starts with
+
+      @return  False if the file could not be written, else true
+    */
+    bool create(const string& filename, const Info& info,
+                const Settings& settings, const Serializer& state,
+                const Event& event, const Switches& switches,
+                const MouseControl::MouseMode& mouseMode);
+
+    /**
+      Append the input of a poll to the movie; must be called right after the
+      controllers and switches have been updated from the events.
+
+      @param cycles    The current system cycles
+      @param event     The current event values
+      @param switches  The console switches
+      @param mouseMode The current mouse control mode
+      @param system    The system to checksum (if due)
+
+      @return  False if the file could not be written, else true
+    */
+    bool record(uInt64 cycles, const Event& event, const Switches& switches,
+                const MouseControl::MouseMode& mouseMode, System& system);
+
+    /**
+      Finish the movie file; this writes the end marker and closes the file.
+    */
+    void close();
+
+    /**
+      Answer whether a movie is currently being recorded.
+    */
+    bool isRecording() const { return myFile != nullptr; }
+
+    /**
+      Open a movie for replay; the whole file is read into memory.
+
+      @param filename  The movie file to read
+
+      @return  False if the file is missing or no valid movie, else true
+    */
+    bool open(const string& filename);
+
+    /**
+      The description of the recorded console (after create() or open()).
+    */
+    const Info& info() const { return myInfo; }
+
+    /**
+      Apply the recorded emulation settings (after open()).
+    */
+    void applySettings(Settings& settings) const;
+
+    /**
+      Apply the recorded input settings to the controllers (after open()).
+      Note that these are global for all controllers of the same type.
+    */
+    void applyInputSettings() const;
+
+    /**
+      The recorded input settings as a string (after open()); replays with
+      different input settings must not run at the same time.
+    */
+    string inputSettings() const;
+
+    /**
+      Get the initial console state and event values (after open()).
+
+      @param state   The serializer to receive the state
+      @param event   The event object to receive the event values
+      @param record  The initial mouse control mode
+    */
+    void start(Serializer& state, Event& event, Record& record);
+
+    /**
+      Read the next record and apply its changes to the event values.  The
+      event values must only be used by the controllers after the system has
+      reached the cycles of the record.
+
+      @param record  The record read
+      @param event   The event object to apply the changes to
+
+      @return  False at the end of the movie, else true
+    */
+    bool next(Record& record, Event& event);
+
+    /**
+      Update the console switches which were not changed by events.
+    */
+    static void applySwitches(Switches& switches, uInt8 value);
+
+    /**
+      Finish a replayed poll the way the event handler does; mouse motion is
+      only valid for the poll it was reported in.
+    */
+    void endPoll(Event& event);
+
+    /**
+      Calculate the checksum of the emulation state.  Only the part of the
+      TIA state which doesn't depend on the display is included.
+    */
+    uInt64 checksum(System& system);
+
+    /**
+      The number of records recorded or replayed so far.
+    */
+    uInt32 records() const { return myRecords; }
+
+  private:
+    void putChanges(const Event& event, uInt8 switches,
+                    const MouseControl::MouseMode& mouseMode);
+    void getChanges(Event& event, Record& record);
+    void resetMouseMotion();
+
+  private:
+    // The (pseudo) event type of the console switches in the change list
+    static constexpr uInt32 SWITCHES = Event::LastType;
+
+    // The (pseudo) event type of the mouse control mode in the change list
+    static constexpr uInt32 MOUSE_MODE = Event::LastType + 1;
+
+    // The console switches which can be changed other than by events
+    static constexpr uInt8 SWITCHES_MASK = 0xc8;
+
+    Info myInfo;
+
+    // The recorded file, only while recording
+    unique_ptr<Serializer> myFile;
+
+    // The movie data, only while replaying
+    Serializer myData;
+
+    // The recorded emulation and input settings
+    vector<std::pair<string, string>> mySettings;
+
+    // The event values, switches and mouse control mode as of the last record
+    std::array<Int32, Event::LastType> myValues;
+    uInt8 mySwitches{0};
+    MouseControl::MouseMode myMouseMode;
+
+    // The event changes of the current record
+    vector<std::pair<uInt32, Int64>> myChanges;
+
+    uInt64 myCycles{0};
+    uInt32 myRecords{0};
+
+    // Used to serialize the state for the checksums
+    Serializer myChecksumState;
+
+  private:
+    // Following constructors and assignment operators not supported
+    Movie(const Movie&) = delete;
+    Movie(Movie&&) = delete;
+    Movie& operator=(const Movie&) = delete;
+    Movie& operator=(Movie&&) = delete;
+};
+
+#endif
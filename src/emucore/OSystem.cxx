@@ -54,9 +54,11 @@
 #include "Console.hxx"
 #include "Random.hxx"
 #include "StateManager.hxx"
+#include "RunAheadManager.hxx"
 #include "TimerManager.hxx"
 #ifdef GUI_SUPPORT
 #include "HighScoresManager.hxx"
+#include "HashManager.hxx"
 #endif
 #include "Version.hxx"
 #include "TIA.hxx"
@@ -178,12 +180,15 @@ bool OSystem::initialize(const Settings::Options& options)
   myMenu = make_unique<Menu>(*this);
   myCommandMenu = make_unique<CommandMenu>(*this);
   myHighScoresManager = make_unique<HighScoresManager>(*this);
+  myHashManager = make_unique<HashManager>();
   myHighScoresMenu = make_unique<HighScoresMenu>(*this);
   myMessageMenu = make_unique<MessageMenu>(*this);
   myTimeMachine = make_unique<TimeMachine>(*this);
   myLauncher = make_unique<Launcher>(*this);
 
   myHighScoresManager->setRepository(getHighscoreRepository());
+  myHashManager->setRepository(getHashCacheRepository());
+  myHashManager->prune();
 #endif
 
 #ifdef PNG_SUPPORT
@@ -734,16 +739,11 @@ double OSystem::dispatchEmulation(EmulationWorker& emulationWorker)
 
   TIA& tia(myConsole->tia());
   const EmulationTiming& timing = myConsole->emulationTiming();
+  RunAheadManager& runAhead = myStateManager->runAheadManager();
   DispatchResult dispatchResult;
 
-  // Check whether we have a frame pending for rendering...
-  bool framePending = tia.newFramePending();
-  // ... and copy it to the frame buffer. It is important to do this before
-  // the worker is started to avoid racing.
-  if (framePending) {
-    myFpsMeter.render(tia.framesSinceLastRender());
-    tia.renderToFrameBuffer();
-  }
+  // In run-ahead mode, only the frames emulated ahead are displayed
+  tia.setFramesHidden(runAhead.enabled());
 
   // Start emulation on a dedicated thread. It will do its own scheduling to
   // sync 6507 and real time and will run until we stop the worker.
@@ -755,9 +755,16 @@ double OSystem::dispatchEmulation(EmulationWorker& emulationWorker)
     &tia
   );
 
-  // Render the frame. This may block, but emulation will continue to run on
+  // Take over a pending frame from the TIA; this only exchanges buffers, so
+  // it is safe to do while the worker is running...
+  const uInt32 frames = tia.renderToFrameBuffer();
+
+  // ... and render it. This may block, but emulation will continue to run on
   // the worker, so the audio pipeline is kept fed :)
-  if (framePending) myFrameBuffer->updateInEmulationMode(myFpsMeter.fps());
+  if (frames > 0) {
+    myFpsMeter.render(frames);
+    myFrameBuffer->updateInEmulationMode(myFpsMeter.fps());
+  }
 
   // Stop the worker and wait until it has finished
   uInt64 totalCycles = emulationWorker.stop();
@@ -796,6 +803,11 @@ double OSystem::dispatchEmulation(EmulationWorker& emulationWorker)
       myEventHandler->frying())
     myConsole->fry();
 
+  // Run ahead (and back) to display the frame reflecting the latest input
+  if (dispatchResult.getStatus() == DispatchResult::Status::ok)
+    runAhead.update();
+  tia.setFramesHidden(false);
+
   // Return the 6507 time used in seconds
   return static_cast<double>(totalCycles) /
       static_cast<double>(timing.cyclesPerSecond());
@@ -28,6 +28,7 @@ class Sound;
 class StateManager;
 class TimerManager;
 class HighScoresManager;
+class HashManager;
 class EmulationWorker;
 class AudioSettings;
 #ifdef CHEATCODE_SUPPORT
@@ -156,6 +157,13 @@ class OSystem
       @return The highscore manager object
     */
     HighScoresManager& highScores() const { return *myHighScoresManager; }
+
+    /**
+      Get the ROM hash manager of the system.
+
+      @return The hash manager object
+    */
+    HashManager& hashManager() const { return *myHashManager; }
   #endif
 
     /**
@@ -446,6 +454,8 @@ class OSystem
 
     virtual shared_ptr<CompositeKeyValueRepositoryAtomic> getHighscoreRepository() = 0;
 
+    virtual shared_ptr<KeyValueRepositoryAtomic> getHashCacheRepository() = 0;
+
   protected:
 
     //////////////////////////////////////////////////////////////////////
@@ -541,6 +551,9 @@ class OSystem
   #ifdef GUI_SUPPORT
     // Pointer to the HighScoresManager object
     unique_ptr<HighScoresManager> myHighScoresManager;
+
+    // Pointer to the HashManager object
+    unique_ptr<HashManager> myHashManager;
   #endif
 
     // Indicates whether ROM launcher was ever opened during this run
@@ -48,3 +48,9 @@ shared_ptr<CompositeKeyValueRepositoryAtomic> OSystemStandalone::getHighscoreRep
 {
   return shared_ptr<CompositeKeyValueRepositoryAtomic>(myStellaDb, &myStellaDb->highscoreRepository());
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<KeyValueRepositoryAtomic> OSystemStandalone::getHashCacheRepository()
+{
+  return shared_ptr<KeyValueRepositoryAtomic>(myStellaDb, &myStellaDb->hashCacheRepository());
+}
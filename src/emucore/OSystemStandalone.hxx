@@ -34,6 +34,8 @@ class OSystemStandalone : public OSystem
 
     shared_ptr<CompositeKeyValueRepositoryAtomic> getHighscoreRepository() override;
 
+    shared_ptr<KeyValueRepositoryAtomic> getHashCacheRepository() override;
+
   protected:
 
     void initPersistence(FilesystemNode& basedir) override;
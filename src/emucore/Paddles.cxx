@@ -358,6 +358,61 @@ void Paddles::updateDigitalAxes()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Paddles::save(Serializer& out) const
+{
+  if(!Controller::save(out))
+    return false;
+
+  try
+  {
+    // The paddle positions are needed to continue the movement exactly
+    out.putInt(myCharge[0]);
+    out.putInt(myCharge[1]);
+    out.putInt(myLastCharge[0]);
+    out.putInt(myLastCharge[1]);
+    out.putInt(myPaddleRepeatA);
+    out.putInt(myPaddleRepeatB);
+    out.putBool(myKeyRepeatA);
+    out.putBool(myKeyRepeatB);
+    out.putInt(myLastAxisX);
+    out.putInt(myLastAxisY);
+  }
+  catch(...)
+  {
+    cerr << "ERROR: Paddles::save() exception\n";
+    return false;
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Paddles::load(Serializer& in)
+{
+  if(!Controller::load(in))
+    return false;
+
+  try
+  {
+    myCharge[0] = in.getInt();
+    myCharge[1] = in.getInt();
+    myLastCharge[0] = in.getInt();
+    myLastCharge[1] = in.getInt();
+    myPaddleRepeatA = in.getInt();
+    myPaddleRepeatB = in.getInt();
+    myKeyRepeatA = in.getBool();
+    myKeyRepeatB = in.getBool();
+    myLastAxisX = in.getInt();
+    myLastAxisY = in.getInt();
+  }
+  catch(...)
+  {
+    cerr << "ERROR: Paddles::load() exception\n";
+    return false;
+  }
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Paddles::setMouseControl(
     Controller::Type xtype, int xid, Controller::Type ytype, int yid)
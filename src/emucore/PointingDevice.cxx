@@ -94,6 +94,65 @@ void PointingDevice::update()
     myEvent.get(Event::MouseButtonLeftValue) || myEvent.get(Event::MouseButtonRightValue)));
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PointingDevice::save(Serializer& out) const
+{
+  if(!Controller::save(out))
+    return false;
+
+  try
+  {
+    // The movement in progress is needed to continue it exactly
+    out.putDouble(myHCounterRemainder);
+    out.putDouble(myVCounterRemainder);
+    out.putInt(myTrackBallLinesH);
+    out.putInt(myTrackBallLinesV);
+    out.putBool(myTrackBallLeft);
+    out.putBool(myTrackBallDown);
+    out.putByte(myCountH);
+    out.putByte(myCountV);
+    out.putInt(myScanCountH);
+    out.putInt(myScanCountV);
+    out.putInt(myFirstScanOffsetH);
+    out.putInt(myFirstScanOffsetV);
+  }
+  catch(...)
+  {
+    cerr << "ERROR: PointingDevice::save() exception\n";
+    return false;
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PointingDevice::load(Serializer& in)
+{
+  if(!Controller::load(in))
+    return false;
+
+  try
+  {
+    myHCounterRemainder = float(in.getDouble());
+    myVCounterRemainder = float(in.getDouble());
+    myTrackBallLinesH = Int32(in.getInt());
+    myTrackBallLinesV = Int32(in.getInt());
+    myTrackBallLeft = in.getBool();
+    myTrackBallDown = in.getBool();
+    myCountH = in.getByte();
+    myCountV = in.getByte();
+    myScanCountH = Int32(in.getInt());
+    myScanCountV = Int32(in.getInt());
+    myFirstScanOffsetH = Int32(in.getInt());
+    myFirstScanOffsetV = Int32(in.getInt());
+  }
+  catch(...)
+  {
+    cerr << "ERROR: PointingDevice::load() exception\n";
+    return false;
+  }
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool PointingDevice::setMouseControl(
     Controller::Type xtype, int xid, Controller::Type ytype, int yid)
@@ -15,14 +15,21 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
 
 #include "ProfilingRunner.hxx"
 #include "FSNode.hxx"
+#include "Bankswitch.hxx"
 #include "Cart.hxx"
 #include "CartCreator.hxx"
 #include "MD5.hxx"
+#include "Console.hxx"
 #include "Control.hxx"
 #include "M6502.hxx"
 #include "M6532.hxx"
@@ -31,11 +38,23 @@
 #include "FrameManager.hxx"
 #include "FrameLayoutDetector.hxx"
 #include "EmulationTiming.hxx"
-#include "ConsoleTiming.hxx"
 #include "System.hxx"
 #include "Joystick.hxx"
+#include "Booster.hxx"
+#include "Genesis.hxx"
+#include "Driving.hxx"
+#include "Keyboard.hxx"
+#include "Paddles.hxx"
+#include "AmigaMouse.hxx"
+#include "AtariMouse.hxx"
+#include "TrakBall.hxx"
+#include "MindLink.hxx"
+#include "Movie.hxx"
 #include "Random.hxx"
 #include "DispatchResult.hxx"
+#include "AudioQueue.hxx"
+#include "Serializer.hxx"
+#include "json_lib.hxx"
 
 using namespace std::chrono;
 
@@ -52,83 +71,392 @@ namespace {
       from++;
     }
   }
+
+  double ratio(double a, double b) {
+    return b > 0 ? a / b : 0.;
+  }
+
+  bool isMovie(const FilesystemNode& file) {
+    return BSPF::endsWithIgnoreCase(file.getName(), ".inp");
+  }
+
+  // Only controllers which need nothing but events can be replayed
+  unique_ptr<Controller> createController(Controller::Type type,
+      Controller::Jack jack, const Event& event, const System& system,
+      bool swapPaddles)
+  {
+    switch (type) {
+      case Controller::Type::Joystick:
+        return make_unique<Joystick>(jack, event, system);
+
+      case Controller::Type::BoosterGrip:
+        return make_unique<BoosterGrip>(jack, event, system);
+
+      case Controller::Type::Genesis:
+        return make_unique<Genesis>(jack, event, system);
+
+      case Controller::Type::Driving:
+        return make_unique<Driving>(jack, event, system);
+
+      case Controller::Type::Keyboard:
+        return make_unique<Keyboard>(jack, event, system);
+
+      case Controller::Type::Paddles:
+      case Controller::Type::PaddlesIAxis:
+      case Controller::Type::PaddlesIAxDr:
+        return make_unique<Paddles>(jack, event, system, swapPaddles,
+                                    type != Controller::Type::Paddles,
+                                    type == Controller::Type::PaddlesIAxDr);
+
+      case Controller::Type::AmigaMouse:
+        return make_unique<AmigaMouse>(jack, event, system);
+
+      case Controller::Type::AtariMouse:
+        return make_unique<AtariMouse>(jack, event, system);
+
+      case Controller::Type::TrakBall:
+        return make_unique<TrakBall>(jack, event, system);
+
+      case Controller::Type::MindLink:
+        return make_unique<MindLink>(jack, event, system);
+
+      default:
+        return nullptr;
+    }
+  }
+
+  // Apply a changed mouse control mode the way MouseControl does
+  void setMouseControl(Controller& left, Controller& right,
+                       const Movie::Record& record)
+  {
+    if (!record.hasMouseMode) return;
+
+    const MouseControl::MouseMode& mode = record.mouseMode;
+    left.setMouseControl(mode.xtype, mode.xid, mode.ytype, mode.yid);
+    right.setMouseControl(mode.xtype, mode.xid, mode.ytype, mode.yid);
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 ProfilingRunner::ProfilingRunner(int argc, char* argv[])
-  : profilingRuns{std::max<size_t>(argc - 2, 0)}
+  : myRuntime{RUNTIME_DEFAULT}
 {
-  for (int i = 2; i < argc; i++) {
-    ProfilingRun& run(profilingRuns[i-2]);
+  vector<string> roms;
 
+  for (int i = 2; i < argc; i++) {
     string arg = argv[i];
-    size_t splitPoint = arg.find_first_of(':');
 
-    run.romFile = splitPoint == string::npos ? arg : arg.substr(0, splitPoint);
+    if (arg.length() < 2 || arg[0] != '-') {
+      roms.push_back(arg);
+      continue;
+    }
+
+    if (arg != "-threads" && arg != "-runtime" && arg != "-audioqueue" &&
+        arg != "-savestates" && arg != "-report" && arg != "-reportfile") {
+      cerr << "ERROR: unknown option " << arg << endl;
+      myArgumentsValid = false;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      cerr << "ERROR: missing value for option " << arg << endl;
+      myArgumentsValid = false;
+      continue;
+    }
+
+    string value = argv[++i];
 
-    if (splitPoint == string::npos) run.runtime = RUNTIME_DEFAULT;
-    else  {
-      int runtime = BSPF::stringToInt(arg.substr(splitPoint+1, string::npos));
-      run.runtime = runtime > 0 ? runtime : RUNTIME_DEFAULT;
+    if (arg == "-threads") {
+      const int threads = BSPF::stringToInt(value);
+      myThreads = threads > 0
+        ? threads
+        : std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    else if (arg == "-runtime") {
+      const int runtime = BSPF::stringToInt(value);
+      myRuntime = runtime > 0 ? runtime : RUNTIME_DEFAULT;
+    }
+    else if (arg == "-audioqueue") {
+      const int runtime = BSPF::stringToInt(value);
+      myAudioQueueRuntime = runtime > 0 ? runtime : RUNTIME_DEFAULT;
+    }
+    else if (arg == "-savestates") {
+      const int states = BSPF::stringToInt(value);
+      mySaveStates = states > 0 ? states : 0;
+    }
+    else if (arg == "-report") {
+      BSPF::toLowerCase(value);
+      myReportFormat = value == "csv" ? ReportFormat::csv : ReportFormat::json;
     }
+    else if (arg == "-reportfile") {
+      myReportFile = value;
+      if (myReportFormat == ReportFormat::none)
+        myReportFormat = BSPF::endsWithIgnoreCase(value, ".csv")
+          ? ReportFormat::csv : ReportFormat::json;
+    }
+  }
+
+  // The runtime option applies to all ROMs without an explicit runtime,
+  // so the list can only be expanded once all options are known
+  for (const string& rom : roms)
+    addRun(rom);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProfilingRunner::addRun(const string& arg)
+{
+  size_t splitPoint = arg.find_last_of(':');
+  // Don't mistake a drive letter for a runtime
+  if (splitPoint != string::npos && splitPoint < 2) splitPoint = string::npos;
+
+  const string path = splitPoint == string::npos ? arg : arg.substr(0, splitPoint);
+  uInt32 runtime = myRuntime;
+
+  if (splitPoint != string::npos) {
+    const int secs = BSPF::stringToInt(arg.substr(splitPoint+1, string::npos));
+    runtime = secs > 0 ? secs : myRuntime;
   }
 
-  mySettings.setValue("fastscbios", true);
+  FilesystemNode node(path);
+
+  if (node.isDirectory()) {
+    FSList files;
+    node.getAllChildren(files, FilesystemNode::ListMode::All,
+      [](const FilesystemNode& file) {
+        return file.isFile() && (Bankswitch::isValidRomName(file) || isMovie(file));
+      }, false);
+
+    for (const auto& file : files)
+      profilingRuns.push_back({file.getPath(), runtime, isMovie(file)});
+  }
+  else
+    profilingRuns.push_back({path, runtime, isMovie(node)});
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool ProfilingRunner::run()
 {
+  // The errors have been reported while parsing the arguments
+  if (!myArgumentsValid) return false;
+
   cout << "Profiling Stella..." << endl;
 
-  for (ProfilingRun& run : profilingRuns) {
-    cout << endl << "running " << run.romFile << " for " << run.runtime << " seconds..." << endl;
+  profilingResults.clear();
+  profilingResults.resize(profilingRuns.size());
 
-    if (!runOne(run)) return false;
+  bool success = true;
+
+  if (myAudioQueueRuntime > 0)
+    success = runAudioQueueStress();
+
+  if (myThreads > 1 && profilingRuns.size() > 1) {
+    runParallel();
+
+    for (const ProfilingResult& result : profilingResults)
+      success = success && result.ok();
   }
+  else {
+    for (size_t i = 0; i < profilingRuns.size(); ++i) {
+      const ProfilingRun& run = profilingRuns[i];
+      ProfilingResult& result = profilingResults[i];
 
-  return true;
+      if (run.movie)
+        cout << endl << "replaying " << run.romFile << "..." << endl;
+      else
+        cout << endl << "running " << run.romFile << " for " << run.runtime << " seconds..." << endl;
+
+      if (!runOne(run, result, true)) {
+        cout << "ERROR: " << result.error << endl;
+
+        // Without a report, keep the old behaviour and stop on the first error
+        if (myReportFormat == ReportFormat::none) return false;
+        success = false;
+      }
+    }
+  }
+
+  if (myReportFormat != ReportFormat::none) {
+    if (myReportFile.empty())
+      writeReport(cout);
+    else {
+      std::ofstream out(myReportFile);
+
+      if (!out) {
+        cout << "ERROR: unable to write report to " << myReportFile << endl;
+        return false;
+      }
+      writeReport(out);
+      cout << endl << "report written to " << myReportFile << endl;
+    }
+  }
+
+  return success;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProfilingRunner::runParallel()
+{
+  const uInt32 threads = std::min<uInt32>(myThreads, uInt32(profilingRuns.size()));
+  std::atomic<size_t> nextRun{0};
+  std::mutex outputMutex;
+
+  cout << "running " << profilingRuns.size() << " ROMs on " << threads << " threads..." << endl;
+
+  auto worker = [&]() {
+    size_t i;
+
+    while ((i = nextRun++) < profilingRuns.size()) {
+      const ProfilingRun& run = profilingRuns[i];
+      ProfilingResult& result = profilingResults[i];
+
+      runOne(run, result, false);
+
+      ostringstream buf;
+      if (result.ok())
+        buf << run.romFile << " [" << result.cartType << "]: "
+            << std::fixed << std::setprecision(2) << result.speed() << "x real time, "
+            << result.framesPerSecond() << " fps";
+      else
+        buf << run.romFile << ": ERROR: " << result.error;
+
+      std::lock_guard<std::mutex> lock(outputMutex);
+      cout << buf.str() << endl;
+    }
+  };
+
+  vector<std::thread> workers;
+  workers.reserve(threads);
+
+  for (uInt32 i = 0; i < threads; ++i)
+    workers.emplace_back(worker);
+
+  for (auto& w : workers)
+    w.join();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool ProfilingRunner::runOne(const ProfilingRun& run)
+bool ProfilingRunner::runAudioQueueStress() const
 {
+  // Typical values for NTSC with the default audio settings
+  constexpr uInt32 fragmentSize = 512;
+  constexpr uInt32 capacity = 6;
+
+  cout << endl << "stress testing audio queue for " << myAudioQueueRuntime
+       << " seconds..." << endl;
+
+  AudioQueue queue(fragmentSize, capacity, true);
+  queue.ignoreOverflows(true);
+
+  // Every enqueued fragment is filled with its (truncated) sequence number,
+  // so the consumer can detect torn, duplicated or reordered fragments
+  std::atomic<bool> stop{false};
+  uInt64 produced = 0, overflows = 0;
+  uInt64 consumed = 0, underruns = 0, errors = 0;
+  nanoseconds maxEnqueue{0}, maxDequeue{0};
+
+  std::thread producer([&]() {
+    Int16* fragment = queue.enqueue();
+    uInt16 sequence = 0;
+
+    while (!stop.load(std::memory_order_relaxed)) {
+      std::fill_n(fragment, 2 * fragmentSize, Int16(sequence));
+
+      const auto start = high_resolution_clock::now();
+      Int16* next = queue.enqueue(fragment);
+      maxEnqueue = std::max(maxEnqueue, high_resolution_clock::now() - start);
+
+      if (next == fragment) ++overflows;
+      else {
+        ++produced;
+        ++sequence;
+        fragment = next;
+      }
+    }
+  });
+
+  std::thread consumer([&]() {
+    Int16* fragment = nullptr;
+    uInt16 expected = 0;
+
+    while (!stop.load(std::memory_order_relaxed)) {
+      const auto start = high_resolution_clock::now();
+      Int16* next = queue.dequeue(fragment);
+      maxDequeue = std::max(maxDequeue, high_resolution_clock::now() - start);
+
+      if (!next) {
+        ++underruns;
+        continue;
+      }
+
+      const Int16 value = Int16(expected++);
+      if (std::any_of(next, next + 2 * fragmentSize,
+                      [value](Int16 sample) { return sample != value; }))
+        ++errors;
+
+      ++consumed;
+      fragment = next;
+    }
+  });
+
+  std::this_thread::sleep_for(seconds(myAudioQueueRuntime));
+  stop = true;
+
+  producer.join();
+  consumer.join();
+
+  const auto micros = [](nanoseconds t) {
+    return duration_cast<duration<double, std::micro>>(t).count();
+  };
+
+  cout << std::fixed << std::setprecision(0)
+       << "fragments enqueued:   " << produced << " ("
+       << ratio(double(produced), myAudioQueueRuntime) << " / second)" << endl
+       << "fragments dequeued:   " << consumed << endl
+       << "overflows:            " << overflows << endl
+       << "empty dequeues:       " << underruns << endl
+       << std::setprecision(2)
+       << "max. enqueue time:    " << micros(maxEnqueue) << " us" << endl
+       << "max. dequeue time:    " << micros(maxDequeue) << " us" << endl
+       << "corrupted fragments:  " << errors << endl;
+
+  // At most all queued fragments may remain when the threads are stopped
+  return errors == 0 && consumed <= produced && produced - consumed <= capacity;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ProfilingRunner::runOne(const ProfilingRun& run, ProfilingResult& result,
+                             bool showProgress)
+{
+  if (run.movie) return runMovie(run, result, showProgress);
+
+  result.romFile = run.romFile;
+  result.runtime = run.runtime;
+
   FilesystemNode imageFile(run.romFile);
 
   if (!imageFile.isFile()) {
-    cout << "ERROR: " << run.romFile << " is not a ROM image" << endl;
-    return false;
-  }
-
-  ByteBuffer image;
-  size_t size = imageFile.read(image);
-  if (size == 0) {
-    cout << "ERROR: unable to read " << run.romFile << endl;
+    result.error = run.romFile + " is not a ROM image";
     return false;
   }
 
-  string md5 = MD5::hash(image, size);
-  string type = "";
-  unique_ptr<Cartridge> cartridge = CartCreator::create(
-      imageFile, image, size, md5, type, mySettings);
+  // Every run uses its own settings, so runs don't share any mutable state
+  Settings settings;
+  settings.setValue("fastscbios", true);
 
-  if (!cartridge) {
-    cout << "ERROR: unable to determine cartridge type" << endl;
-    return false;
-  }
+  unique_ptr<Cartridge> cartridge = createCartridge(imageFile, "", settings, result);
+  if (!cartridge) return false;
 
   IO consoleIO;
   Random rng(0);
   Event event;
 
-  M6502 cpu(mySettings);
-  M6532 riot(consoleIO, mySettings);
-  TIA tia(consoleIO, []() { return ConsoleTiming::ntsc; }, mySettings);
+  M6502 cpu(settings);
+  M6532 riot(consoleIO, settings);
+  TIA tia(consoleIO, []() { return ConsoleTiming::ntsc; }, settings);
   System system(rng, cpu, riot, tia, *cartridge);
 
   consoleIO.myLeftControl = make_unique<Joystick>(Controller::Jack::Left, event, system);
   consoleIO.myRightControl = make_unique<Joystick>(Controller::Jack::Right, event, system);
-  consoleIO.mySwitches = make_unique<Switches>(event, myProps, mySettings);
+  consoleIO.mySwitches = make_unique<Switches>(event, myProps, settings);
 
   tia.bindToControllers();
   cartridge->setStartBankFromPropsFunc([]() { return -1; });
@@ -138,7 +466,7 @@ bool ProfilingRunner::runOne(const ProfilingRun& run)
   tia.setFrameManager(&frameLayoutDetector);
   system.reset();
 
-  (cout << "detecting frame layout... ").flush();
+  if (showProgress) (cout << "detecting frame layout... ").flush();
   for(int i = 0; i < 60; ++i) tia.update();
 
   FrameLayout frameLayout = frameLayoutDetector.detectedLayout();
@@ -146,17 +474,17 @@ bool ProfilingRunner::runOne(const ProfilingRun& run)
 
   switch (frameLayout) {
     case FrameLayout::ntsc:
-      cout << "NTSC";
+      result.layout = "NTSC";
       consoleTiming = ConsoleTiming::ntsc;
       break;
 
     case FrameLayout::pal:
-      cout << "PAL";
+      result.layout = "PAL";
       consoleTiming = ConsoleTiming::pal;
       break;
   }
 
-  (cout << endl).flush();
+  if (showProgress) (cout << result.layout << endl).flush();
 
   FrameManager frameManager;
   tia.setFrameManager(&frameManager);
@@ -166,13 +494,18 @@ bool ProfilingRunner::runOne(const ProfilingRun& run)
 
   EmulationTiming emulationTiming(frameLayout, consoleTiming);
   uInt64 cycles = 0;
+  uInt64 frames = 0;
   uInt64 cyclesTarget = uInt64(run.runtime) * emulationTiming.cyclesPerSecond();
 
   DispatchResult dispatchResult;
   dispatchResult.setOk(0);
 
   uInt32 percent = 0;
-  (cout << "0%").flush();
+  if (showProgress) (cout << "0%").flush();
+
+#ifdef PERFSTATS_SUPPORT
+  PerfStats::resetTotals();
+#endif
 
   time_point<high_resolution_clock> tp = high_resolution_clock::now();
 
@@ -180,23 +513,548 @@ bool ProfilingRunner::runOne(const ProfilingRun& run)
     tia.update(dispatchResult);
     cycles += dispatchResult.getCycles();
 
-    if (tia.newFramePending()) tia.renderToFrameBuffer();
+    frames += tia.renderToFrameBuffer();
 
-    uInt32 percentNow = uInt32(std::min((100 * cycles) / cyclesTarget, static_cast<uInt64>(100)));
-    updateProgress(percent, percentNow);
+    if (showProgress) {
+      uInt32 percentNow = uInt32(std::min((100 * cycles) / cyclesTarget, static_cast<uInt64>(100)));
+      updateProgress(percent, percentNow);
 
-    percent = percentNow;
+      percent = percentNow;
+    }
   }
 
-  double realtimeUsed = duration_cast<duration<double>>(high_resolution_clock::now () - tp).count();
+  result.realtimeUsed = duration_cast<duration<double>>(high_resolution_clock::now () - tp).count();
+  result.cycles = cycles;
+  result.frames = frames;
+  result.emulatedTime = double(cycles) / emulationTiming.cyclesPerSecond();
+#ifdef PERFSTATS_SUPPORT
+  result.perfStats = PerfStats::totals();
+#endif
 
   if (dispatchResult.getStatus() != DispatchResult::Status::ok) {
-    cout << endl << "ERROR: emulation failed after " << cycles << " cycles";
+    result.error = "emulation failed after " + std::to_string(cycles) + " cycles";
+    if (showProgress) cout << endl;
+    return false;
+  }
+
+  if (mySaveStates > 0 && !benchmarkStates(system, consoleIO, result)) {
+    if (showProgress) cout << endl;
+    return false;
+  }
+
+  if (showProgress) {
+    (cout << "100%" << endl).flush();
+    cout << "real time: " << result.realtimeUsed << " seconds" << endl;
+  #ifdef PERFSTATS_SUPPORT
+    printPerfStats(result);
+  #endif
+    if (mySaveStates > 0)
+      cout << "state size: " << result.stateSize << " bytes" << endl
+           << std::fixed << std::setprecision(2)
+           << "save/load (arena):  " << result.arenaSave << " / "
+           << result.arenaLoad << " us" << endl
+           << "save/load (stream): " << result.streamSave << " / "
+           << result.streamLoad << " us" << endl;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ProfilingRunner::runMovie(const ProfilingRun& run, ProfilingResult& result,
+                               bool showProgress)
+{
+  result.romFile = run.romFile;
+
+  Movie movie;
+  if (!movie.open(run.romFile)) {
+    result.error = run.romFile + " is not a valid movie";
+    return false;
+  }
+
+  acquireInputSettings(movie);
+  const bool ok = replayMovie(run, movie, result, showProgress);
+  releaseInputSettings();
+
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ProfilingRunner::replayMovie(const ProfilingRun& run, Movie& movie,
+                                  ProfilingResult& result, bool showProgress)
+{
+  const Movie::Info& info = movie.info();
+
+  // Look for the ROM where it was recorded, and next to the movie
+  FilesystemNode imageFile(info.romFile);
+  if (!imageFile.isFile()) {
+    imageFile = FilesystemNode(run.romFile).getParent();
+    imageFile /= FilesystemNode(info.romFile).getName();
+  }
+
+  Settings settings;
+  settings.setValue("fastscbios", true);
+  movie.applySettings(settings);
+
+  unique_ptr<Cartridge> cartridge = createCartridge(imageFile, info.cartType, settings, result);
+  if (!cartridge) return false;
+
+  if (result.md5 != info.md5) {
+    result.error = imageFile.getPath() + " is not the ROM the movie was recorded with";
+    return false;
+  }
+  result.layout = info.layout == FrameLayout::pal ? "PAL" : "NTSC";
+
+  IO consoleIO;
+  Random rng(0);
+  Event event;
+
+  const ConsoleTiming consoleTiming = info.timing;
+  M6502 cpu(settings);
+  M6532 riot(consoleIO, settings);
+  TIA tia(consoleIO, [consoleTiming]() { return consoleTiming; }, settings);
+  System system(rng, cpu, riot, tia, *cartridge);
+
+  consoleIO.myLeftControl = createController(info.leftType, info.leftJack, event, system, info.swapPaddles);
+  consoleIO.myRightControl = createController(info.rightType, info.rightJack, event, system, info.swapPaddles);
+  consoleIO.mySwitches = make_unique<Switches>(event, myProps, settings);
+
+  if (!consoleIO.myLeftControl || !consoleIO.myRightControl) {
+    result.error = "unsupported controllers " + Controller::getName(info.leftType) +
+      "/" + Controller::getName(info.rightType);
     return false;
   }
 
-  (cout << "100%" << endl).flush();
-  cout << "real time: " << realtimeUsed << " seconds" << endl;
+  tia.bindToControllers();
+  cartridge->setStartBankFromPropsFunc([]() { return -1; });
+  system.initialize();
+
+  FrameManager frameManager;
+  tia.setFrameManager(&frameManager);
+  tia.setLayout(info.layout);
+  system.reset();
+
+  EmulationTiming emulationTiming(info.layout, consoleTiming);
+  DispatchResult dispatchResult;
+
+  Movie::Record record;
+  uInt64 frames = 0;
+
+  if (showProgress) (cout << "0 frames").flush();
+
+#ifdef PERFSTATS_SUPPORT
+  PerfStats::resetTotals();
+#endif
+
+  time_point<high_resolution_clock> tp = high_resolution_clock::now();
+
+  try {
+    Serializer state;
+    movie.start(state, event, record);
+
+    if (!Console::loadState(system, consoleIO, state))
+      result.error = "invalid initial state";
+    setMouseControl(*consoleIO.myLeftControl, *consoleIO.myRightControl, record);
+
+    // Emulate up to each input poll, and update the controllers and switches
+    // from the events there, like the event handler does.  Emulation errors
+    // don't stop the replay, since they didn't stop the recording either.
+    while (result.ok() && movie.next(record, event)) {
+      while (system.cycles() < record.cycles) {
+        tia.update(dispatchResult, record.cycles - system.cycles());
+        frames += tia.renderToFrameBuffer();
+      }
+
+      if (system.cycles() != record.cycles)
+        result.error = "input " + std::to_string(movie.records()) + " missed";
+      else {
+        setMouseControl(*consoleIO.myLeftControl, *consoleIO.myRightControl, record);
+        riot.update();
+        if (record.hasSwitches)
+          Movie::applySwitches(*consoleIO.mySwitches, record.switches);
+        movie.endPoll(event);
+
+        if (record.hasChecksum) {
+          if (movie.checksum(system) == record.checksum)
+            ++result.checksums;
+          else
+            result.error = "state checksum differs at input " + std::to_string(movie.records());
+        }
+      }
+
+      if (showProgress && movie.records() % 600 == 0)
+        (cout << "\r" << movie.records() << " frames").flush();
+    }
+  }
+  catch(const runtime_error&) {
+    result.error = run.romFile + " is truncated or corrupt";
+  }
+
+  result.realtimeUsed = duration_cast<duration<double>>(high_resolution_clock::now () - tp).count();
+  result.cycles = system.cycles() - info.startCycles;
+  result.frames = frames;
+  result.emulatedTime = double(result.cycles) / emulationTiming.cyclesPerSecond();
+  result.runtime = uInt32(std::lround(result.emulatedTime));
+#ifdef PERFSTATS_SUPPORT
+  result.perfStats = PerfStats::totals();
+#endif
+
+  if (showProgress) cout << "\r" << movie.records() << " frames" << endl;
+  if (!result.ok()) return false;
+
+  if (showProgress) {
+    cout << "checksums verified: " << result.checksums << endl
+         << "real time: " << result.realtimeUsed << " seconds" << endl;
+  #ifdef PERFSTATS_SUPPORT
+    printPerfStats(result);
+  #endif
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProfilingRunner::acquireInputSettings(const Movie& movie)
+{
+  const string inputSettings = movie.inputSettings();
+  std::unique_lock<std::mutex> lock(myInputMutex);
+
+  // Wait until no replay with other input settings is running anymore
+  myInputChanged.wait(lock, [&]() {
+    return myInputUsers == 0 || myInputSettings == inputSettings;
+  });
+
+  if (myInputSettings != inputSettings) {
+    movie.applyInputSettings();
+    myInputSettings = inputSettings;
+  }
+  ++myInputUsers;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProfilingRunner::releaseInputSettings()
+{
+  std::lock_guard<std::mutex> lock(myInputMutex);
+
+  if (--myInputUsers == 0) myInputChanged.notify_all();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<Cartridge> ProfilingRunner::createCartridge(
+    const FilesystemNode& imageFile, const string& type, Settings& settings,
+    ProfilingResult& result) const
+{
+  ByteBuffer image;
+  size_t size = 0;
+  unique_ptr<Cartridge> cartridge;
+
+  try {
+    size = imageFile.read(image);
+    if (size == 0) {
+      result.error = "unable to read " + imageFile.getPath();
+      return nullptr;
+    }
+
+    result.md5 = MD5::hash(image, size);
+    cartridge = CartCreator::create(
+        imageFile, image, size, result.md5, type, settings);
+  }
+  catch(const runtime_error& e) {
+    result.error = e.what();
+    return nullptr;
+  }
+
+  if (!cartridge) {
+    result.error = "unable to determine cartridge type";
+    return nullptr;
+  }
+  result.cartType = cartridge->detectedType();
+
+  return cartridge;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ProfilingRunner::benchmarkStates(System& system, const IO& consoleIO,
+                                      ProfilingResult& result) const
+{
+  // The same data as a console state
+  const auto save = [&](Serializer& out) {
+    return Console::saveState(system, consoleIO, out);
+  };
+  const auto load = [&](Serializer& in) {
+    return Console::loadState(system, consoleIO, in);
+  };
+
+  // Average time of one save or load in microseconds; the serializer is
+  // reused, like the time machine does
+  const auto measure = [&](Serializer& s, const auto& op, double& micros) {
+    const auto start = high_resolution_clock::now();
+    for (uInt32 i = 0; i < mySaveStates; ++i) {
+      s.rewind();
+      if (!op(s)) return false;
+    }
+    micros = duration_cast<duration<double, std::micro>>(
+      high_resolution_clock::now() - start).count() / mySaveStates;
+
+    return true;
+  };
+
+  Serializer arena;
+  Serializer stream(make_unique<stringstream>(std::ios::in | std::ios::out | std::ios::binary));
+
+  // Loading a state over and over must not change it.  Loading resets
+  // some caches (eg. the TIA line cache), so the reference state is taken
+  // after one round trip.
+  Serializer before, after;
+  bool ok = save(before);
+  before.rewind();
+  ok = ok && load(before);
+  before.rewind();
+
+  ok = ok && save(before) &&
+    measure(arena, save, result.arenaSave) && measure(arena, load, result.arenaLoad) &&
+    measure(stream, save, result.streamSave) && measure(stream, load, result.streamLoad) &&
+    save(after);
+
+  if (ok && before.size() == after.size()) {
+    vector<uInt8> a(before.size()), b(after.size());
+    before.getByteArray(a.data(), a.size());
+    after.getByteArray(b.data(), b.size());
+    ok = a == b;
+  }
+  else
+    ok = false;
+
+  if (!ok) {
+    result.error = "save state benchmark failed";
+    return false;
+  }
+  result.stateSize = before.size();
 
   return true;
 }
+
+#ifdef PERFSTATS_SUPPORT
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProfilingRunner::printPerfStats(const ProfilingResult& result) const
+{
+  uInt64 total = 0;
+  for (const auto& counter : result.perfStats)
+    total += counter.time;
+
+  const auto flags = cout.flags();
+  const auto precision = cout.precision();
+
+  cout << "time per subsystem (ms per frame, share, calls per frame):" << endl;
+
+  for (size_t i = 0; i < PerfStats::NUM_SECTIONS; ++i) {
+    const PerfStats::Counter& counter = result.perfStats[i];
+
+    cout << "  " << std::left << std::setw(12) << PerfStats::name(PerfStats::Section(i))
+         << std::right << std::fixed
+         << std::setw(9) << std::setprecision(3) << ratio(counter.time / 1000000., double(result.frames))
+         << std::setw(7) << std::setprecision(1) << ratio(100. * counter.time, double(total)) << "%"
+         << std::setw(12) << std::setprecision(0) << ratio(double(counter.calls), double(result.frames))
+         << endl;
+  }
+  cout.flags(flags);
+  cout.precision(precision);
+}
+#endif
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<ProfilingRunner::Aggregate> ProfilingRunner::aggregate() const
+{
+  std::map<string, Aggregate> aggregates;
+
+  for (const ProfilingResult& result : profilingResults) {
+    if (!result.ok()) continue;
+
+    Aggregate& agg = aggregates[result.cartType];
+    const double speed = result.speed();
+
+    if (agg.roms == 0) {
+      agg.cartType = result.cartType;
+      agg.minSpeed = agg.maxSpeed = speed;
+    }
+    else {
+      agg.minSpeed = std::min(agg.minSpeed, speed);
+      agg.maxSpeed = std::max(agg.maxSpeed, speed);
+    }
+
+    ++agg.roms;
+    agg.cycles += result.cycles;
+    agg.frames += result.frames;
+    agg.emulatedTime += result.emulatedTime;
+    agg.realtimeUsed += result.realtimeUsed;
+  }
+
+  vector<Aggregate> list;
+  list.reserve(aggregates.size());
+  for (const auto& [type, agg] : aggregates)
+    list.push_back(agg);
+
+  return list;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProfilingRunner::writeReport(ostream& out) const
+{
+  if (myReportFormat == ReportFormat::csv)
+    writeCsv(out);
+  else
+    writeJson(out);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProfilingRunner::writeJson(ostream& out) const
+{
+  using nlohmann::json;
+
+  json roms = json::array();
+  for (const ProfilingResult& result : profilingResults) {
+    json rom = {
+      {"rom", result.romFile},
+      {"type", result.cartType},
+      {"md5", result.md5},
+      {"layout", result.layout},
+      {"runtime", result.runtime},
+      {"ok", result.ok()}
+    };
+
+    if (result.ok()) {
+      rom["cycles"] = result.cycles;
+      rom["frames"] = result.frames;
+      rom["emulatedSeconds"] = result.emulatedTime;
+      rom["realSeconds"] = result.realtimeUsed;
+      rom["cyclesPerSecond"] = result.cyclesPerSecond();
+      rom["framesPerSecond"] = result.framesPerSecond();
+      rom["speed"] = result.speed();
+      if (result.checksums > 0)
+        rom["checksums"] = result.checksums;
+    #ifdef PERFSTATS_SUPPORT
+      json sections = json::object();
+      for (size_t i = 0; i < PerfStats::NUM_SECTIONS; ++i)
+        sections[PerfStats::name(PerfStats::Section(i))] = {
+          {"seconds", result.perfStats[i].time / 1000000000.},
+          {"calls", result.perfStats[i].calls}
+        };
+      rom["sections"] = sections;
+    #endif
+      if (result.stateSize > 0)
+        rom["states"] = {
+          {"size", result.stateSize},
+          {"arenaSaveMicros", result.arenaSave},
+          {"arenaLoadMicros", result.arenaLoad},
+          {"streamSaveMicros", result.streamSave},
+          {"streamLoadMicros", result.streamLoad}
+        };
+    }
+    else
+      rom["error"] = result.error;
+
+    roms.push_back(rom);
+  }
+
+  json types = json::object();
+  for (const Aggregate& agg : aggregate())
+    types[agg.cartType] = {
+      {"roms", agg.roms},
+      {"cycles", agg.cycles},
+      {"frames", agg.frames},
+      {"emulatedSeconds", agg.emulatedTime},
+      {"realSeconds", agg.realtimeUsed},
+      {"cyclesPerSecond", agg.cyclesPerSecond()},
+      {"framesPerSecond", agg.framesPerSecond()},
+      {"speed", agg.speed()},
+      {"minSpeed", agg.minSpeed},
+      {"maxSpeed", agg.maxSpeed}
+    };
+
+  const json report = {
+    {"threads", myThreads},
+    {"roms", roms},
+    {"types", types}
+  };
+
+  out << report.dump(2) << endl;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ProfilingRunner::writeCsv(ostream& out) const
+{
+  // Quote a field if necessary
+  const auto field = [](const string& s) {
+    if (s.find_first_of(",\"\n") == string::npos) return s;
+
+    string quoted = "\"";
+    for (char c : s) {
+      if (c == '"') quoted += '"';
+      quoted += c;
+    }
+    return quoted + "\"";
+  };
+
+  out << "record,name,type,md5,layout,roms,cycles,frames,emulated_seconds,"
+         "real_seconds,cycles_per_second,frames_per_second,speed,min_speed,"
+         "max_speed,error" << endl;
+
+  for (const ProfilingResult& result : profilingResults) {
+    out << "rom," << field(result.romFile) << ',' << field(result.cartType) << ','
+        << result.md5 << ',' << result.layout << ",1,";
+
+    if (result.ok())
+      out << result.cycles << ',' << result.frames << ','
+          << result.emulatedTime << ',' << result.realtimeUsed << ','
+          << result.cyclesPerSecond() << ',' << result.framesPerSecond() << ','
+          << result.speed() << ',' << result.speed() << ',' << result.speed() << ",";
+    else
+      out << ",,,,,,,,," << field(result.error);
+
+    out << endl;
+  }
+
+  for (const Aggregate& agg : aggregate())
+    out << "type," << field(agg.cartType) << ',' << field(agg.cartType) << ",,,"
+        << agg.roms << ',' << agg.cycles << ',' << agg.frames << ','
+        << agg.emulatedTime << ',' << agg.realtimeUsed << ','
+        << agg.cyclesPerSecond() << ',' << agg.framesPerSecond() << ','
+        << agg.speed() << ',' << agg.minSpeed << ',' << agg.maxSpeed << ','
+        << endl;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double ProfilingRunner::ProfilingResult::cyclesPerSecond() const
+{
+  return ratio(double(cycles), realtimeUsed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double ProfilingRunner::ProfilingResult::framesPerSecond() const
+{
+  return ratio(double(frames), realtimeUsed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double ProfilingRunner::ProfilingResult::speed() const
+{
+  return ratio(emulatedTime, realtimeUsed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double ProfilingRunner::Aggregate::cyclesPerSecond() const
+{
+  return ratio(double(cycles), realtimeUsed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double ProfilingRunner::Aggregate::framesPerSecond() const
+{
+  return ratio(double(frames), realtimeUsed);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double ProfilingRunner::Aggregate::speed() const
+{
+  return ratio(emulatedTime, realtimeUsed);
+}
@@ -18,13 +18,51 @@
 #ifndef PROFILING_RUNNER
 #define PROFILING_RUNNER
 
+#include <condition_variable>
+#include <mutex>
+
 #include "bspf.hxx"
 #include "Control.hxx"
 #include "Switches.hxx"
 #include "Settings.hxx"
 #include "ConsoleIO.hxx"
 #include "Props.hxx"
-
+#include "PerfStats.hxx"
+
+class Cartridge;
+class FilesystemNode;
+class Movie;
+class System;
+
+/**
+  Headless runner for profiling and benchmarking the emulation core.
+
+  Usage:
+    stella -profile [-threads N] [-runtime SECS] [-report json|csv]
+                    [-reportfile FILE] [-audioqueue SECS] [-savestates N]
+                    rom[:secs] | movie | dir[:secs] ...
+
+  Directories are scanned recursively for ROM images.  Each ROM is run on
+  its own, fully independent System (CPU, RIOT, TIA, cartridge), so several
+  ROMs can be emulated in parallel on a pool of worker threads.  An optional
+  machine-readable report contains the per-ROM results and aggregates per
+  bankswitching type.
+
+  Movies (files with the extension '.inp', see Movie and the '-movie'
+  option) are replayed from start to end, as fast as possible and with the
+  inputs applied at exactly the recorded cycles.  This makes recorded
+  sessions usable as deterministic workloads; a replay fails if any of the
+  recorded state checksums doesn't match.  Since the input settings of the
+  controllers (e.g. the paddle sensitivity) are global, movies recorded
+  with different input settings are not replayed at the same time.
+
+  '-audioqueue' additionally stress tests the audio queue, with one thread
+  producing and one thread consuming fragments as fast as possible.
+
+  '-savestates' saves and loads the full console state N times after each
+  run, both in the in-memory arena and through a stream, and reports the
+  latency of either.
+*/
 class ProfilingRunner {
   public:
 
@@ -34,9 +72,58 @@ class ProfilingRunner {
 
   private:
 
+    enum class ReportFormat { none, json, csv };
+
     struct ProfilingRun {
       string romFile;
-      uInt32 runtime;
+      uInt32 runtime{0};
+      bool movie{false};
+    };
+
+    struct ProfilingResult {
+      string romFile;
+      string cartType;
+      string md5;
+      string layout;
+      string error;
+
+      uInt32 runtime{0};
+      uInt64 cycles{0};
+      uInt64 frames{0};
+      double emulatedTime{0.};
+      double realtimeUsed{0.};
+
+      // Verified state checksums (movies only)
+      uInt32 checksums{0};
+
+    #ifdef PERFSTATS_SUPPORT
+      PerfStats::Counters perfStats;
+    #endif
+
+      // Save state latencies in microseconds (only with '-savestates')
+      size_t stateSize{0};
+      double arenaSave{0.}, arenaLoad{0.};
+      double streamSave{0.}, streamLoad{0.};
+
+      bool ok() const { return error.empty(); }
+      double cyclesPerSecond() const;
+      double framesPerSecond() const;
+      double speed() const;
+    };
+
+    struct Aggregate {
+      string cartType;
+      uInt32 roms{0};
+      uInt64 cycles{0};
+      uInt64 frames{0};
+      double emulatedTime{0.};
+      double realtimeUsed{0.};
+      double minSpeed{0.};
+      double maxSpeed{0.};
+
+      double cyclesPerSecond() const;
+      double framesPerSecond() const;
+      double speed() const;
     };
 
     struct IO: public ConsoleIO {
@@ -51,15 +138,65 @@ class ProfilingRunner {
 
   private:
 
-    bool runOne(const ProfilingRun& run);
+    void addRun(const string& arg);
+
+    bool runOne(const ProfilingRun& run, ProfilingResult& result,
+                bool showProgress);
+
+    bool runMovie(const ProfilingRun& run, ProfilingResult& result,
+                  bool showProgress);
+
+    bool replayMovie(const ProfilingRun& run, Movie& movie,
+                     ProfilingResult& result, bool showProgress);
+
+    void acquireInputSettings(const Movie& movie);
+    void releaseInputSettings();
+
+    unique_ptr<Cartridge> createCartridge(const FilesystemNode& imageFile,
+                                          const string& type,
+                                          Settings& settings,
+                                          ProfilingResult& result) const;
+
+    void runParallel();
+
+    bool runAudioQueueStress() const;
+
+    bool benchmarkStates(System& system, const IO& consoleIO,
+                         ProfilingResult& result) const;
+
+    vector<Aggregate> aggregate() const;
+
+  #ifdef PERFSTATS_SUPPORT
+    void printPerfStats(const ProfilingResult& result) const;
+  #endif
+
+    void writeReport(ostream& out) const;
+    void writeJson(ostream& out) const;
+    void writeCsv(ostream& out) const;
 
   private:
 
     vector<ProfilingRun> profilingRuns;
+    vector<ProfilingResult> profilingResults;
 
-    Settings mySettings;
+    uInt32 myRuntime{0};
+    uInt32 myThreads{1};
+    uInt32 myAudioQueueRuntime{0};
+    uInt32 mySaveStates{0};
+    ReportFormat myReportFormat{ReportFormat::none};
+    string myReportFile;
+
+    // Unknown options or missing option values make the run fail
+    bool myArgumentsValid{true};
 
     Properties myProps;
+
+    // The input settings currently applied, and the number of replays using
+    // them
+    std::mutex myInputMutex;
+    std::condition_variable myInputChanged;
+    string myInputSettings;
+    uInt32 myInputUsers{0};
 };
 
 #endif // PROFILING_RUNNER
@@ -150,6 +150,13 @@ bool QuadTari::isAnalog() const
   return myFirstController->isAnalog();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool QuadTari::hasExternalState() const
+{
+  return myFirstController->hasExternalState() ||
+         mySecondController->hasExternalState();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool QuadTari::setMouseControl(
     Controller::Type xtype, int xid, Controller::Type ytype, int yid)
@@ -76,6 +76,12 @@ class QuadTari : public Controller
     */
     bool isAnalog() const override;
 
+    /**
+      Answers whether the controller has state outside of its save state.
+      Depends on the attached controllers.
+    */
+    bool hasExternalState() const override;
+
     /**
       Determines how this controller will treat values received from the
       X/Y axis and left/right buttons of the mouse.  Since not all controllers
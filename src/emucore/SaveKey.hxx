@@ -90,6 +90,12 @@ class SaveKey : public Controller
     */
     string name() const override { return "SaveKey"; }
 
+    /**
+      Answers whether the controller has state outside of its save state.
+      The EEPROM is neither saved nor restored, and is written to a file.
+    */
+    bool hasExternalState() const override { return true; }
+
     /**
       Notification method invoked by the system after its reset method has
       been called.  It may be necessary to override this method for
@@ -18,6 +18,8 @@
 #ifndef SERIALIZABLE_HXX
 #define SERIALIZABLE_HXX
 
+#include <functional>
+
 #include "Serializer.hxx"
 
 /**
@@ -29,6 +31,14 @@
 */
 class Serializable
 {
+  public:
+    /**
+      Called by objects consisting of several devices (see System and
+      Console) before the state of each device is saved, e.g. to determine
+      where the state of each device starts.
+    */
+    using SaveHook = std::function<void()>;
+
   public:
     Serializable() = default;
     virtual ~Serializable() = default;
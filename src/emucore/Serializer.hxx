@@ -25,6 +25,11 @@
   read from/written to a binary stream in a system-independent way.  The
   stream can be either an actual file, or an in-memory structure.
 
+  In-memory data is kept in a contiguous byte arena, which only grows
+  when it is too small.  Rewinding keeps the arena, so a serializer that
+  is reused (eg. for the time machine) never reallocates once it has
+  reached the size of a state.
+
   Bytes are written as characters, shorts as 2 characters (16-bits),
   integers as 4 characters (32-bits), long integers as 8 bytes (64-bits),
   strings are written as characters prepended by the length of the string,
@@ -50,14 +55,25 @@ class Serializer
       was correctly initialized.
     */
     explicit Serializer(const string& filename, Mode m = Mode::ReadWrite);
+
+    /**
+      Creates a new in-memory Serializer device, backed by a byte arena.
+    */
     Serializer();
 
+    /**
+      Creates a new Serializer device streaming to/from the given stream
+      (eg. a stringstream).  Mostly useful for benchmarking the stream
+      code path against the in-memory arena.
+    */
+    explicit Serializer(unique_ptr<iostream> stream);
+
   public:
     /**
       Answers whether the serializer is currently initialized for reading
       and writing.
     */
-    explicit operator bool() const { return myStream != nullptr; }
+    explicit operator bool() const { return myStream != nullptr || myInMemory; }
 
     /**
       Resets the read/write location to the beginning of the stream.
@@ -65,10 +81,23 @@ class Serializer
     void rewind();
 
     /**
-      Returns the current write pointer location.
+      Resets the read/write location like rewind(), and additionally
+      discards all in-memory data (the arena itself is kept).
+    */
+    void reset();
+
+    /**
+      Returns the current write pointer location (streams), or the amount
+      of data stored (in-memory).
     */
     size_t size() const;
 
+    /**
+      Returns the data stored in-memory, or nullptr for streams.  The
+      pointer is only valid until the next write.
+    */
+    const uInt8* data() const { return myInMemory ? myBuffer.get() : nullptr; }
+
     /**
       Reads a byte value (unsigned 8-bit) from the current input stream.
 
@@ -216,11 +245,35 @@ class Serializer
     void putBool(bool b);
 
   private:
-    // The stream to send the serialized data to.
+    /**
+      Copy raw data from/to the stream or the in-memory arena.
+    */
+    void read(void* data, size_t size) const;
+    void write(const void* data, size_t size);
+
+    /**
+      Make sure the arena can hold at least the given number of bytes.
+    */
+    void reserve(size_t size);
+
+  private:
+    // The stream to send the serialized data to (not used in-memory)
     unique_ptr<iostream> myStream;
 
+    // The in-memory arena; 'myEnd' is the amount of valid data, which
+    // (like in a stream) is not reduced by rewinding and overwriting
+    bool myInMemory{false};
+    ByteBuffer myBuffer;
+    size_t myCapacity{0};
+    size_t myEnd{0};
+    size_t myWritePos{0};
+    mutable size_t myReadPos{0};
+
     static constexpr uInt8 TruePattern = 0xfe, FalsePattern = 0x01;
 
+    // Initial arena size, large enough for most states
+    static constexpr size_t MIN_CAPACITY = 4_KB;
+
   private:
     // Following constructors and assignment operators not supported
     Serializer(const Serializer&) = delete;
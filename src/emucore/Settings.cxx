@@ -23,6 +23,8 @@
 #include "AudioSettings.hxx"
 #include "PaletteHandler.hxx"
 #include "Paddles.hxx"
+#include "AtariNTSC.hxx"
+#include "RunAheadManager.hxx"
 
 #ifdef DEBUGGER_SUPPORT
   #include "DebuggerDialog.hxx"
@@ -42,6 +44,7 @@ Settings::Settings()
   // Video-related options
   setPermanent("video", "");
   setPermanent("speed", "1.0");
+  setPermanent("runahead", 0);
   setPermanent("vsync", "true");
   setPermanent("center", "true");
   setPermanent("windowedpos", Common::Point(50, 50));
@@ -96,6 +99,7 @@ Settings::Settings()
   setPermanent(AudioSettings::SETTING_RESAMPLING_QUALITY, static_cast<int>(AudioSettings::DEFAULT_RESAMPLING_QUALITY));
   setPermanent(AudioSettings::SETTING_HEADROOM, AudioSettings::DEFAULT_HEADROOM);
   setPermanent(AudioSettings::SETTING_BUFFER_SIZE, AudioSettings::DEFAULT_BUFFER_SIZE);
+  setPermanent(AudioSettings::SETTING_ADAPTIVE, AudioSettings::DEFAULT_ADAPTIVE);
   setPermanent(AudioSettings::SETTING_STEREO, AudioSettings::DEFAULT_STEREO);
   setPermanent(AudioSettings::SETTING_DPC_PITCH, AudioSettings::DEFAULT_DPC_PITCH);
 
@@ -133,6 +137,8 @@ Settings::Settings()
   setPermanent("ssinterval", "2");
   setPermanent("autoslot", "false");
   setPermanent("saveonexit", "none");
+  setTemporary("movie", "");
+  setPermanent("moviechecksum", "60");
 
   // Config files and paths
   setPermanent("romdir", "");
@@ -177,6 +183,7 @@ Settings::Settings()
   setPermanent("avoxport", "");
   setPermanent("fastscbios", "true");
   setPermanent("threads", "false");
+  setPermanent("threadcount", "0");
   setTemporary("romloadcount", "0");
   setTemporary("maxres", "");
   setPermanent("initials", "");
@@ -294,6 +301,12 @@ void Settings::validate()
   f = getFloat("speed");
   if (f <= 0) setValue("speed", "1.0");
 
+  i = getInt("runahead");
+  if(i < 0 || i > int(RunAheadManager::MAX_FRAMES))  setValue("runahead", 0);
+
+  i = getInt("moviechecksum");
+  if(i < 0)  setValue("moviechecksum", 60);
+
   i = getInt("tia.vsizeadjust");
   if(i < -5 || i > 5)  setValue("tia.vsizeadjust", 0);
 
@@ -310,6 +323,9 @@ void Settings::validate()
   i = getInt("tv.filter");
   if(i < 0 || i > 5)  setValue("tv.filter", "0");
 
+  i = getInt("threadcount");
+  if(i < 0 || i > int(AtariNTSC::MAX_THREADS))  setValue("threadcount", "0");
+
   i = getInt("dev.tv.jitter_recovery");
   if(i < 1 || i > 20) setValue("dev.tv.jitter_recovery", "2");
 
@@ -454,6 +470,7 @@ void Settings::usage() const
     << endl
     << "  -speed        <number>       Run emulation at the given speed\n"
     << "  -turbo        <1|0>          Enable 'Turbo' mode for maximum emulation speed\n"
+    << "  -runahead     <0-4>          Run the given number of frames ahead to hide input lag\n"
     << "  -uimessages   <1|0>          Show onscreen UI messages for different events\n"
     << "  -pausedim     <1|0>          Enable emulation dimming in pause mode\n"
     << endl
@@ -469,6 +486,8 @@ void Settings::usage() const
     << "  -audio.headroom           <0-20>     Additional half-frames to prebuffer\n"
     << "  -audio.buffer_size        <0-20>     Max. number of additional half-\n"
     << "                                        frames to buffer\n"
+    << "  -audio.adaptive           <1|0>      Adapt headroom and buffer size (up\n"
+    << "                                        to the values above) at runtime\n"
     << "  -audio.stereo             <1|0>      Enable stereo mode for all ROMs\n"
     << endl
   #endif
@@ -526,6 +545,8 @@ void Settings::usage() const
     << "  -fastscbios   <1|0>          Disable Supercharger BIOS progress loading bars\n"
     << "  -threads      <1|0>          Whether to using multi-threading during\n"
     << "                                emulation\n"
+    << "  -threadcount  <number>       Number of threads used with multi-threading\n"
+    << "                                (0 = automatic)\n"
     << "  -snapsavedir  <path>         The directory to save snapshot files to\n"
     << "  -snaploaddir  <path>         The directory to load snapshot files from\n"
     << "  -snapname     <int|rom>      Name snapshots according to internal database or\n"
@@ -540,6 +561,10 @@ void Settings::usage() const
     << "                 all>           emulation\n"
     << "  -autoslot     <0|1>          Automatically change to next save slot when\n"
     << "                                state saving\n"
+    << "  -movie        <file>         Record all input of the started ROM into the\n"
+    << "                                given movie file\n"
+    << "  -moviechecksum <number>      Store a state checksum in movies every n frames\n"
+    << "                                (0 disables checksums)\n"
     << endl
     << "  -rominfo      <rom>          Display detailed information for the given ROM\n"
     << "  -listrominfo                 Display contents of stella.pro, one line per ROM\n"
@@ -97,6 +97,12 @@ class Sound
     */
     virtual string about() const = 0;
 
+    /**
+      This method is called to provide a one line summary of the audio
+      buffering state for the frame statistics (empty if not available).
+    */
+    virtual string statistics() const { return EmptyString; }
+
     /**
       Get the supported devices for the audio hardware.
 
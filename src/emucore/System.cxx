@@ -24,6 +24,7 @@
 #include "TIA.hxx"
 #include "Cart.hxx"
 #include "TimerManager.hxx"
+#include "PerfStats.hxx"
 #include "System.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -99,48 +100,28 @@ void System::clearDirtyPages()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8 System::peek(uInt16 addr, Device::AccessFlags flags)
+uInt8 System::peekDevice(const PageAccess& access, uInt16 addr)
 {
-  const PageAccess& access = getPageAccess(addr);
+  PERF_SCOPE_DYN(access.device == &myCart
+                 ? PerfStats::Section::cart : PerfStats::Section::io);
 
-#ifdef DEBUGGER_SUPPORT
-  // Set access type
-  if(access.romAccessBase)
-    *(access.romAccessBase + (addr & PAGE_MASK)) |= (flags | (addr & Device::HADDR));
-  else
-    access.device->setAccessFlags(addr, flags);
-  // Increase access counter
-  if(flags != Device::NONE)
-  {
-    if(access.romPeekCounter)
-      *(access.romPeekCounter + (addr & PAGE_MASK)) += 1;
-    else
-      access.device->increaseAccessCounter(addr);
-  }
-#endif
-
-  // See if this page uses direct accessing or not
-  uInt8 result;
-  if(access.directPeekBase)
-    result = *(access.directPeekBase + (addr & PAGE_MASK));
-  else
-    result = access.device->peek(addr);
-
-#ifdef DEBUGGER_SUPPORT
-  if(!myDataBusLocked)
-#endif
-    myDataBusState = result;
-
-  return result;
+  return access.device->peek(addr);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void System::poke(uInt16 addr, uInt8 value, Device::AccessFlags flags)
+bool System::pokeDevice(const PageAccess& access, uInt16 addr, uInt8 value)
 {
-  uInt16 page = (addr & ADDRESS_MASK) >> PAGE_SHIFT;
-  const PageAccess& access = myPageAccessTable[page];
+  PERF_SCOPE_DYN(access.device == &myCart
+                 ? PerfStats::Section::cart : PerfStats::Section::io);
+
+  return access.device->poke(addr, value);
+}
 
 #ifdef DEBUGGER_SUPPORT
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::trackAccess(const PageAccess& access, uInt16 addr,
+                         Device::AccessFlags flags, bool isWrite)
+{
   // Set access type
   if(access.romAccessBase)
     *(access.romAccessBase + (addr & PAGE_MASK)) |= (flags | (addr & Device::HADDR));
@@ -149,33 +130,15 @@ void System::poke(uInt16 addr, uInt8 value, Device::AccessFlags flags)
   // Increase access counter
   if(flags != Device::NONE)
   {
-    if(access.romPokeCounter)
-      *(access.romPokeCounter + (addr & PAGE_MASK)) += 1;
-    else
-      access.device->increaseAccessCounter(addr, true);
-  }
-#endif
+    Device::AccessCounter* counter = isWrite ? access.romPokeCounter : access.romPeekCounter;
 
-  // See if this page uses direct accessing or not
-  if(access.directPokeBase)
-  {
-    // Since we have direct access to this poke, we can dirty its page
-    *(access.directPokeBase + (addr & PAGE_MASK)) = value;
-    myPageIsDirtyTable[page] = true;
-  }
-  else
-  {
-    // The specific device informs us if the poke succeeded
-    myPageIsDirtyTable[page] = access.device->poke(addr, value);
+    if(counter)
+      *(counter + (addr & PAGE_MASK)) += 1;
+    else
+      access.device->increaseAccessCounter(addr, isWrite);
   }
-
-#ifdef DEBUGGER_SUPPORT
-  if(!myDataBusLocked)
-#endif
-    myDataBusState = value;
 }
 
-#ifdef DEBUGGER_SUPPORT
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Device::AccessFlags System::getAccessFlags(uInt16 addr) const
 {
@@ -225,7 +188,7 @@ void System::increaseAccessCounter(uInt16 addr, bool isWrite)
 #endif
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool System::save(Serializer& out) const
+bool System::save(Serializer& out, const SaveHook& hook) const
 {
   try
   {
@@ -233,16 +196,14 @@ bool System::save(Serializer& out) const
     out.putByte(myDataBusState);
 
     // Save the state of each device
-    if(!myM6502.save(out))
-      return false;
-    if(!myM6532.save(out))
-      return false;
-    if(!myTIA.save(out))
-      return false;
-    if(!myCart.save(out))
-      return false;
-    if(!randGenerator().save(out))
-      return false;
+    for(const Serializable* device: std::initializer_list<const Serializable*>{
+        &myM6502, &myM6532, &myTIA, &myCart, &randGenerator()})
+    {
+      if(hook)
+        hook();
+      if(!device->save(out))
+        return false;
+    }
   }
   catch(...)
   {
@@ -168,18 +168,34 @@ class System : public Serializable
     */
     uInt8 getDataBusState() const { return myDataBusState; }
 
+    /**
+      Update the data bus state after an access by peek() or poke().
+
+      @param value  The value that was read or written
+    */
+    void setDataBusState(uInt8 value) {
+    #ifdef DEBUGGER_SUPPORT
+      if(!myDataBusLocked)
+    #endif
+        myDataBusState = value;
+    }
+
     /**
       Get the byte at the specified address.  No masking of the
       address occurs before it's sent to the device mapped at
       the address.
 
+      @tparam debugging  Update the access flags and counters used by the
+                         debugger (the CPU skips this when not debugging)
+
       @param address  The address from which the value should be loaded
       @param flags    Indicates that this address has the given flags
                       for type of access (CODE, DATA, GFX, etc)
 
       @return The byte at the specified address
     */
-    uInt8 peek(uInt16 address, Device::AccessFlags flags = Device::NONE);
+    template<bool debugging = true>
+    inline uInt8 peek(uInt16 address, Device::AccessFlags flags = Device::NONE);
 
     /**
       Change the byte at the specified address to the given value.
@@ -191,10 +207,14 @@ class System : public Serializable
       if the device is handling the poke, we depend on its return value
       for this information.
 
+      @tparam debugging  Update the access flags and counters used by the
+                         debugger (the CPU skips this when not debugging)
+
       @param address  The address where the value should be stored
       @param value    The value to be stored at the address
     */
-    void poke(uInt16 address, uInt8 value, Device::AccessFlags flags = Device::NONE);
+    template<bool debugging = true>
+    inline void poke(uInt16 address, uInt8 value, Device::AccessFlags flags = Device::NONE);
 
     /**
       Lock/unlock the data bus. When the bus is locked, peek() and
@@ -355,7 +375,16 @@ class System : public Serializable
       @param out  The Serializer object to use
       @return  False on any errors, else true
     */
-    bool save(Serializer& out) const override;
+    bool save(Serializer& out) const override { return save(out, nullptr); }
+
+    /**
+      Save the current state of this system to the given Serializer.
+
+      @param out   The Serializer object to use
+      @param hook  Called before the state of each device is saved
+      @return  False on any errors, else true
+    */
+    bool save(Serializer& out, const SaveHook& hook) const;
 
     /**
       Load the current state of this system from the given Serializer.
@@ -365,6 +394,24 @@ class System : public Serializable
     */
     bool load(Serializer& in) override;
 
+  private:
+    /**
+      Read from / write to the device of a page which isn't accessed
+      directly (TIA and RIOT registers, bankswitching hotspots etc.).
+      These are kept out of line, so that peek() and poke() stay small
+      enough to be inlined.
+    */
+    uInt8 peekDevice(const PageAccess& access, uInt16 addr);
+    bool pokeDevice(const PageAccess& access, uInt16 addr, uInt8 value);
+
+  #ifdef DEBUGGER_SUPPORT
+    /**
+      Update the access flags and counters used by the debugger.
+    */
+    void trackAccess(const PageAccess& access, uInt16 addr,
+                     Device::AccessFlags flags, bool isWrite);
+  #endif
+
   private:
     // The system RNG
     Random& myRandom;
@@ -415,4 +462,53 @@ class System : public Serializable
     System& operator=(System&&) = delete;
 };
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool debugging>
+uInt8 System::peek(uInt16 addr, Device::AccessFlags flags)
+{
+  const PageAccess& access = getPageAccess(addr);
+
+#ifdef DEBUGGER_SUPPORT
+  if constexpr(debugging)
+    trackAccess(access, addr, flags, false);
+#endif
+
+  // See if this page uses direct accessing or not
+  const uInt8 result = access.directPeekBase
+    ? *(access.directPeekBase + (addr & PAGE_MASK))
+    : peekDevice(access, addr);
+
+  setDataBusState(result);
+
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool debugging>
+void System::poke(uInt16 addr, uInt8 value, Device::AccessFlags flags)
+{
+  const uInt16 page = (addr & ADDRESS_MASK) >> PAGE_SHIFT;
+  const PageAccess& access = myPageAccessTable[page];
+
+#ifdef DEBUGGER_SUPPORT
+  if constexpr(debugging)
+    trackAccess(access, addr, flags, true);
+#endif
+
+  // See if this page uses direct accessing or not
+  if(access.directPokeBase)
+  {
+    // Since we have direct access to this poke, we can dirty its page
+    *(access.directPokeBase + (addr & PAGE_MASK)) = value;
+    myPageIsDirtyTable[page] = true;
+  }
+  else
+  {
+    // The specific device informs us if the poke succeeded
+    myPageIsDirtyTable[page] = pokeDevice(access, addr, value);
+  }
+
+  setDataBusState(value);
+}
+
 #endif
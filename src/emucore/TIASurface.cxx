@@ -24,6 +24,7 @@
 #include "TIA.hxx"
 #include "PNGLibrary.hxx"
 #include "PaletteHandler.hxx"
+#include "PerfStats.hxx"
 #include "TIASurface.hxx"
 
 namespace {
@@ -89,7 +90,8 @@ TIASurface::TIASurface(OSystem& system)
   myRGBFramebuffer.fill(0);
 
   // Enable/disable threading in the NTSC TV effects renderer
-  myNTSCFilter.enableThreading(myOSystem.settings().getBool("threads"));
+  myNTSCFilter.enableThreading(myOSystem.settings().getBool("threads"),
+                               myOSystem.settings().getInt("threadcount"));
 
   myPaletteHandler = make_unique<PaletteHandler>(myOSystem);
   myPaletteHandler->loadConfig(myOSystem.settings());
@@ -105,6 +107,7 @@ void TIASurface::initialize(const Console& console,
                             const VideoModeHandler::Mode& mode)
 {
   myTIA = &(console.tia());
+  myFullRender = true;
 
   myTiaSurface->setDstPos(mode.imageR.x(), mode.imageR.y());
   myTiaSurface->setDstSize(mode.imageR.w(), mode.imageR.h());
@@ -153,6 +156,8 @@ void TIASurface::setPalette(const PaletteArray& tia_palette,
   // The NTSC filtering needs access to the raw RGB data, since it calculates
   // its own internal palette
   myNTSCFilter.setPalette(rgb_palette);
+
+  myFullRender = true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -168,6 +173,7 @@ const FBSurface& TIASurface::baseSurface(Common::Rect& rect) const
   for(uInt32 y = 0; y < height; ++y)
     for(uInt32 x = 0; x < width; ++x)
         *buf_ptr++ = myPalette[*(myTIA->frameBuffer() + y * tiaw + x / 2)];
+  myBaseTiaSurface->setDirty(true);
 
   return *myBaseTiaSurface;
 }
@@ -292,6 +298,7 @@ void TIASurface::enablePhosphor(bool enable, int blend)
   {
     myFilter = Filter(enable ? uInt8(myFilter) | 0x01 : uInt8(myFilter) & 0x10);
     myRGBFramebuffer.fill(0);
+    myFullRender = true;
   }
 }
 
@@ -318,6 +325,7 @@ void TIASurface::enableNTSC(bool enable)
   mySLineSurface->applyAttributes();
 
   myRGBFramebuffer.fill(0);
+  myFullRender = true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -374,11 +382,18 @@ inline uInt32 TIASurface::averageBuffers(uInt32 bufOfs)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASurface::render(bool shade)
 {
+  PERF_SCOPE(tiaSurface);
+
   uInt32 width = myTIA->width(), height = myTIA->height();
 
   uInt32 *out, outPitch;
   myTiaSurface->basePtr(out, outPitch);
 
+  // Unless our own settings changed, only the parts of the image which
+  // changed in the TIA framebuffer must be converted (and uploaded) again.
+  // The phosphor modes blend with the previous frame, so they always are.
+  const bool changed = myFullRender || myTIA->isFrameBufferDirty();
+
   switch(myFilter)
   {
     case Filter::Normal:
@@ -388,12 +403,18 @@ void TIASurface::render(bool shade)
       uInt32 bufofs = 0, screenofsY = 0, pos;
       for(uInt32 y = 0; y < height; ++y)
       {
-        pos = screenofsY;
-        for (uInt32 x = width / 2; x; --x)
+        if(myFullRender || myTIA->isScanlineDirty(y))
         {
-          out[pos++] = myPalette[tiaIn[bufofs++]];
-          out[pos++] = myPalette[tiaIn[bufofs++]];
+          pos = screenofsY;
+          for (uInt32 x = width / 2; x; --x)
+          {
+            out[pos++] = myPalette[tiaIn[bufofs++]];
+            out[pos++] = myPalette[tiaIn[bufofs++]];
+          }
+          myTiaSurface->setDirtyRows(y, 1);
         }
+        else
+          bufofs += width;
         screenofsY += outPitch;
       }
       break;
@@ -414,20 +435,28 @@ void TIASurface::render(bool shade)
         pos = screenofsY;
         for(uInt32 x = width / 2; x ; --x)
         {
-          // Store back into displayed frame buffer (for next frame)
-          rgbIn[bufofs] = out[pos++] = PhosphorHandler::getPixel(myPalette[tiaIn[bufofs]], rgbIn[bufofs]);
-          ++bufofs;
-          rgbIn[bufofs] = out[pos++] = PhosphorHandler::getPixel(myPalette[tiaIn[bufofs]], rgbIn[bufofs]);
-          ++bufofs;
+          out[pos++] = myPalette[tiaIn[bufofs++]];
+          out[pos++] = myPalette[tiaIn[bufofs++]];
         }
+        // Blend and store back into displayed frame buffer (for next frame)
+        PhosphorHandler::blendRow(out + screenofsY, rgbIn + bufofs - width, width);
         screenofsY += outPitch;
       }
+      myTiaSurface->setDirty(true);
       break;
     }
 
     case Filter::BlarggNormal:
     {
-      myNTSCFilter.render(myTIA->frameBuffer(), width, height, out, outPitch << 2);
+      if(changed)
+      {
+        myNTSCFilter.render(myTIA->frameBuffer(), width, height, out, outPitch << 2);
+
+        // The filter works on each scanline separately
+        for(uInt32 y = 0; y < height; ++y)
+          if(myFullRender || myTIA->isScanlineDirty(y))
+            myTiaSurface->setDirtyRows(y, 1);
+      }
       break;
     }
 
@@ -438,9 +467,12 @@ void TIASurface::render(bool shade)
                     myPrevRGBFramebuffer.begin());
 
       myNTSCFilter.render(myTIA->frameBuffer(), width, height, out, outPitch << 2, myRGBFramebuffer.data());
+      myTiaSurface->setDirty(true);
       break;
     }
   }
+  myTIA->clearDirtyScanlines();
+  myFullRender = false;
 
   // Draw TIA image
   myTiaSurface->render();
@@ -517,6 +549,7 @@ void TIASurface::renderForSnapshot()
   if(myPhosphorHandler.phosphorEnabled())
   {
     // Draw TIA image
+    myTiaSurface->setDirty(true);
     myTiaSurface->render();
 
     // Draw overlaying scanlines
@@ -534,6 +567,8 @@ void TIASurface::updateSurfaceSettings()
   mySLineSurface->setScalingInterpolation(
       interpolationModeFromSettings(myOSystem.settings())
   );
+
+  myFullRender = true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
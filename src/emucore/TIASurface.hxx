@@ -234,6 +234,10 @@ class TIASurface
     // Flag for saving a snapshot
     bool mySaveSnapFlag{false};
 
+    // Convert the complete image on the next render, regardless of which
+    // parts of the TIA framebuffer changed (palette, filter etc. changed)
+    bool myFullRender{true};
+
     // The palette handler
     unique_ptr<PaletteHandler> myPaletteHandler;
 
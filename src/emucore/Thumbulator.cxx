@@ -26,6 +26,7 @@
 #include "Base.hxx"
 #include "Cart.hxx"
 #include "Thumbulator.hxx"
+#include "PerfStats.hxx"
 using Common::Base;
 
 // Uncomment the following to enable specific functionality
@@ -178,6 +179,8 @@ void Thumbulator::updateTimer(uInt32 cycles)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string Thumbulator::run(uInt32& cycles, bool irqDrivenAudio)
 {
+  PERF_SCOPE(thumbulator);
+
   updateTimer(cycles);
   return doRun(cycles, irqDrivenAudio);
 }
@@ -71,6 +71,7 @@ MODULE_OBJS := \
         src/emucore/KidVid.o \
         src/emucore/Lightgun.o \
         src/emucore/MindLink.o \
+        src/emucore/Movie.o \
         src/emucore/M6502.o \
         src/emucore/M6532.o \
         src/emucore/MT24LC256.o \
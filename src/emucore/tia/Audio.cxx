@@ -17,6 +17,7 @@
 
 #include "Audio.hxx"
 #include "AudioQueue.hxx"
+#include "PerfStats.hxx"
 
 #include <cmath>
 
@@ -24,6 +25,20 @@ namespace {
   constexpr double R_MAX = 30.;
   constexpr double R = 1.;
 
+  // The audio clock runs through a 228 clock cycle, with the two phases of
+  // each sample at fixed positions
+  constexpr uInt32 AUDIO_CLOCKS = 228;
+  constexpr uInt32 PHASE0_CLOCK0 = 9, PHASE0_CLOCK1 = 81;
+  constexpr uInt32 PHASE1_CLOCK0 = 37, PHASE1_CLOCK1 = 149;
+
+  // The number of events at the two given positions before clock
+  uInt32 eventsBefore(uInt32 clock, uInt32 event0, uInt32 event1)
+  {
+    const uInt32 position = clock % AUDIO_CLOCKS;
+
+    return 2 * (clock / AUDIO_CLOCKS) + (position > event0) + (position > event1);
+  }
+
   Int16 mixingTableEntry(uInt8 v, uInt8 vMax)
   {
     return static_cast<Int16>(
@@ -61,23 +76,40 @@ void Audio::setAudioQueue(const shared_ptr<AudioQueue>& queue)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Audio::tick()
+void Audio::tick(uInt32 clocks)
 {
-  switch (myCounter) {
-    case 9:
-    case 81:
-      myChannel0.phase0();
-      myChannel1.phase0();
-
-      break;
-
-    case 37:
-    case 149:
-      phase1();
-      break;
+  PERF_SCOPE(audio);
+
+  // Count the phase 0 / phase 1 events in [myCounter, myCounter + clocks).
+  // The two phases alternate, so the interval consists of an optional
+  // phase 1 completing the last sample, a run of complete samples, and an
+  // optional phase 0 starting the next one.
+  const uInt32 end = myCounter + clocks;
+  uInt32 phase0Count = eventsBefore(end, PHASE0_CLOCK0, PHASE0_CLOCK1) -
+                       eventsBefore(myCounter, PHASE0_CLOCK0, PHASE0_CLOCK1);
+  uInt32 phase1Count = eventsBefore(end, PHASE1_CLOCK0, PHASE1_CLOCK1) -
+                       eventsBefore(myCounter, PHASE1_CLOCK0, PHASE1_CLOCK1);
+
+  const bool phase1First =
+    (myCounter > PHASE0_CLOCK0 && myCounter <= PHASE1_CLOCK0) ||
+    (myCounter > PHASE0_CLOCK1 && myCounter <= PHASE1_CLOCK1);
+
+  myCounter = end % AUDIO_CLOCKS;
+
+  if (phase1First && phase1Count > 0) {
+    phase1();
+    --phase1Count;
   }
 
-  if (++myCounter == 228) myCounter = 0;
+  if (phase1Count > 0) generate(phase1Count);
+  if (phase0Count > phase1Count) phase0();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Audio::phase0()
+{
+  myChannel0.phase0();
+  myChannel1.phase0();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -88,14 +120,38 @@ void Audio::phase1()
 
   addSample(sample0, sample1);
 #ifdef GUI_SUPPORT
-  mySamples.push_back(sample0 | (sample1 << 4));
+  if(!myMuted)
+    mySamples.push_back(sample0 | (sample1 << 4));
 #endif
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Audio::generate(uInt32 count)
+{
+  std::array<uInt8, 64> samples0, samples1;
+
+  while (count > 0) {
+    const uInt32 batch = std::min<uInt32>(count, uInt32(samples0.size()));
+
+    myChannel0.generate(samples0.data(), batch);
+    myChannel1.generate(samples1.data(), batch);
+
+    for (uInt32 i = 0; i < batch; ++i) {
+      addSample(samples0[i], samples1[i]);
+    #ifdef GUI_SUPPORT
+      if(!myMuted)
+        mySamples.push_back(samples0[i] | (samples1[i] << 4));
+    #endif
+    }
+
+    count -= batch;
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Audio::addSample(uInt8 sample0, uInt8 sample1)
 {
-  if(!myAudioQueue) return;
+  if(!myAudioQueue || myMuted) return;
 
   if(myAudioQueue->isStereo()) {
     myCurrentFragment[2 * mySampleIndex] = myMixingTableIndividual[sample0];
@@ -123,6 +179,31 @@ AudioChannel& Audio::channel1()
   return myChannel1;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Audio::takeSamples(ByteArray& samples)
+{
+#ifdef GUI_SUPPORT
+  samples.swap(mySamples);
+  mySamples.clear();
+#else
+  samples.clear();
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Audio::playSamples(const uInt8* samples, size_t size)
+{
+  // Feed all samples into the audio queue
+  for(size_t i = 0; i < size && !myMuted; i++)
+  {
+    uInt8 sample = samples[i];
+    uInt8 sample0 = sample & 0x0f;
+    uInt8 sample1 = sample >> 4;
+
+    addSample(sample0, sample1);
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Audio::save(Serializer& out) const
 {
@@ -135,16 +216,10 @@ bool Audio::save(Serializer& out) const
 
     if (!myChannel0.save(out)) return false;
     if (!myChannel1.save(out)) return false;
-  #ifdef GUI_SUPPORT
-    out.putLong(uInt64(mySamples.size()));
-    out.putByteArray(mySamples.data(), mySamples.size());
 
     // TODO: check if this improves sound of playback for larger state gaps
     //out.putInt(mySampleIndex);
     //out.putShortArray((uInt16*)myCurrentFragment, myAudioQueue->fragmentSize());
-
-    mySamples.clear();
-  #endif
   }
   catch(...)
   {
@@ -164,24 +239,9 @@ bool Audio::load(Serializer& in)
 
     if (!myChannel0.load(in)) return false;
     if (!myChannel1.load(in)) return false;
-  #ifdef GUI_SUPPORT
-    uInt64 sampleSize = in.getLong();
-    unique_ptr<uInt8[]> samples = make_unique<uInt8[]>(sampleSize);
-    in.getByteArray(samples.get(), sampleSize);
 
     //mySampleIndex = in.getInt();
     //in.getShortArray((uInt16*)myCurrentFragment, myAudioQueue->fragmentSize());
-
-    // Feed all loaded samples into the audio queue
-    for(size_t i = 0; i < sampleSize; i++)
-    {
-      uInt8 sample = samples[i];
-      uInt8 sample0 = sample & 0x0f;
-      uInt8 sample1 = sample >> 4;
-
-      addSample(sample0, sample1);
-    }
-  #endif
   }
   catch(...)
   {
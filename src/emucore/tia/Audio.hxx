@@ -33,7 +33,31 @@ class Audio : public Serializable
 
     void setAudioQueue(const shared_ptr<AudioQueue>& queue);
 
-    void tick();
+    /**
+      Discard all generated samples, e.g. while emulating frames which are
+      rolled back afterwards. This also leaves the samples recorded for the
+      Time Machine untouched.
+     */
+    void setMuted(bool muted) { myMuted = muted; }
+
+    /**
+      Run the audio clock for the given number of color clocks. Samples are
+      generated in batches, so the audio registers must not change during
+      the interval.
+     */
+    void tick(uInt32 clocks);
+
+    /**
+      Take the samples generated since the last call (only recorded in GUI
+      builds). The Time Machine stores them with each state and plays them
+      back when the state is loaded.
+     */
+    void takeSamples(ByteArray& samples);
+
+    /**
+      Play back samples taken before (unless muted).
+     */
+    void playSamples(const uInt8* samples, size_t size);
 
     AudioChannel& channel0();
 
@@ -46,7 +70,9 @@ class Audio : public Serializable
     bool load(Serializer& in) override;
 
   private:
+    void phase0();
     void phase1();
+    void generate(uInt32 count);
     void addSample(uInt8 sample0, uInt8 sample1);
 
   private:
@@ -62,8 +88,9 @@ class Audio : public Serializable
 
     Int16* myCurrentFragment{nullptr};
     uInt32 mySampleIndex{0};
+    bool myMuted{false};
   #ifdef GUI_SUPPORT
-    mutable ByteArray mySamples;
+    ByteArray mySamples;
   #endif
 
   private:
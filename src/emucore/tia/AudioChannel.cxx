@@ -117,6 +117,31 @@ uInt8 AudioChannel::phase1()
   return (myPulseCounter & 0x01) * myAudv;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioChannel::generate(uInt8* samples, uInt32 count)
+{
+  while (count > 0) {
+    if (myClockEnable || myDivCounter == myAudf) {
+      phase0();
+      *samples++ = phase1();
+      --count;
+
+      continue;
+    }
+
+    // The divider counts up to AUDF (or wraps around at 0x1f first), and
+    // neither phase changes the counters on the way
+    const uInt32 idle = std::min<uInt32>(count,
+      myDivCounter < myAudf ? myAudf - myDivCounter : 0x20 - myDivCounter);
+
+    std::fill_n(samples, idle, uInt8((myPulseCounter & 0x01) * myAudv));
+    myDivCounter = (myDivCounter + idle) & 0x1f;
+
+    samples += idle;
+    count -= idle;
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AudioChannel::audc(uInt8 value)
 {
@@ -32,6 +32,14 @@ class AudioChannel : public Serializable
 
     uInt8 phase1();
 
+    /**
+      Run count complete samples (phase 0 followed by phase 1) and store the
+      resulting sample values. Stretches during which the frequency divider
+      doesn't clock the counters produce a constant value and are skipped
+      in one step.
+     */
+    void generate(uInt8* samples, uInt32 count);
+
     void audc(uInt8 value);
 
     void audf(uInt8 value);
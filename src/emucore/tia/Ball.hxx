@@ -125,6 +125,11 @@ class Ball : public Serializable
      */
     bool isOn() const { return (collision & 0x8000); }
 
+    /**
+      The collision mask while the ball is visible / invisible.
+     */
+    uInt32 getCollisionMask(bool on) const { return on ? myCollisionMaskEnabled : myCollisionMaskDisabled; }
+
     /**
       Get the current color.
      */
@@ -174,6 +179,12 @@ class Ball : public Serializable
      */
     inline void tick(bool isReceivingRegularClock = true);
 
+    /**
+      Tick a span of color clocks outside of movement. Returns a bitmask which
+      has bit i set if the ball is visible during the i-th clock.
+     */
+    inline uInt64 tickSpan(uInt32 clocks);
+
   public:
 
     /**
@@ -412,4 +423,32 @@ void Ball::tick(bool isReceivingRegularClock)
       myCounter = 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 Ball::tickSpan(uInt32 clocks)
+{
+  uInt64 coverage = 0;
+
+  for (uInt32 i = 0; i < clocks; ++i)
+  {
+    // Skip ahead to the decode value that triggers rendering if we are not
+    // rendering
+    if (!myIsRendering && !(myUseInvertedPhaseClock && myInvertedPhaseClock))
+    {
+      for (; i < clocks && myCounter != 156; ++i)
+        if (++myCounter >= TIAConstants::H_PIXEL) myCounter = 0;
+
+      mySignalActive = false;
+      collision = myCollisionMaskDisabled;
+
+      if (i == clocks) break;
+    }
+
+    tick();
+
+    if (isOn()) coverage |= uInt64{1} << i;
+  }
+
+  return coverage;
+}
+
 #endif // TIA_BALL
@@ -43,6 +43,18 @@ class DelayQueue : public Serializable
 
     template<typename T> void execute(T executor);
 
+    /**
+      The number of clocks (at most maxClocks) that can pass before the next
+      pending write is due.
+    */
+    uInt32 idleClocks(uInt32 maxClocks) const;
+
+    /**
+      Advance the queue by the given number of clocks without executing any
+      writes. The clocks must not exceed idleClocks().
+    */
+    void skip(uInt32 clocks);
+
     /**
       Serializable methods (see that class for more information).
     */
@@ -118,6 +130,23 @@ void DelayQueue<length, capacity>::execute(T executor)
   myIndex = smartmod<length>(myIndex + 1);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<unsigned length, unsigned capacity>
+uInt32 DelayQueue<length, capacity>::idleClocks(uInt32 maxClocks) const
+{
+  for (uInt32 i = 0; i < length && i < maxClocks; ++i)
+    if (myMembers[smartmod<length>(myIndex + i)].mySize > 0) return i;
+
+  return maxClocks;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<unsigned length, unsigned capacity>
+void DelayQueue<length, capacity>::skip(uInt32 clocks)
+{
+  myIndex = smartmod<length>(myIndex + clocks % length);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 template<unsigned length, unsigned capacity>
 bool DelayQueue<length, capacity>::save(Serializer& out) const
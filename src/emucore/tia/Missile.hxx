@@ -65,6 +65,7 @@ class Missile : public Serializable
     void toggleEnabled(bool enabled);
 
     bool isOn() const { return (collision & 0x8000); }
+    uInt32 getCollisionMask(bool on) const { return on ? myCollisionMaskEnabled : myCollisionMaskDisabled; }
     uInt8 getColor() const { return myColor; }
 
     uInt8 getPosition() const;
@@ -80,6 +81,8 @@ class Missile : public Serializable
 
     inline void tick(uInt8 hclock, bool isReceivingMclock = true);
 
+    inline uInt64 tickSpan(uInt8 hclock, uInt32 clocks);
+
   public:
 
     uInt32 collision{0};
@@ -198,4 +201,31 @@ void Missile::tick(uInt8 hclock, bool isReceivingMclock)
   if (++myCounter >= TIAConstants::H_PIXEL) myCounter = 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 Missile::tickSpan(uInt8 hclock, uInt32 clocks)
+{
+  uInt64 coverage = 0;
+
+  for (uInt32 i = 0; i < clocks; ++i)
+  {
+    // Skip ahead to the next start signal if we are not rendering
+    if (!myIsRendering && !(myUseInvertedPhaseClock && myInvertedPhaseClock))
+    {
+      for (; i < clocks && (myResmp || !myDecodes[myCounter]); ++i)
+        if (++myCounter >= TIAConstants::H_PIXEL) myCounter = 0;
+
+      myIsVisible = false;
+      collision = myCollisionMaskDisabled;
+
+      if (i == clocks) break;
+    }
+
+    tick(hclock + i);
+
+    if (isOn()) coverage |= uInt64{1} << i;
+  }
+
+  return coverage;
+}
+
 #endif // TIA_MISSILE
@@ -67,6 +67,7 @@ class Player : public Serializable
     uInt8 getClock() const { return myCounter; }
 
     bool isOn() const { return (collision & 0x8000); }
+    uInt32 getCollisionMask(bool on) const { return on ? myCollisionMaskEnabled : myCollisionMaskDisabled; }
     uInt8 getColor() const { return myColor; }
 
     void shufflePatterns();
@@ -91,6 +92,8 @@ class Player : public Serializable
 
     inline void tick();
 
+    inline uInt64 tickSpan(uInt32 clocks);
+
   public:
 
     uInt32 collision{0};
@@ -215,4 +218,30 @@ void Player::tick()
   if (++myCounter >= TIAConstants::H_PIXEL) myCounter = 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 Player::tickSpan(uInt32 clocks)
+{
+  uInt64 coverage = 0;
+
+  for (uInt32 i = 0; i < clocks; ++i)
+  {
+    // Skip ahead to the next start signal if we are not rendering
+    if (!myIsRendering && !(myUseInvertedPhaseClock && myInvertedPhaseClock))
+    {
+      for (; i < clocks && !myDecodes[myCounter]; ++i)
+        if (++myCounter >= TIAConstants::H_PIXEL) myCounter = 0;
+
+      collision = myCollisionMaskDisabled;
+
+      if (i == clocks) break;
+    }
+
+    tick();
+
+    if (isOn()) coverage |= uInt64{1} << i;
+  }
+
+  return coverage;
+}
+
 #endif // TIA_PLAYER
@@ -116,9 +116,14 @@ class Playfield : public Serializable
     bool isOn() const { return (collision & 0x8000); }
 
     /**
-      Get the current color.
+      The collision mask while the playfield is visible / invisible.
      */
-    uInt8 getColor() const;
+    uInt32 getCollisionMask(bool on) const { return on ? myCollisionMaskEnabled : myCollisionMaskDisabled; }
+
+    /**
+      Get the color at the given pixel. Inline for performance (implementation below).
+     */
+    inline uInt8 getColor(uInt32 x) const;
 
     /**
       Serializable methods (see that class for more information).
@@ -131,6 +136,12 @@ class Playfield : public Serializable
      */
     inline void tick(uInt32 x);
 
+    /**
+      Tick a span of color clocks, starting at x. Returns a bitmask which has
+      bit i set if the playfield is visible during the i-th clock.
+     */
+    inline uInt64 tickSpan(uInt32 x, uInt32 clocks);
+
   public:
 
     /**
@@ -160,6 +171,11 @@ class Playfield : public Serializable
      */
     void updatePattern();
 
+    /**
+      Get the debug color at the given pixel.
+     */
+    uInt8 getDebugColor(uInt32 x) const;
+
   private:
 
     /**
@@ -275,4 +291,33 @@ void Playfield::tick(uInt32 x)
   collision = currentPixel ? myCollisionMaskEnabled : myCollisionMaskDisabled;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 Playfield::getColor(uInt32 x) const
+{
+  if (myDebugEnabled) return getDebugColor(x);
+
+  return x < TIAConstants::H_PIXEL / 2 ? myColorLeft : myColorRight;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 Playfield::tickSpan(uInt32 x, uInt32 clocks)
+{
+  uInt64 coverage = 0;
+
+  // The playfield only changes every four clocks
+  for (uInt32 i = 0; i < clocks; )
+  {
+    tick(x + i);
+
+    const uInt32 run = std::min(clocks - i, 4 - ((x + i) & 0x03));
+    if (isOn()) coverage |= ((uInt64{1} << run) - 1) << i;
+
+    i += run;
+  }
+
+  myX = x + clocks - 1;
+
+  return coverage;
+}
+
 #endif // TIA_PLAYFIELD
@@ -26,6 +26,7 @@
 #include "AudioQueue.hxx"
 #include "DispatchResult.hxx"
 #include "Base.hxx"
+#include "PerfStats.hxx"
 
 enum CollisionMask: uInt32 {
   player0   = 0b0111110000000000,
@@ -63,6 +64,61 @@ enum ResxCounter: uInt8 {
 // 70, the G.I. Joe will show an artifact (hole in roof).
 static constexpr uInt8 resxLateHblankThreshold = TIAConstants::H_CYCLES - 3;
 
+// The object whose color is displayed, for each mode of the priority encoder
+// (in the order of TIA::Priority) and each combination of objects which are on
+// (indexed by TIABit). The values index the array returned by TIA::objectColors.
+static const BSPF::array2D<uInt8, 3, 64> pixelSource = [] {
+  static constexpr std::array<std::array<TIABit, 6>, 3> order = {{
+    // CTRLPF D2=1, D1=ignored
+    // Playfield has priority so ScoreBit isn't used
+    // Priority from highest to lowest:
+    //   BL/PF => P0/M0 => P1/M1 => BK
+    {{ PFBit, BLBit, P0Bit, M0Bit, P1Bit, M1Bit }},
+
+    // CTRLPF D2=0, D1=1
+    // Formally we have (priority from highest to lowest)
+    //   PF/P0/M0 => P1/M1 => BL => BK
+    // for the first half and
+    //   P0/M0 => PF/P1/M1 => BL => BK
+    // for the second half. However, the first ordering is equivalent
+    // to the second (PF has the same color as P0/M0), so we can just
+    // use the second
+    {{ P0Bit, M0Bit, PFBit, P1Bit, M1Bit, BLBit }},
+
+    // CTRLPF D2=0, D1=0
+    // Priority from highest to lowest:
+    //   P0/M0 => P1/M1 => BL/PF => BK
+    {{ P0Bit, M0Bit, P1Bit, M1Bit, PFBit, BLBit }}
+  }};
+
+  const auto colorIndex = [] (TIABit bit) -> uInt8 {
+    switch (bit) {
+      case P0Bit: return TIAColor::P0Color;
+      case M0Bit: return TIAColor::M0Color;
+      case P1Bit: return TIAColor::P1Color;
+      case M1Bit: return TIAColor::M1Color;
+      case BLBit: return TIAColor::BLColor;
+      case PFBit: return TIAColor::PFColor;
+      default:    return TIAColor::BKColor;
+    }
+  };
+
+  BSPF::array2D<uInt8, 3, 64> table{};
+
+  for (uInt32 priority = 0; priority < order.size(); ++priority)
+    for (uInt32 objects = 0; objects < 64; ++objects) {
+      table[priority][objects] = TIAColor::BKColor;
+
+      for (const TIABit bit: order[priority])
+        if (objects & bit) {
+          table[priority][objects] = colorIndex(bit);
+          break;
+        }
+    }
+
+  return table;
+}();
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TIA::TIA(ConsoleIO& console, const ConsoleTimingProvider& timingProvider,
          Settings& settings)
@@ -84,6 +140,7 @@ TIA::TIA(ConsoleIO& console, const ConsoleTimingProvider& timingProvider,
   myMissile1.setTIA(this);
   myBall.setTIA(this);
 
+  updateCollisionTable();
   initialize();
 }
 
@@ -172,13 +229,14 @@ void TIA::initialize()
     myFrameManager->reset();
 
   myFrontBufferScanlines = myFrameBufferScanlines = 0;
+  myBackBufferDrawnTable.fill(false);
 
   myFramesSinceLastRender = 0;
 
   // Blank the various framebuffers; they may contain graphical garbage
-  myBackBuffer.fill(0);
-  myFrontBuffer.fill(0);
-  myFramebuffer.fill(0);
+  for(auto& buffer: myFrameBuffers)
+    buffer.fill(0);
+  setFrameBufferDirty();
 
   applyDeveloperSettings();
 
@@ -350,6 +408,7 @@ bool TIA::load(Serializer& in)
 
     mySpriteEnabledBits = in.getByte();
     myCollisionsEnabledBits = in.getByte();
+    updateCollisionTable();
 
     myColorHBlank = in.getByte();
 
@@ -364,6 +423,10 @@ bool TIA::load(Serializer& in)
 
     myFrameBufferScanlines = in.getInt();
     myFrontBufferScanlines = in.getInt();
+    // The back buffer doesn't belong to this state; the scanlines drawn
+    // already are taken from the last completed frame (unless the display
+    // is loaded too)
+    myBackBufferDrawnTable.fill(false);
 
     myPFBitsDelay = in.getByte();
     myPFColorDelay = in.getByte();
@@ -382,6 +445,69 @@ bool TIA::load(Serializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIA::saveChecksumState(Serializer& out) const
+{
+  try
+  {
+    if(!myDelayQueue.save(out)) return false;
+
+    if(!myBackground.save(out)) return false;
+    if(!myPlayfield.save(out))  return false;
+    if(!myMissile0.save(out))   return false;
+    if(!myMissile1.save(out))   return false;
+    if(!myPlayer0.save(out))    return false;
+    if(!myPlayer1.save(out))    return false;
+    if(!myBall.save(out))       return false;
+    if(!myAudio.save(out))      return false;
+
+    for (const AnalogReadout& analogReadout : myAnalogReadouts)
+      if(!analogReadout.save(out)) return false;
+
+    if(!myInput0.save(out)) return false;
+    if(!myInput1.save(out)) return false;
+
+    out.putInt(int(myHstate));
+
+    out.putInt(myHctr);
+    out.putInt(myHctrDelta);
+
+    out.putBool(myCollisionUpdateRequired);
+    out.putBool(myCollisionUpdateScheduled);
+    out.putInt(myCollisionMask);
+
+    out.putInt(myMovementClock);
+    out.putBool(myMovementInProgress);
+    out.putBool(myExtendedHblank);
+
+    out.putInt(int(myPriority));
+
+    out.putByte(mySubClock);
+    out.putLong(myLastCycle);
+
+    out.putByte(mySpriteEnabledBits);
+    out.putByte(myCollisionsEnabledBits);
+
+    out.putByte(myColorHBlank);
+
+    out.putLong(myTimestamp);
+
+    out.putByteArray(myShadowRegisters.data(), myShadowRegisters.size());
+
+    out.putByte(myPFBitsDelay);
+    out.putByte(myPFColorDelay);
+    out.putByte(myBKColorDelay);
+    out.putByte(myPlSwapDelay);
+  }
+  catch(...)
+  {
+    cerr << "ERROR: TIA::saveChecksumState" << endl;
+    return false;
+  }
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::bindToControllers()
 {
@@ -881,9 +1007,9 @@ bool TIA::saveDisplay(Serializer& out) const
 {
   try
   {
-    out.putByteArray(myFramebuffer.data(), myFramebuffer.size());
-    out.putByteArray(myBackBuffer.data(), myBackBuffer.size());
-    out.putByteArray(myFrontBuffer.data(), myFrontBuffer.size());
+    out.putByteArray(myFramebuffer->data(), myFramebuffer->size());
+    out.putByteArray(myBackBuffer->data(), myBackBuffer->size());
+    out.putByteArray(myFrontBuffer->data(), myFrontBuffer->size());
     out.putInt(myFramesSinceLastRender);
   }
   catch(...)
@@ -901,10 +1027,16 @@ bool TIA::loadDisplay(Serializer& in)
   try
   {
     // Reset frame buffer pointer and data
-    in.getByteArray(myFramebuffer.data(), myFramebuffer.size());
-    in.getByteArray(myBackBuffer.data(), myBackBuffer.size());
-    in.getByteArray(myFrontBuffer.data(), myFrontBuffer.size());
+    in.getByteArray(myFramebuffer->data(), myFramebuffer->size());
+    in.getByteArray(myBackBuffer->data(), myBackBuffer->size());
+    in.getByteArray(myFrontBuffer->data(), myFrontBuffer->size());
     myFramesSinceLastRender = in.getInt();
+    setFrameBufferDirty();
+
+    // The scanlines of the current frame drawn so far are valid again
+    if(myFrameManager->isRendering())
+      for(uInt32 y = 0; y < std::min<uInt32>(myFrameManager->getY(), TIAConstants::frameBufferHeight); ++y)
+        myBackBufferDrawnTable[y] = myBackBufferDirtyTable[y] = true;
   }
   catch(...)
   {
@@ -974,22 +1106,51 @@ void TIA::update(DispatchResult& result, uInt64 maxCycles)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void TIA::renderToFrameBuffer()
+uInt32 TIA::renderToFrameBuffer()
 {
-  if (myFramesSinceLastRender == 0) return;
+  std::lock_guard<std::mutex> lock(myFrontBufferMutex);
+
+  const uInt32 frames = myFramesSinceLastRender;
+  if (frames == 0) return 0;
 
   myFramesSinceLastRender = 0;
 
-  myFramebuffer = myFrontBuffer;
+  // Take over the pending frame; the emulation gets the old framebuffer
+  std::swap(myFramebuffer, myFrontBuffer);
+
+  // Remember which scanlines changed, so that an unchanged image doesn't
+  // have to be converted and uploaded again
+  for(uInt32 y = 0; y < TIAConstants::frameBufferHeight; ++y)
+    if(myFrontBufferDirtyTable[y])
+      myScanlineIsDirtyTable[y] = myFrameBufferIsDirty = true;
+  myFrontBufferDirtyTable.fill(false);
 
   myFrameBufferScanlines = myFrontBufferScanlines;
+
+  return frames;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::clearFrameBuffer()
 {
-  myFramebuffer.fill(0);
-  myFrontBuffer.fill(0);
+  myFramebuffer->fill(0);
+  myFrontBuffer->fill(0);
+  setFrameBufferDirty();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::setFrameBufferDirty()
+{
+  myFrontBufferDirtyTable.fill(true);
+  myScanlineIsDirtyTable.fill(true);
+  myFrameBufferIsDirty = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::clearDirtyScanlines()
+{
+  myScanlineIsDirtyTable.fill(false);
+  myFrameBufferIsDirty = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1114,6 +1275,8 @@ bool TIA::toggleCollision(TIABit b, uInt8 mode)
   myBall.toggleCollisions(myCollisionsEnabledBits & TIABit::BLBit);
   myPlayfield.toggleCollisions(myCollisionsEnabledBits & TIABit::PFBit);
 
+  updateCollisionTable();
+
   return mask;
 }
 
@@ -1348,18 +1511,72 @@ void TIA::onFrameComplete()
 #endif
 
   if (myXAtRenderingStart > 0)
-    std::fill_n(myBackBuffer.begin(), myXAtRenderingStart, 0);
+  {
+    std::fill_n(myBackBuffer->begin(), myXAtRenderingStart, 0);
+    myBackBufferDirtyTable[0] = true;
+  }
 
   // Blank out any extra lines not drawn this frame
   const Int32 missingScanlines = myFrameManager->missingScanlines();
   if (missingScanlines > 0)
-    std::fill_n(myBackBuffer.begin() + TIAConstants::H_PIXEL * myFrameManager->getY(), missingScanlines * TIAConstants::H_PIXEL, 0);
+  {
+    const uInt32 y = std::min<uInt32>(myFrameManager->getY(), TIAConstants::frameBufferHeight);
+    const uInt32 lines = std::min<uInt32>(missingScanlines, TIAConstants::frameBufferHeight - y);
 
-  myFrontBuffer = myBackBuffer;
+    std::fill_n(myBackBuffer->begin() + TIAConstants::H_PIXEL * y, lines * TIAConstants::H_PIXEL, 0);
+    std::fill_n(myBackBufferDrawnTable.begin() + y, lines, true);
+    std::fill_n(myBackBufferDirtyTable.begin() + y, lines, true);
+  }
 
-  myFrontBufferScanlines = scanlinesLastFrame();
+  // The scanlines not drawn this frame (all of them, if the frame wasn't
+  // drawn at all) keep the contents of the last completed frame, whatever
+  // the recycled back buffer contains.  Nobody writes to the last completed
+  // frame anymore, so this doesn't require the lock.
+  for(uInt32 y = 0; y < TIAConstants::frameBufferHeight; ++y)
+    if(!myBackBufferDrawnTable[y])
+    {
+      if(myLastFrameBuffer != myBackBuffer)
+        std::copy_n(myLastFrameBuffer->cbegin() + y * TIAConstants::H_PIXEL, TIAConstants::H_PIXEL,
+                    myBackBuffer->begin() + y * TIAConstants::H_PIXEL);
+      myBackBufferDirtyTable[y] = myHiddenFramesPending;
+    }
+  myBackBufferDrawnTable.fill(false);
 
-  ++myFramesSinceLastRender;
+  // A hidden frame stays in the back buffer and is drawn over by the next one
+  if(myFramesHidden)
+  {
+    std::lock_guard<std::mutex> lock(myFrontBufferMutex);
+
+    myLastFrameBuffer = myBackBuffer;
+    myHiddenFramesPending = true;
+
+    // The frame statistics are kept up to date nevertheless
+    myFrontBufferScanlines = scanlinesLastFrame();
+
+    PERF_END_FRAME();
+    return;
+  }
+
+  myHiddenFramesPending = false;
+
+  // Hand the frame over to the front buffer; we continue with the buffer
+  // which was pending before (or returned by the renderer)
+  {
+    std::lock_guard<std::mutex> lock(myFrontBufferMutex);
+
+    // The changes of frames which were never rendered accumulate
+    for(uInt32 y = 0; y < TIAConstants::frameBufferHeight; ++y)
+      myFrontBufferDirtyTable[y] = myFrontBufferDirtyTable[y] || myBackBufferDirtyTable[y];
+
+    std::swap(myBackBuffer, myFrontBuffer);
+    myLastFrameBuffer = myFrontBuffer;
+
+    myFrontBufferScanlines = scanlinesLastFrame();
+
+    ++myFramesSinceLastRender;
+  }
+
+  PERF_END_FRAME();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1376,8 +1593,20 @@ void TIA::onHalt()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::cycle(uInt32 colorClocks)
 {
+  PERF_SCOPE(tia);
+
   for (uInt32 i = 0; i < colorClocks; ++i)
   {
+    const uInt32 spanLength = spanClocks(colorClocks - i);
+
+    if (spanLength > 1)
+    {
+      tickHframeSpan(spanLength);
+      i += spanLength - 1;
+
+      continue;
+    }
+
     myDelayQueue.execute(
       [this] (uInt8 address, uInt8 value) {delayedWrite(address, value);}
     );
@@ -1399,12 +1628,14 @@ void TIA::cycle(uInt32 colorClocks)
     if (++myHctr >= TIAConstants::H_CLOCKS)
       nextLine();
 
-    #ifdef SOUND_SUPPORT
-      myAudio.tick();
-    #endif
-
     ++myTimestamp;
   }
+
+  // Audio registers are only written between calls, and audio doesn't
+  // depend on anything else, so the audio clock can be run in one go
+  #ifdef SOUND_SUPPORT
+    myAudio.tick(colorClocks);
+  #endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1412,6 +1643,8 @@ void TIA::tickMovement()
 {
   if (!myMovementInProgress) return;
 
+  PERF_SCOPE(tiaMovement);
+
   if ((myHctr & 0x03) == 0) {
     const bool hblank = myHstate == HState::blank;
     uInt8 movementCounter = myMovementClock > 15 ? 0 : myMovementClock;
@@ -1458,6 +1691,8 @@ void TIA::tickHblank()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::tickHframe()
 {
+  PERF_SCOPE(tiaHframe);
+
   const uInt32 y = myFrameManager->getY();
   const uInt32 x = myHctr - TIAConstants::H_BLANK_CLOCKS - myHctrDelta;
 
@@ -1474,6 +1709,96 @@ void TIA::tickHframe()
     renderPixel(x, y);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 TIA::spanClocks(uInt32 maxClocks) const
+{
+  if (myHstate != HState::frame || myLinesSinceChange >= 2 ||
+      myMovementInProgress || myHctrDelta != 0)
+    return 0;
+
+  return myDelayQueue.idleClocks(std::min({
+    maxClocks, uInt32(TIAConstants::H_CLOCKS - myHctr), maxSpanClocks
+  }));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::tickHframeSpan(uInt32 clocks)
+{
+  const uInt32 x = myHctr - TIAConstants::H_BLANK_CLOCKS;
+
+  // There are no delayed writes and no movement within the span, so the objects
+  // don't influence each other and can be ticked through the whole span one after
+  // the other. For each object, this yields a bitmask of the clocks during which
+  // the object is on.
+  uInt64 pf, m0, m1, p0, p1, bl;
+  {
+    PERF_SCOPE(tiaHframe);
+
+    pf = myPlayfield.tickSpan(x, clocks);
+    m0 = myMissile0.tickSpan(myHctr, clocks);
+    m1 = myMissile1.tickSpan(myHctr, clocks);
+    p0 = myPlayer0.tickSpan(clocks);
+    p1 = myPlayer1.tickSpan(clocks);
+    bl = myBall.tickSpan(clocks);
+  }
+
+  const auto objectsOn = [&] (uInt32 i) -> uInt8 {
+    return
+      ((p0 >> i) & 0x01)       |
+      ((m0 >> i) & 0x01) << 1  |
+      ((p1 >> i) & 0x01) << 2  |
+      ((m1 >> i) & 0x01) << 3  |
+      ((bl >> i) & 0x01) << 4  |
+      ((pf >> i) & 0x01) << 5;
+  };
+
+  const uInt64 anyObjects = p0 | m0 | p1 | m1 | bl | pf;
+  const bool vblank = myFrameManager->vblank();
+
+  if (!vblank)
+  {
+    if (anyObjects != (~uInt64{0} >> (64 - clocks)))
+      myCollisionMask |= myCollisionTable[0];
+
+    if (anyObjects)
+      for (uInt32 i = 0; i < clocks; ++i)
+        if ((anyObjects >> i) & 0x01) myCollisionMask |= myCollisionTable[objectsOn(i)];
+  }
+
+  if (myFrameManager->isRendering())
+  {
+    PERF_SCOPE(tiaRender);
+
+    const auto pixels = myBackBuffer->begin() + myFrameManager->getY() * TIAConstants::H_PIXEL + x;
+
+    if (vblank)
+      std::fill_n(pixels, clocks, 0);
+    else if (!anyObjects)
+      std::fill_n(pixels, clocks, myBackground.getColor());
+    else
+    {
+      const auto& source = pixelSource[static_cast<int>(myPriority)];
+      auto colors = objectColors(x);
+
+      for (uInt32 i = 0; i < clocks; ++i) {
+        colors[TIAColor::PFColor] = myPlayfield.getColor(x + i);
+        pixels[i] = colors[source[objectsOn(i)]];
+      }
+    }
+  }
+
+  myDelayQueue.skip(clocks);
+
+  myCollisionUpdateRequired = true;
+  myCollisionUpdateScheduled = false;
+
+  myTimestamp += clocks;
+  myHctr += clocks;
+
+  if (myHctr >= TIAConstants::H_CLOCKS)
+    nextLine();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::applyRsync()
 {
@@ -1481,7 +1806,7 @@ void TIA::applyRsync()
 
   myHctrDelta = TIAConstants::H_CLOCKS - 3 - myHctr;
   if (myFrameManager->isRendering())
-    std::fill_n(myBackBuffer.begin() + myFrameManager->getY() * TIAConstants::H_PIXEL + x, TIAConstants::H_PIXEL - x, 0);
+    std::fill_n(myBackBuffer->begin() + myFrameManager->getY() * TIAConstants::H_PIXEL + x, TIAConstants::H_PIXEL - x, 0);
 
   myHctr = TIAConstants::H_CLOCKS - 3;
 }
@@ -1493,6 +1818,9 @@ void TIA::nextLine()
     cloneLastLine();
   }
 
+  if (myFrameManager->isRendering())
+    onScanlineDrawn(myFrameManager->getY());
+
   myHctr = 0;
 
   if (!myMovementInProgress && myLinesSinceChange < 2) ++myLinesSinceChange;
@@ -1520,8 +1848,22 @@ void TIA::cloneLastLine()
 
   if (!myFrameManager->isRendering() || y == 0) return;
 
-  std::copy_n(myBackBuffer.begin() + (y-1) * TIAConstants::H_PIXEL, TIAConstants::H_PIXEL,
-      myBackBuffer.begin() + y * TIAConstants::H_PIXEL);
+  std::copy_n(myBackBuffer->begin() + (y-1) * TIAConstants::H_PIXEL, TIAConstants::H_PIXEL,
+      myBackBuffer->begin() + y * TIAConstants::H_PIXEL);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::onScanlineDrawn(uInt32 y)
+{
+  if (y >= TIAConstants::frameBufferHeight) return;
+
+  // If frames were hidden meanwhile, the last completed frame is not the one
+  // handed over last
+  const auto row = myBackBuffer->cbegin() + y * TIAConstants::H_PIXEL;
+
+  myBackBufferDrawnTable[y] = true;
+  myBackBufferDirtyTable[y] = myHiddenFramesPending ||
+    !std::equal(row, row + TIAConstants::H_PIXEL, myLastFrameBuffer->cbegin() + y * TIAConstants::H_PIXEL);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1533,72 +1875,63 @@ void TIA::scheduleCollisionUpdate()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::updateCollision()
 {
-  myCollisionMask |= (
-    myPlayer0.collision &
-    myPlayer1.collision &
-    myMissile0.collision &
-    myMissile1.collision &
-    myBall.collision &
-    myPlayfield.collision
-  );
+  myCollisionMask |= myCollisionTable[objectsOn()];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::renderPixel(uInt32 x, uInt32 y)
 {
+  PERF_SCOPE(tiaRender);
+
   if (x >= TIAConstants::H_PIXEL) return;
 
   uInt8 color = 0;
 
   if (!myFrameManager->vblank())
   {
-    switch (myPriority)
-    {
-      case Priority::pfp:  // CTRLPF D2=1, D1=ignored
-        // Playfield has priority so ScoreBit isn't used
-        // Priority from highest to lowest:
-        //   BL/PF => P0/M0 => P1/M1 => BK
-        if (myPlayfield.isOn())       color = myPlayfield.getColor();
-        else if (myBall.isOn())       color = myBall.getColor();
-        else if (myPlayer0.isOn())    color = myPlayer0.getColor();
-        else if (myMissile0.isOn())   color = myMissile0.getColor();
-        else if (myPlayer1.isOn())    color = myPlayer1.getColor();
-        else if (myMissile1.isOn())   color = myMissile1.getColor();
-        else                          color = myBackground.getColor();
-        break;
+    color = objectColors(x)[pixelSource[static_cast<int>(myPriority)][objectsOn()]];
+  }
 
-      case Priority::score:  // CTRLPF D2=0, D1=1
-        // Formally we have (priority from highest to lowest)
-        //   PF/P0/M0 => P1/M1 => BL => BK
-        // for the first half and
-        //   P0/M0 => PF/P1/M1 => BL => BK
-        // for the second half. However, the first ordering is equivalent
-        // to the second (PF has the same color as P0/M0), so we can just
-        // write
-        if (myPlayer0.isOn())         color = myPlayer0.getColor();
-        else if (myMissile0.isOn())   color = myMissile0.getColor();
-        else if (myPlayfield.isOn())  color = myPlayfield.getColor();
-        else if (myPlayer1.isOn())    color = myPlayer1.getColor();
-        else if (myMissile1.isOn())   color = myMissile1.getColor();
-        else if (myBall.isOn())       color = myBall.getColor();
-        else                          color = myBackground.getColor();
-        break;
+  (*myBackBuffer)[y * TIAConstants::H_PIXEL + x] = color;
+}
 
-      case Priority::normal:  // CTRLPF D2=0, D1=0
-        // Priority from highest to lowest:
-        //   P0/M0 => P1/M1 => BL/PF => BK
-        if (myPlayer0.isOn())         color = myPlayer0.getColor();
-        else if (myMissile0.isOn())   color = myMissile0.getColor();
-        else if (myPlayer1.isOn())    color = myPlayer1.getColor();
-        else if (myMissile1.isOn())   color = myMissile1.getColor();
-        else if (myPlayfield.isOn())  color = myPlayfield.getColor();
-        else if (myBall.isOn())       color = myBall.getColor();
-        else                          color = myBackground.getColor();
-        break;
-    }
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 TIA::objectsOn() const
+{
+  return
+    myPlayer0.isOn()          |
+    myMissile0.isOn()   << 1  |
+    myPlayer1.isOn()    << 2  |
+    myMissile1.isOn()   << 3  |
+    myBall.isOn()       << 4  |
+    myPlayfield.isOn()  << 5;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+std::array<uInt8, 7> TIA::objectColors(uInt32 x) const
+{
+  return {
+    myBackground.getColor(),
+    myPlayfield.getColor(x),
+    myPlayer0.getColor(),
+    myPlayer1.getColor(),
+    myMissile0.getColor(),
+    myMissile1.getColor(),
+    myBall.getColor()
+  };
+}
 
-  myBackBuffer[y * TIAConstants::H_PIXEL + x] = color;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::updateCollisionTable()
+{
+  for (uInt32 objects = 0; objects < myCollisionTable.size(); ++objects)
+    myCollisionTable[objects] =
+      myPlayer0.getCollisionMask(objects & TIABit::P0Bit)   &
+      myMissile0.getCollisionMask(objects & TIABit::M0Bit)  &
+      myPlayer1.getCollisionMask(objects & TIABit::P1Bit)   &
+      myMissile1.getCollisionMask(objects & TIABit::M1Bit)  &
+      myBall.getCollisionMask(objects & TIABit::BLBit)      &
+      myPlayfield.getCollisionMask(objects & TIABit::PFBit);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1624,7 +1957,7 @@ void TIA::flushLineCache()
 void TIA::clearHmoveComb()
 {
   if (myFrameManager->isRendering() && myHstate == HState::blank)
-    std::fill_n(myBackBuffer.begin() + myFrameManager->getY() * TIAConstants::H_PIXEL, 8, myColorHBlank);
+    std::fill_n(myBackBuffer->begin() + myFrameManager->getY() * TIAConstants::H_PIXEL, 8, myColorHBlank);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1680,6 +2013,8 @@ void TIA::setBlInvertedPhaseClock(bool enable)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::delayedWrite(uInt8 address, uInt8 value)
 {
+  PERF_SCOPE(delayQueue);
+
   if (address < 64)
     myShadowRegisters[address] = value;
 
@@ -19,6 +19,8 @@
 #define TIA_TIA
 
 #include <functional>
+#include <atomic>
+#include <mutex>
 
 #include "bspf.hxx"
 #include "ConsoleIO.hxx"
@@ -131,6 +133,21 @@ class TIA : public Device
     */
     void setAudioQueue(const shared_ptr<AudioQueue>& audioQueue);
 
+    /**
+      Enable or disable the generation of audio samples (the run-ahead
+      mode discards the audio of the frames emulated ahead).
+    */
+    void setAudioMuted(bool muted) { myAudio.setMuted(muted); }
+
+    /**
+      Take the audio samples generated since the last call, and play them
+      back (see Audio); these are not part of the state.
+    */
+    void takeAudioSamples(ByteArray& samples) { myAudio.takeSamples(samples); }
+    void playAudioSamples(const uInt8* samples, size_t size) {
+      myAudio.playSamples(samples, size);
+    }
+
     /**
       Clear the configured frame manager and deteach the lifecycle callbacks.
      */
@@ -216,7 +233,7 @@ class TIA : public Device
     /**
       Did we generate a new frame?
      */
-    bool newFramePending() { return myFramesSinceLastRender  > 0; }
+    bool newFramePending() { return myFramesSinceLastRender > 0; }
 
     /**
      * Clear any pending frames.
@@ -228,24 +245,54 @@ class TIA : public Device
      */
     uInt32 framesSinceLastRender() { return myFramesSinceLastRender; }
 
+    /**
+      Hidden frames are not handed over to the front buffer; the next frame
+      is drawn over them instead (the run-ahead mode displays only the last
+      frame emulated ahead).
+     */
+    void setFramesHidden(bool hidden) { myFramesHidden = hidden; }
+
     /**
       Render the pending frame to the framebuffer and clear the flag.
+      The buffers are exchanged under a lock, so this may be called while
+      the emulation is running on a different thread.
+
+      @return  The number of frames completed since the last render
      */
-    void renderToFrameBuffer();
+    uInt32 renderToFrameBuffer();
 
     /**
       Return the buffer that holds the currently drawing TIA frame
       (the TIA output widget needs this).
      */
-    uInt8* outputBuffer() { return myBackBuffer.data(); }
+    uInt8* outputBuffer() { return myBackBuffer->data(); }
+
+    /**
+      Return the buffer that holds the last completed TIA frame
+      (the TIA output widget shows it below the current beam position).
+     */
+    uInt8* lastFrameBuffer() { return myLastFrameBuffer->data(); }
 
     /**
       Returns a pointer to the internal frame buffer.
     */
-    uInt8* frameBuffer() { return myFramebuffer.data(); }
+    uInt8* frameBuffer() { return myFramebuffer->data(); }
 
     void clearFrameBuffer();
 
+    /**
+      Answers whether the framebuffer (or the given scanline of it) has
+      changed since the last call to clearDirtyScanlines().  This allows
+      unchanged frames to skip conversion and upload to the screen.
+    */
+    bool isFrameBufferDirty() const { return myFrameBufferIsDirty; }
+    bool isScanlineDirty(uInt32 y) const { return myScanlineIsDirtyTable[y]; }
+
+    /**
+      Mark all scanlines of the framebuffer as unchanged.
+    */
+    void clearDirtyScanlines();
+
     /**
       Answers dimensional info about the framebuffer.
     */
@@ -322,12 +369,12 @@ class TIA : public Device
     */
     uInt64 cycles() const { return uInt64(mySystem->cycles()); }
 
-  #ifdef DEBUGGER_SUPPORT
     /**
       Answers the frame count from the start of the emulation.
     */
     uInt32 frameCount() const { return myFrameManager->frameCount(); }
 
+  #ifdef DEBUGGER_SUPPORT
     /**
       Answers the system cycles from the start of the current frame.
     */
@@ -550,6 +597,17 @@ class TIA : public Device
     */
     bool load(Serializer& in) override;
 
+    /**
+      Save the state which determines the further emulation to the given
+      Serializer, for checksums comparing emulations with and without a
+      display.  Unlike save(), this leaves out the frame manager with its
+      frame counters, the rendering position and the debugger information.
+
+      @param out  The Serializer object to use
+      @return  False on any errors, else true
+    */
+    bool saveChecksumState(Serializer& out) const;
+
     /**
      * Run and forward TIA emulation to the current system clock.
      */
@@ -571,8 +629,8 @@ class TIA : public Device
     enum class HState {blank, frame};
 
     /**
-     * The three different modes of the priority encoder. Check TIA::renderPixel
-     * for a precise definition.
+     * The three different modes of the priority encoder. Check the pixel source
+     * table in TIA.cxx for a precise definition.
      */
     enum class Priority {pfp, score, normal};
 
@@ -599,6 +657,11 @@ class TIA : public Device
      */
     void onFrameComplete();
 
+    /**
+      Mark all scanlines of the framebuffer as changed.
+    */
+    void setFrameBufferDirty();
+
     /**
      * Called when the CPU enters halt state (RDY pulled low). Execution continues
      * immediatelly afterwards, so we have to adjust the system clock to account
@@ -626,6 +689,21 @@ class TIA : public Device
      */
     void tickHframe();
 
+    /**
+     * Advance a span of clocks during the visible part of the scanline. This is
+     * equivalent to calling tickHframe() for each clock, but ticks each object
+     * through the whole span before the pixels are resolved. Only valid for spans
+     * determined by spanClocks().
+     */
+    void tickHframeSpan(uInt32 clocks);
+
+    /**
+     * The number of clocks (at most maxClocks) that can be processed by
+     * tickHframeSpan(), or zero if the next clock requires the exact path
+     * (hblank, movement, RSYNC or a pending delayed write).
+     */
+    uInt32 spanClocks(uInt32 maxClocks) const;
+
     /**
      * Update the collision bitfield.
      */
@@ -641,6 +719,24 @@ class TIA : public Device
      */
     void renderPixel(uInt32 x, uInt32 y);
 
+    /**
+     * The objects which are on at the current clock (a combination of TIABit
+     * values).
+     */
+    uInt8 objectsOn() const;
+
+    /**
+     * The colors of the background and the objects at the given pixel, indexed
+     * by TIAColor.
+     */
+    std::array<uInt8, 7> objectColors(uInt32 x) const;
+
+    /**
+     * Recalculate the collision lookup table from the collision masks of the
+     * objects. Must be called whenever collisions are toggled.
+     */
+    void updateCollisionTable();
+
     /**
      * Clear the first 8 pixels of a scanline with black if we are in hblank
      * (called during HMOVE).
@@ -657,6 +753,12 @@ class TIA : public Device
      */
     void cloneLastLine();
 
+    /**
+     * Mark a scanline of the back buffer as drawn in the current frame and
+     * check whether it changed compared to the last completed frame.
+     */
+    void onScanlineDrawn(uInt32 y);
+
     /**
      * Execute a delayed write. Called when the DelayQueue is pumped.
      */
@@ -758,6 +860,11 @@ class TIA : public Device
      */
     static constexpr unsigned delayQueueSize = 16;
 
+    /**
+     * The maximum number of clocks rendered in a single span.
+     */
+    static constexpr uInt32 maxSpanClocks = 64;
+
     /**
      * A list of delayed writes that are queued up for future execution. Delayed
      * writes can be both actual writes whose effect is delayed by one or more clocks
@@ -804,20 +911,51 @@ class TIA : public Device
     LatchedInput myInput0;
     LatchedInput myInput1;
 
-    // Pointer to the internal color-index-based frame buffer
-    std::array<uInt8, TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight> myFramebuffer;
+    // The color-index-based frame buffers; the frame is rendered to the back
+    // buffer, handed over to the front buffer upon completion and exchanged
+    // with the (internal) framebuffer when it is rendered.  Only the pointers
+    // are swapped, so each buffer is owned by exactly one side at a time:
+    // the back buffer by the emulation, the framebuffer by the renderer.
+    using FrameData = std::array<uInt8, TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight>;
+    std::array<FrameData, 3> myFrameBuffers;
+
+    FrameData* myBackBuffer{&myFrameBuffers[0]};
+    FrameData* myFrontBuffer{&myFrameBuffers[1]};
+    FrameData* myFramebuffer{&myFrameBuffers[2]};
+
+    // The last completed frame (either the front buffer or the framebuffer,
+    // or the back buffer itself if that frame was hidden)
+    FrameData* myLastFrameBuffer{myFrontBuffer};
+
+    // Whether completed frames are hidden, and whether any frame was hidden
+    // since the last one handed over to the front buffer
+    bool myFramesHidden{false};
+    bool myHiddenFramesPending{false};
+
+    // Scanlines drawn to the back buffer in the current frame, and which of
+    // them differ from the last completed frame; both are updated as each
+    // scanline is finished
+    std::array<bool, TIAConstants::frameBufferHeight> myBackBufferDrawnTable;
+    std::array<bool, TIAConstants::frameBufferHeight> myBackBufferDirtyTable;
+
+    // Guards handing over the front buffer between emulation and renderer
+    std::mutex myFrontBufferMutex;
+
+    // We snapshot frame statistics when the back buffer is handed over to the
+    // front buffer and when the front buffer is exchanged with the framebuffer
+    uInt32 myFrontBufferScanlines{0}, myFrameBufferScanlines{0};
 
-    // The frame is rendered to the backbuffer and only copied to the framebuffer
-    // upon completion
-    std::array<uInt8, TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight> myBackBuffer;
-    std::array<uInt8, TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight> myFrontBuffer;
+    // Scanlines of the front buffer which changed since it was last
+    // exchanged with the framebuffer
+    std::array<bool, TIAConstants::frameBufferHeight> myFrontBufferDirtyTable;
 
-    // We snapshot frame statistics when the back buffer is copied to the front buffer
-    // and when the front buffer is copied to the frame buffer
-    uInt32 myFrontBufferScanlines{0}, myFrameBufferScanlines{0};
+    // Scanlines of the framebuffer which changed since the last call to
+    // clearDirtyScanlines()
+    std::array<bool, TIAConstants::frameBufferHeight> myScanlineIsDirtyTable;
+    bool myFrameBufferIsDirty{true};
 
     // Frames since the last time a frame was rendered to the render buffer
-    uInt32 myFramesSinceLastRender{0};
+    std::atomic<uInt32> myFramesSinceLastRender{0};
 
     /**
      * Setting this to true injects random values into undefined reads.
@@ -890,6 +1028,12 @@ class TIA : public Device
      */
     Priority myPriority{Priority::normal};
 
+    /**
+     * The combined collision mask for each combination of objects which are on
+     * (indexed by TIABit), see updateCollisionTable().
+     */
+    std::array<uInt32, 64> myCollisionTable;
+
     /**
      * The index of the last CPU cycle that was included in the simulation.
      */
@@ -28,6 +28,7 @@ namespace GUI {
 Font::Font(const FontDesc& desc)
   : myFontDesc{desc}
 {
+  decodeGlyphs();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -59,4 +60,86 @@ int Font::getStringWidth(const string& str) const
         [&](int x, char c) { return x + getCharWidth(c); });
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const Font::Glyph* Font::getGlyph(uInt8 chr) const
+{
+  // If this character is not included in the font, use the default char.
+  if(chr < myFontDesc.firstchar || chr >= myFontDesc.firstchar + myFontDesc.size)
+  {
+    if(chr == ' ')
+      return nullptr;
+    chr = myFontDesc.defaultchar;
+  }
+
+  return &myGlyphs[chr - myFontDesc.firstchar];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Font::decodeGlyphs()
+{
+  // Add the runs of set pixels in the given rows (bit x = pixel x)
+  const auto addRuns = [](vector<GlyphRun>& runs, const vector<uInt32>& rows) {
+    for(size_t y = 0; y < rows.size(); ++y)
+    {
+      uInt32 row = rows[y];
+      for(uInt8 x = 0; row; )
+      {
+        if(!(row & 1))
+        {
+          row >>= 1;  ++x;
+          continue;
+        }
+        uInt8 len = 0;
+        while(row & 1)
+        {
+          row >>= 1;  ++len;
+        }
+        runs.push_back({x, uInt8(y), len});
+        x += len;
+      }
+    }
+  };
+
+  myGlyphs.resize(myFontDesc.size);
+  for(int chr = 0; chr < myFontDesc.size; ++chr)
+  {
+    Glyph& glyph = myGlyphs[chr];
+
+    // Get the bounding box of the character
+    if(!myFontDesc.bbx)
+    {
+      glyph.bbw = myFontDesc.fbbw;
+      glyph.bbh = myFontDesc.fbbh;
+      glyph.bbx = myFontDesc.fbbx;
+      glyph.bby = myFontDesc.fbby;
+    }
+    else
+    {
+      glyph.bbw = myFontDesc.bbx[chr].w;  // NOLINT
+      glyph.bbh = myFontDesc.bbx[chr].h;  // NOLINT
+      glyph.bbx = myFontDesc.bbx[chr].x;  // NOLINT
+      glyph.bby = myFontDesc.bbx[chr].y;  // NOLINT
+    }
+
+    const uInt16* bits = myFontDesc.bits +
+      (myFontDesc.offset ? myFontDesc.offset[chr] : (chr * myFontDesc.fbbh));
+
+    vector<uInt32> rows(glyph.bbh), shadowRows(glyph.bbh + 1);
+    for(int y = 0; y < glyph.bbh; ++y)
+    {
+      const uInt16 ptr = *bits++;
+      uInt16 mask = 0x8000;
+
+      for(int x = 0; x < glyph.bbw; ++x, mask >>= 1)
+        if(ptr & mask)
+          rows[y] |= 1 << x;
+
+      shadowRows[y]     |= rows[y] << 1;
+      shadowRows[y + 1] |= rows[y] | rows[y] << 1;
+    }
+    addRuns(glyph.runs, rows);
+    addRuns(glyph.shadowRuns, shadowRows);
+  }
+}
+
 }  // namespace GUI
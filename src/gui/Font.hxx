@@ -31,6 +31,14 @@ struct BBX
   Int8 y;
 };
 
+/* horizontal run of set pixels in a glyph, relative to its bounding box */
+struct GlyphRun
+{
+  uInt8 x{0};
+  uInt8 y{0};
+  uInt8 len{0};
+};
+
 /* builtin C-based proportional/fixed font structure */
 /* based on The Microwindows Project http://microwindows.org */
 struct FontDesc
@@ -54,6 +62,17 @@ namespace GUI {
 
 class Font
 {
+  public:
+    // A glyph, decoded from the font bitmap data into runs of set pixels
+    struct Glyph
+    {
+      int bbw{0}, bbh{0}, bbx{0}, bby{0};  // bounding box
+      vector<GlyphRun> runs;
+      // The shadow is the glyph shifted one pixel right, down and both;
+      // it is one pixel wider and higher than the glyph
+      vector<GlyphRun> shadowRuns;
+    };
+
   public:
     explicit Font(const FontDesc& desc);
 
@@ -67,9 +86,22 @@ class Font
 
     int getStringWidth(const string& str) const;
 
+    /**
+      Get the decoded glyph of the given character.
+
+      @return  The glyph, or nullptr if there is nothing to draw
+    */
+    const Glyph* getGlyph(uInt8 chr) const;
+
+  private:
+    // Decode the glyphs from the font bitmap data
+    void decodeGlyphs();
+
   private:
     FontDesc myFontDesc;
 
+    vector<Glyph> myGlyphs;
+
   private:
     // Following constructors and assignment operators not supported
     Font() = delete;
@@ -24,7 +24,7 @@
 #include "EditTextWidget.hxx"
 #include "FileListWidget.hxx"
 #include "FSNode.hxx"
-#include "MD5.hxx"
+#include "HashManager.hxx"
 #include "OptionsDialog.hxx"
 #include "HighScoresDialog.hxx"
 #include "HighScoresManager.hxx"
@@ -328,7 +328,7 @@ const string& LauncherDialog::selectedRomMD5()
   // Lookup MD5, and if not present, cache it
   auto iter = myMD5List.find(currentNode().getPath());
   if(iter == myMD5List.end())
-    myMD5List[currentNode().getPath()] = MD5::hash(currentNode());
+    myMD5List[currentNode().getPath()] = instance().hashManager().hash(currentNode());
 
   return myMD5List[currentNode().getPath()];
 }
@@ -598,11 +598,26 @@ void LauncherDialog::loadRomInfo()
   if(!myRomInfoWidget)
     return;
 
-  const string& md5 = selectedRomMD5();
-  if(md5 != EmptyString)
-    myRomInfoWidget->setProperties(currentNode(), md5);
-  else
+  if(currentNode().isDirectory() || !Bankswitch::isValidRomName(currentNode()))
+  {
     myRomInfoWidget->clearProperties();
+    return;
+  }
+  // The info is loaded in the background, so that scrolling is not blocked
+  myRomInfoWidget->setProperties(currentNode());
+
+  // Also prepare the ROMs which will most likely be selected next
+  const FSList& files = myList->fileList();
+  const int selected = myList->getSelected();
+  FSList neighbours;
+
+  for(int dist = 1; dist <= PREFETCH_ROMS; ++dist)
+    for(int idx: { selected + dist, selected - dist })
+      if(idx >= 0 && idx < int(files.size()) && !files[idx].isDirectory() &&
+         Bankswitch::isValidRomName(files[idx]))
+        neighbours.push_back(files[idx]);
+
+  myRomInfoWidget->prefetchProperties(neighbours);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
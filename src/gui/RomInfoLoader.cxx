@@ -0,0 +1,190 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "MD5.hxx"
+#include "RomInfoLoader.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomInfoLoader::RomInfoLoader()
+{
+  myThread = std::thread([this]{ run(); });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomInfoLoader::~RomInfoLoader()
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myStop = true;
+    myJobs.clear();
+  }
+  myWakeup.notify_one();
+  myThread.join();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomInfoLoader::loadRom(const FilesystemNode& node, bool urgent)
+{
+  Job job;
+  job.type = Result::Type::Rom;
+  job.node = node;
+
+  queue(std::move(job), urgent);
+}
+
+#ifdef PNG_SUPPORT
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomInfoLoader::loadSnapshot(const string& filename, const string& fallback,
+                                 bool urgent)
+{
+  Job job;
+  job.type = Result::Type::Snapshot;
+  job.filename = filename;
+  job.fallback = fallback;
+
+  queue(std::move(job), urgent);
+}
+#endif
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomInfoLoader::queue(Job&& job, bool urgent)
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    if(key(job) == myActiveKey)
+      return;
+
+    for(auto it = myJobs.begin(); it != myJobs.end(); ++it)
+      if(it->type == job.type && key(*it) == key(job))
+      {
+        if(!urgent)
+          return;
+
+        myJobs.erase(it);
+        break;
+      }
+
+    if(urgent)
+      myJobs.push_front(std::move(job));
+    else
+      myJobs.push_back(std::move(job));
+  }
+  myWakeup.notify_one();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomInfoLoader::cancel()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  myJobs.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RomInfoLoader::poll(Result& result)
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  if(myResults.empty())
+    return false;
+
+  result = std::move(myResults.front());
+  myResults.pop_front();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomInfoLoader::run()
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  while(true)
+  {
+    myWakeup.wait(lock, [this]{ return myStop || !myJobs.empty(); });
+    if(myStop)
+      break;
+
+    const Job job = std::move(myJobs.front());
+    myJobs.pop_front();
+    myActiveKey = key(job);
+
+    lock.unlock();
+
+    Result result;
+    result.type = job.type;
+    result.node = job.node;
+    result.filename = job.filename;
+
+    if(job.type == Result::Type::Rom)
+      loadRom(result);
+  #ifdef PNG_SUPPORT
+    else
+      loadSnapshot(job, result);
+  #endif
+
+    lock.lock();
+
+    myActiveKey.clear();
+    myResults.push_back(std::move(result));
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomInfoLoader::loadRom(Result& result)
+{
+  try
+  {
+    result.size = result.node.read(result.image);
+    result.md5 = MD5::hash(result.image, result.size);
+  }
+  catch(const runtime_error& e)
+  {
+    result.size = 0;
+    result.error = e.what();
+  }
+}
+
+#ifdef PNG_SUPPORT
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomInfoLoader::loadSnapshot(const Job& job, Result& result)
+{
+  try
+  {
+    PNGLibrary::decodeImage(job.filename, result.snapshot);
+  }
+  catch(const runtime_error& e)
+  {
+    result.error = e.what();
+
+    // Try to load a default image if no ROM image exists
+    if(job.fallback != EmptyString)
+    {
+      try
+      {
+        PNGLibrary::decodeImage(job.fallback, result.snapshot);
+        result.error = "";
+      }
+      catch(const runtime_error&)
+      {
+      }
+    }
+  }
+}
+#endif
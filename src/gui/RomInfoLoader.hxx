@@ -0,0 +1,147 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2021 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef ROM_INFO_LOADER_HXX
+#define ROM_INFO_LOADER_HXX
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+#include "FSNode.hxx"
+#ifdef PNG_SUPPORT
+  #include "PNGLibrary.hxx"
+#endif
+
+/**
+  This class loads ROM images and decodes snapshots on a background thread,
+  so that the launcher stays responsive while the selection moves through
+  the list.
+
+  Requests are processed in order, urgent ones (for the current selection)
+  first.  Requests which have not been started yet can be cancelled once
+  they become stale.  Results are collected by polling from the GUI thread,
+  which is the only one allowed to touch properties, settings and surfaces.
+*/
+class RomInfoLoader
+{
+  public:
+    struct Result {
+      enum class Type { Rom, Snapshot };
+      Type type{Type::Rom};
+
+      // The requested ROM or snapshot file
+      FilesystemNode node;
+      string filename;
+
+      // The ROM contents and their MD5
+      ByteBuffer image;
+      size_t size{0};
+      string md5;
+
+    #ifdef PNG_SUPPORT
+      // The decoded snapshot
+      PNGLibrary::ImageData snapshot;
+    #endif
+
+      // Non-empty if loading failed
+      string error;
+    };
+
+  public:
+    RomInfoLoader();
+    ~RomInfoLoader();
+
+    /**
+      Request loading a ROM file.  Requests for files which are already
+      queued or being loaded are ignored (urgent ones are moved to the front).
+    */
+    void loadRom(const FilesystemNode& node, bool urgent = false);
+
+  #ifdef PNG_SUPPORT
+    /**
+      Request decoding a snapshot.  If the file can't be loaded, 'fallback'
+      is tried instead (if specified).
+    */
+    void loadSnapshot(const string& filename, const string& fallback,
+                      bool urgent = false);
+  #endif
+
+    /**
+      Drop all requests which haven't been started yet.
+    */
+    void cancel();
+
+    /**
+      Get the next finished request.
+
+      @return  False if there are no results available
+    */
+    bool poll(Result& result);
+
+    /**
+      Load a ROM file directly on the calling thread; used for files
+      which can't be loaded in the background (e.g. from ZIP archives,
+      since all of them share the same decompressor).
+    */
+    static void loadRom(Result& result);
+
+  private:
+    struct Job {
+      Result::Type type{Result::Type::Rom};
+      FilesystemNode node;
+      string filename, fallback;
+    };
+
+    void queue(Job&& job, bool urgent);
+
+    static const string& key(const Job& job) {
+      return job.type == Result::Type::Rom ? job.node.getPath() : job.filename;
+    }
+
+    void run();
+
+  #ifdef PNG_SUPPORT
+    static void loadSnapshot(const Job& job, Result& result);
+  #endif
+
+  private:
+    std::mutex myMutex;
+    std::condition_variable myWakeup;
+
+    std::deque<Job> myJobs;
+    std::deque<Result> myResults;
+
+    // The key of the request currently being processed
+    string myActiveKey;
+
+    bool myStop{false};
+
+    std::thread myThread;
+
+  private:
+    // Following constructors and assignment operators not supported
+    RomInfoLoader(const RomInfoLoader&) = delete;
+    RomInfoLoader(RomInfoLoader&&) = delete;
+    RomInfoLoader& operator=(const RomInfoLoader&) = delete;
+    RomInfoLoader& operator=(RomInfoLoader&&) = delete;
+};
+
+#endif
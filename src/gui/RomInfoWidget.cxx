@@ -24,6 +24,7 @@
 #include "ControllerDetector.hxx"
 #include "Bankswitch.hxx"
 #include "CartDetector.hxx"
+#include "HashManager.hxx"
 #include "Logger.hxx"
 #include "Props.hxx"
 #include "PNGLibrary.hxx"
@@ -46,15 +47,19 @@ RomInfoWidget::RomInfoWidget(GuiObject* boss, const GUI::Font& font,
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void RomInfoWidget::setProperties(const FilesystemNode& node, const string& md5)
+RomInfoWidget::~RomInfoWidget()
 {
-  myHaveProperties = true;
+  clearCaches();
+}
 
-  // Make sure to load a per-ROM properties entry, if one exists
-  instance().propSet().loadPerROM(node, md5);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomInfoWidget::setProperties(const FilesystemNode& node)
+{
+  myHaveProperties = true;
+  myNode = node;
 
-  // And now get the properties for this ROM
-  instance().propSet().getMD5(md5, myProperties);
+  // Whatever hasn't been loaded yet is not needed anymore
+  myLoader.cancel();
 
   // Decide whether the information should be shown immediately
   if(instance().eventHandler().state() == EventHandlerState::LAUNCHER)
@@ -80,46 +85,116 @@ void RomInfoWidget::reloadProperties(const FilesystemNode& node)
   // by saving a different image or through a change in video renderer,
   // so we reload the properties
   if(myHaveProperties)
+  {
+    clearCaches();
     parseProperties(node);
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void RomInfoWidget::parseProperties(const FilesystemNode& node)
+void RomInfoWidget::prefetchProperties(const FSList& nodes)
+{
+  for(const auto& node: nodes)
+  {
+    const RomData* data = romData(node, false);
+
+  #ifdef PNG_SUPPORT
+    // The snapshot name is only known once the ROM has been loaded; in
+    // that case it is requested as soon as the ROM arrives
+    if(data != nullptr && data->md5 != EmptyString)
+    {
+      Properties props;
+      instance().propSet().getMD5(data->md5, props);
+      snapshot(snapshotName(props), false);
+    }
+  #else
+    (void)data;
+  #endif
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomInfoWidget::tick()
 {
-  // Check if a surface has ever been created; if so, we use it
-  // The surface will always be the maximum size, but sometimes we'll
-  // only draw certain parts of it
-  if(mySurface == nullptr)
+  RomInfoLoader::Result result;
+
+  while(myLoader.poll(result))
   {
-    mySurface = instance().frameBuffer().allocateSurface(
-        myAvail.w, myAvail.h, ScalingInterpolation::blur);
-    mySurface->applyAttributes();
+    bool current = false;
 
+    if(result.type == RomInfoLoader::Result::Type::Rom)
+    {
+      romLoaded(result);
+      current = result.node.getPath() == myNode.getPath();
+    }
+  #ifdef PNG_SUPPORT
+    else
+    {
+      snapshotLoaded(result);
+      current = result.filename == snapshotName(myProperties);
+    }
+  #endif
+
+    // Update the display if the selected ROM was waiting for this
+    if(current && myHaveProperties &&
+       instance().eventHandler().state() == EventHandlerState::LAUNCHER)
+      parseProperties(myNode);
+  }
+
+  Widget::tick();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomInfoWidget::parseProperties(const FilesystemNode& node)
+{
+  // Make sure the current surface is drawn
+  if(!myHaveRenderCallback)
+  {
     dialog().addRenderCallback([this]() {
       if(mySurfaceIsValid)
         mySurface->render();
       }
     );
+    myHaveRenderCallback = true;
   }
 
   // Initialize to empty properties entry
   mySurfaceErrorMsg = "";
   mySurfaceIsValid = false;
   myRomInfo.clear();
+  myUrl = "";
 
-#ifdef PNG_SUPPORT
-  // Get a valid filename representing a snapshot file for this rom
-  const string& filename = instance().snapshotLoadDir().getPath() +
-      myProperties.get(PropType::Cart_Name) + ".png";
+  const RomData* data = romData(node, true);
+  if(data == nullptr || data->md5 == EmptyString)
+  {
+    // Either still loading, or not a valid ROM at all
+    if(mySurface)
+      mySurface->setVisible(mySurfaceIsValid);
+    setDirty();
+    return;
+  }
 
-  // Read the PNG file
-  mySurfaceIsValid = loadPng(filename);
+  // Make sure to load a per-ROM properties entry, if one exists
+  instance().propSet().loadPerROM(node, data->md5);
 
-  // Try to load a default image if not ROM image exists
-  if(!mySurfaceIsValid)
+  // And now get the properties for this ROM
+  instance().propSet().getMD5(data->md5, myProperties);
+
+#ifdef PNG_SUPPORT
+  // Get the snapshot representing this ROM (or the default one), unless it
+  // still has to be loaded
+  const Snapshot* snap = snapshot(snapshotName(myProperties), true);
+  if(snap != nullptr)
   {
-    mySurfaceIsValid = loadPng(instance().snapshotLoadDir().getPath() +
-                               "default_snapshot.png");
+    if(snap->surface)
+    {
+      if(mySurface && mySurface != snap->surface)
+        mySurface->setVisible(false);
+      mySurface = snap->surface;
+      mySurfaceIsValid = true;
+    }
+    else
+      mySurfaceErrorMsg = snap->error;
   }
 #else
   mySurfaceErrorMsg = "PNG image loading not supported";
@@ -142,72 +217,183 @@ void RomInfoWidget::parseProperties(const FilesystemNode& node)
     myRomInfo.push_back("Rarity: " + value);
   if((value = myProperties.get(PropType::Cart_Note)) != EmptyString)
     myRomInfo.push_back("Note: " + value);
-  bool swappedPorts = myProperties.get(PropType::Console_SwapPorts) == "YES";
-
-  // Load the image for controller and bankswitch type auto detection
-  string left = myProperties.get(PropType::Controller_Left);
-  string right = myProperties.get(PropType::Controller_Right);
-  Controller::Type leftType = Controller::getType(left);
-  Controller::Type rightType = Controller::getType(right);
-  string bsDetected = myProperties.get(PropType::Cart_Type);
-  try
-  {
-    ByteBuffer image;
-    string md5 = "";  size_t size = 0;
 
-    if(node.exists() && !node.isDirectory() &&
-      (image = instance().openROM(node, md5, size)) != nullptr)
+  if(data->left != "" && data->right != "")
+    myRomInfo.push_back("Controllers: " + (data->left + " (left), " + data->right + " (right)"));
+
+  if(data->bsDetected != "")
+    myRomInfo.push_back("Type: " + Bankswitch::typeToDesc(Bankswitch::nameToType(data->bsDetected)));
+
+  setDirty();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const RomInfoWidget::RomData* RomInfoWidget::romData(const FilesystemNode& node,
+                                                     bool urgent)
+{
+  const auto iter = myRomData.find(node.getPath());
+  if(iter != myRomData.end())
+    return &iter->second;
+
+  // All ZIP files share the same decompressor, which can't be used from
+  // multiple threads; so these are loaded directly, and never prefetched
+  if(BSPF::containsIgnoreCase(node.getPath(), ".zip"))
+  {
+    if(urgent)
     {
-      Logger::debug(myProperties.get(PropType::Cart_Name) + ":");
-      left = ControllerDetector::detectName(image, size, leftType,
-          !swappedPorts ? Controller::Jack::Left : Controller::Jack::Right,
-          instance().settings());
-      right = ControllerDetector::detectName(image, size, rightType,
-          !swappedPorts ? Controller::Jack::Right : Controller::Jack::Left,
-          instance().settings());
-      if (bsDetected == "AUTO")
-        bsDetected = Bankswitch::typeToName(CartDetector::autodetectType(image, size));
+      RomInfoLoader::Result result;
+      result.node = node;
+      RomInfoLoader::loadRom(result);
+      romLoaded(result);
+
+      return &myRomData[node.getPath()];
     }
+    return nullptr;
   }
-  catch(const runtime_error&)
+
+  myLoader.loadRom(node, urgent);
+  return nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomInfoWidget::romLoaded(const RomInfoLoader::Result& result)
+{
+  // Attempt to conserve memory
+  if(myRomData.size() > ROM_CACHE_SIZE)
+    myRomData.clear();
+
+  RomData& data = myRomData[result.node.getPath()];
+  data = RomData();
+
+  if(result.size > 0)
   {
-    // Do nothing; we simply don't update the controllers if openROM
-    // failed for any reason
-    left = right = "";
+    data.md5 = result.md5;
+    instance().hashManager().store(result.node, data.md5);
+
+    // Make sure to load a per-ROM properties entry, if one exists
+    Properties props;
+    instance().propSet().loadPerROM(result.node, data.md5);
+    instance().propSet().getMD5(data.md5, props);
+
+    // Use the image for controller and bankswitch type auto detection
+    const bool swappedPorts = props.get(PropType::Console_SwapPorts) == "YES";
+    const Controller::Type leftType = Controller::getType(props.get(PropType::Controller_Left));
+    const Controller::Type rightType = Controller::getType(props.get(PropType::Controller_Right));
+
+    Logger::debug(props.get(PropType::Cart_Name) + ":");
+    data.left = ControllerDetector::detectName(result.image, result.size, leftType,
+        !swappedPorts ? Controller::Jack::Left : Controller::Jack::Right,
+        instance().settings());
+    data.right = ControllerDetector::detectName(result.image, result.size, rightType,
+        !swappedPorts ? Controller::Jack::Right : Controller::Jack::Left,
+        instance().settings());
+
+    data.bsDetected = props.get(PropType::Cart_Type);
+    if(data.bsDetected == "AUTO")
+      data.bsDetected = Bankswitch::typeToName(CartDetector::autodetectType(result.image, result.size));
+
+    // The snapshot can be prefetched now that its name is known
+  #ifdef PNG_SUPPORT
+    if(result.node.getPath() != myNode.getPath())
+      snapshot(snapshotName(props), false);
+  #endif
   }
-  if(left != "" && right != "")
-    myRomInfo.push_back("Controllers: " + (left + " (left), " + right + " (right)"));
+}
 
-  if (bsDetected != "")
-    myRomInfo.push_back("Type: " + Bankswitch::typeToDesc(Bankswitch::nameToType(bsDetected)));
+#ifdef PNG_SUPPORT
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const RomInfoWidget::Snapshot* RomInfoWidget::snapshot(const string& filename,
+                                                       bool urgent)
+{
+  const auto iter = mySnapshotMap.find(filename);
+  if(iter != mySnapshotMap.end())
+  {
+    // Mark as most recently used
+    mySnapshots.splice(mySnapshots.begin(), mySnapshots, iter->second);
+    return &*iter->second;
+  }
 
-  setDirty();
+  myLoader.loadSnapshot(filename,
+      instance().snapshotLoadDir().getPath() + "default_snapshot.png", urgent);
+  return nullptr;
 }
 
-#ifdef PNG_SUPPORT
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool RomInfoWidget::loadPng(const string& filename)
+void RomInfoWidget::snapshotLoaded(const RomInfoLoader::Result& result)
 {
-  try
+  if(mySnapshotMap.find(result.filename) != mySnapshotMap.end())
+    return;
+
+  Snapshot snap;
+  snap.filename = result.filename;
+
+  if(result.error == EmptyString)
   {
-    instance().png().loadImage(filename, *mySurface);
+    const PNGLibrary::ImageData& image = result.snapshot;
+
+    snap.surface = instance().frameBuffer().allocateSurface(
+        image.width, image.height, ScalingInterpolation::blur);
+    snap.surface->applyAttributes();
+    snap.surface->setVisible(false);
+    instance().png().loadImage(image, *snap.surface);
 
     // Scale surface to available image area
-    const Common::Rect& src = mySurface->srcRect();
-    float scale = std::min(float(myAvail.w) / src.w(), float(myAvail.h) / src.h()) *
+    const Common::Rect& src = snap.surface->srcRect();
+    const float scale = std::min(float(myAvail.w) / src.w(), float(myAvail.h) / src.h()) *
       instance().frameBuffer().hidpiScaleFactor();
-    mySurface->setDstSize(uInt32(src.w() * scale), uInt32(src.h() * scale));
+    snap.surface->setDstSize(uInt32(src.w() * scale), uInt32(src.h() * scale));
 
-    return true;
+    snap.size = size_t(image.width) * image.height * sizeof(uInt32);
   }
-  catch(const runtime_error& e)
+  else
+    snap.error = result.error;
+
+  mySnapshots.push_front(std::move(snap));
+  mySnapshotMap[result.filename] = mySnapshots.begin();
+  mySnapshotCacheSize += mySnapshots.front().size;
+
+  // Evict the least recently used snapshots, but never the one shown
+  for(auto iter = std::prev(mySnapshots.end());
+      (mySnapshotCacheSize > SNAPSHOT_CACHE_SIZE || mySnapshots.size() > ROM_CACHE_SIZE) &&
+      iter != mySnapshots.begin(); )
   {
-    mySurfaceErrorMsg = e.what();
+    auto prev = std::prev(iter);
+    if(!iter->surface || iter->surface != mySurface)
+    {
+      instance().frameBuffer().deallocateSurface(iter->surface);
+      mySnapshotCacheSize -= iter->size;
+      mySnapshotMap.erase(iter->filename);
+      mySnapshots.erase(iter);
+    }
+    iter = prev;
   }
-  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string RomInfoWidget::snapshotName(const Properties& props) const
+{
+  // Get a valid filename representing a snapshot file for this rom
+  return instance().snapshotLoadDir().getPath() +
+      props.get(PropType::Cart_Name) + ".png";
 }
 #endif
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomInfoWidget::clearCaches()
+{
+  myLoader.cancel();
+  myRomData.clear();
+
+  for(const auto& snap: mySnapshots)
+    instance().frameBuffer().deallocateSurface(snap.surface);
+  mySnapshots.clear();
+  mySnapshotMap.clear();
+  mySnapshotCacheSize = 0;
+
+  mySurface.reset();
+  mySurfaceIsValid = false;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void RomInfoWidget::handleMouseUp(int x, int y, MouseButton b, int clickCount)
 {
@@ -24,7 +24,11 @@ namespace Common {
   struct Size;
 }
 
+#include <list>
+#include <unordered_map>
+
 #include "Widget.hxx"
+#include "RomInfoLoader.hxx"
 #include "bspf.hxx"
 
 class RomInfoWidget : public Widget, public CommandSender
@@ -38,28 +42,93 @@ class RomInfoWidget : public Widget, public CommandSender
     RomInfoWidget(GuiObject *boss, const GUI::Font& font,
                   int x, int y, int w, int h,
                   const Common::Size& imgSize);
-    ~RomInfoWidget() override = default;
+    ~RomInfoWidget() override;
 
-    void setProperties(const FilesystemNode& node, const string& md5);
+    void setProperties(const FilesystemNode& node);
     void clearProperties();
     void reloadProperties(const FilesystemNode& node);
 
+    /**
+      Load the information for ROMs which are likely to be selected next
+      (e.g. the neighbours of the current selection) in the background.
+    */
+    void prefetchProperties(const FSList& nodes);
+
     const string& getUrl() const { return myUrl; }
 
+    void tick() override;
+
   protected:
     void drawWidget(bool hilite) override;
     void handleMouseUp(int x, int y, MouseButton b, int clickCount) override;
 
   private:
+    // The information which can only be determined from the ROM image
+    struct RomData {
+      string md5;
+      string left, right;
+      string bsDetected;
+    };
+
+    // A snapshot surface, or the reason why there is none
+    struct Snapshot {
+      string filename;
+      shared_ptr<FBSurface> surface;
+      string error;
+      size_t size{0};
+    };
+
     void parseProperties(const FilesystemNode& node);
+
+    /**
+      Get the image related data of the given ROM.  If it hasn't been
+      loaded yet, it is requested from the background loader.
+
+      @return  The data, or nullptr if it is not available yet
+    */
+    const RomData* romData(const FilesystemNode& node, bool urgent);
+    void romLoaded(const RomInfoLoader::Result& result);
+
   #ifdef PNG_SUPPORT
-    bool loadPng(const string& filename);
+    /**
+      Get the given snapshot from the cache.  If it isn't cached yet, it is
+      requested from the background loader.
+
+      @return  The snapshot, or nullptr if it is not available yet
+    */
+    const Snapshot* snapshot(const string& filename, bool urgent);
+    void snapshotLoaded(const RomInfoLoader::Result& result);
+    string snapshotName(const Properties& props) const;
   #endif
 
+    void clearCaches();
+
   private:
-    // Surface pointer holding the PNG image
+    // Memory available for caching snapshot surfaces
+    static constexpr size_t SNAPSHOT_CACHE_SIZE = 32 * 1024_KB;
+    // Maximum number of ROMs to keep information about
+    static constexpr size_t ROM_CACHE_SIZE = 500;
+
+    // Loads ROMs and decodes snapshots in the background
+    RomInfoLoader myLoader;
+
+    // The currently selected ROM
+    FilesystemNode myNode;
+
+    // Image related information, by ROM path
+    std::unordered_map<string, RomData> myRomData;
+
+    // Snapshots, most recently used first, and their lookup by filename
+    std::list<Snapshot> mySnapshots;
+    std::unordered_map<string, std::list<Snapshot>::iterator> mySnapshotMap;
+    size_t mySnapshotCacheSize{0};
+
+    // Surface pointer holding the PNG image of the current ROM
     shared_ptr<FBSurface> mySurface;
 
+    // Whether the surface render callback has been registered
+    bool myHaveRenderCallback{false};
+
     // Whether the surface should be redrawn by drawWidget()
     bool mySurfaceIsValid{false};
 
@@ -61,3 +61,9 @@ shared_ptr<CompositeKeyValueRepositoryAtomic> OSystemLIBRETRO::getHighscoreRepos
 {
   return make_shared<CompositeKeyValueRepositoryNoop>();
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<KeyValueRepositoryAtomic> OSystemLIBRETRO::getHashCacheRepository()
+{
+  return make_shared<KeyValueRepositoryNoop>();
+}
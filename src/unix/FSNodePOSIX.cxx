@@ -96,6 +96,19 @@ bool FilesystemNodePOSIX::hasParent() const
   return _path != "" && _path != ROOT_DIR;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNodePOSIX::getFileInfo(uInt64& size, uInt64& modTime) const
+{
+  struct stat st;
+
+  if(stat(_path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+    return false;
+
+  size = uInt64(st.st_size);
+  modTime = uInt64(st.st_mtime);
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool FilesystemNodePOSIX::getChildren(AbstractFSList& myList, ListMode mode) const
 {
@@ -70,6 +70,7 @@ class FilesystemNodePOSIX : public AbstractFSNode
     bool isFile() const override      { return _isFile;      }
     bool isReadable() const override  { return access(_path.c_str(), R_OK) == 0; }
     bool isWritable() const override  { return access(_path.c_str(), W_OK) == 0; }
+    bool getFileInfo(uInt64& size, uInt64& modTime) const override;
     bool makeDir() override;
     bool rename(const string& newfile) override;
 
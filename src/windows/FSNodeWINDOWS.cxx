@@ -57,6 +57,21 @@ bool FilesystemNodeWINDOWS::isWritable() const
   return _access(_path.c_str(), W_OK) == 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNodeWINDOWS::getFileInfo(uInt64& size, uInt64& modTime) const
+{
+  WIN32_FILE_ATTRIBUTE_DATA data;
+
+  if(!GetFileAttributesEx(toUnicode(_path.c_str()), GetFileExInfoStandard, &data) ||
+     (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+    return false;
+
+  size = (uInt64(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+  modTime = (uInt64(data.ftLastWriteTime.dwHighDateTime) << 32) |
+            data.ftLastWriteTime.dwLowDateTime;
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FilesystemNodeWINDOWS::setFlags()
 {